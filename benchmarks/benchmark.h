@@ -0,0 +1,293 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_BENCHMARK_H_INCLUDED
+#define SOCI_BENCHMARK_H_INCLUDED
+
+#include "soci/soci.h"
+
+#ifndef _WIN32
+#include <time.h>
+#else
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace soci
+{
+
+namespace benchmarks
+{
+
+// monotonic clock with nanosecond resolution, where available
+inline long long get_nanoseconds()
+{
+#ifndef _WIN32
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<long long>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#else
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return static_cast<long long>(
+        static_cast<double>(counter.QuadPart) * 1e9 / frequency.QuadPart);
+#endif
+}
+
+// parameters passed to each benchmark function
+struct benchmark_params
+{
+    benchmark_params() : rows(0), size(0) {}
+
+    std::size_t rows; // number of rows in the soci_bench table
+    std::size_t size; // benchmark specific, e.g. the size of the vectors
+};
+
+// runs the measured operation the given number of times
+typedef void (*benchmark_function)(session & sql,
+    benchmark_params const & params, long long iterations);
+
+struct benchmark_case
+{
+    benchmark_case()
+        : function(NULL), size(0), items(1), fetchesRows(false) {}
+
+    benchmark_case(std::string const & name, benchmark_function function,
+        std::size_t size, std::size_t items, bool fetchesRows)
+        : name(name), function(function), size(size), items(items),
+          fetchesRows(fetchesRows) {}
+
+    std::string name;
+    benchmark_function function;
+    std::size_t size;
+
+    // number of rows processed by each iteration, used for computing the
+    // cost per row
+    std::size_t items;
+
+    // the benchmark reads the rows of the table and can't be used with the
+    // backends not returning any, such as the empty one
+    bool fetchesRows;
+};
+
+typedef std::vector<benchmark_case> benchmark_list;
+
+struct benchmark_result
+{
+    benchmark_result() : iterations(0), items(1) {}
+
+    std::string name;
+    long long iterations;      // in each repetition
+    std::size_t items;
+    std::vector<double> times; // nanoseconds per iteration, sorted
+
+    double median() const
+    {
+        std::size_t const n = times.size();
+        return n % 2 ? times[n / 2] : (times[n / 2 - 1] + times[n / 2]) / 2;
+    }
+};
+
+struct benchmark_options
+{
+    benchmark_options()
+        : minTime(200), repetitions(5), rows(1000), json(false), list(false) {}
+
+    std::string connectString;
+    std::string filter; // run only the benchmarks containing this string
+    int minTime;        // of each repetition, in milliseconds
+    int repetitions;
+    std::size_t rows;
+    bool json;
+    bool list;
+};
+
+// Measure the time of a single benchmark: first find the number of
+// iterations taking at least the minimal time, which also serves as warm
+// up, and then run them the given number of times.
+inline benchmark_result run_benchmark(session & sql,
+    benchmark_case const & bc, benchmark_options const & options)
+{
+    benchmark_params params;
+    params.rows = options.rows;
+    params.size = bc.size;
+
+    long long const minTime = static_cast<long long>(options.minTime) * 1000000;
+
+    long long iterations = 1;
+    for (;;)
+    {
+        long long const start = get_nanoseconds();
+        bc.function(sql, params, iterations);
+        long long const elapsed = get_nanoseconds() - start;
+
+        if (elapsed >= minTime || iterations >= 1000000000)
+        {
+            break;
+        }
+
+        // aim slightly above the minimal time, but don't grow too fast if
+        // the first runs were too short to be measured reliably
+        long long next = iterations * 10;
+        if (elapsed > 0)
+        {
+            double const estimate =
+                static_cast<double>(iterations) * minTime * 1.2 / elapsed;
+            if (estimate < next)
+            {
+                next = static_cast<long long>(estimate) + 1;
+            }
+        }
+
+        iterations = next > iterations ? next : iterations + 1;
+    }
+
+    benchmark_result result;
+    result.name = bc.name;
+    result.iterations = iterations;
+    result.items = bc.items;
+
+    for (int i = 0; i < options.repetitions; ++i)
+    {
+        long long const start = get_nanoseconds();
+        bc.function(sql, params, iterations);
+        long long const elapsed = get_nanoseconds() - start;
+
+        result.times.push_back(static_cast<double>(elapsed) / iterations);
+    }
+
+    std::sort(result.times.begin(), result.times.end());
+
+    return result;
+}
+
+inline void write_text(std::ostream & os, std::string const & backend,
+    std::vector<benchmark_result> const & results)
+{
+    os << "backend: " << backend << "\n\n"
+       << std::left << std::setw(36) << "benchmark" << std::right
+       << std::setw(12) << "iterations"
+       << std::setw(14) << "ns/op"
+       << std::setw(14) << "min ns/op"
+       << std::setw(14) << "max ns/op"
+       << std::setw(12) << "ns/row" << '\n';
+
+    os << std::fixed << std::setprecision(1);
+    for (std::size_t i = 0; i != results.size(); ++i)
+    {
+        benchmark_result const & r = results[i];
+        os << std::left << std::setw(36) << r.name << std::right
+           << std::setw(12) << r.iterations
+           << std::setw(14) << r.median()
+           << std::setw(14) << r.times.front()
+           << std::setw(14) << r.times.back()
+           << std::setw(12) << r.median() / r.items << '\n';
+    }
+}
+
+// the names of the benchmarks don't need escaping
+inline void write_json(std::ostream & os, std::string const & backend,
+    benchmark_options const & options,
+    std::vector<benchmark_result> const & results)
+{
+    os << "{\"backend\":\"" << backend << "\""
+       << ",\"rows\":" << options.rows
+       << ",\"min_time_ms\":" << options.minTime
+       << ",\"repetitions\":" << options.repetitions
+       << ",\"benchmarks\":[";
+
+    os << std::fixed << std::setprecision(1);
+    for (std::size_t i = 0; i != results.size(); ++i)
+    {
+        benchmark_result const & r = results[i];
+        if (i != 0)
+        {
+            os << ',';
+        }
+
+        os << "\n{\"name\":\"" << r.name << "\""
+           << ",\"iterations\":" << r.iterations
+           << ",\"items_per_op\":" << r.items
+           << ",\"ns_per_op\":" << r.median()
+           << ",\"min_ns_per_op\":" << r.times.front()
+           << ",\"max_ns_per_op\":" << r.times.back()
+           << ",\"ns_per_item\":" << r.median() / r.items
+           << '}';
+    }
+    os << "\n]}\n";
+}
+
+// Returns false if the program should exit, either because of an error or
+// because the help was requested.
+inline bool parse_options(int argc, char ** argv, benchmark_options & options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        char const * const arg = argv[i];
+        if (std::strcmp(arg, "--json") == 0)
+        {
+            options.json = true;
+        }
+        else if (std::strcmp(arg, "--list") == 0)
+        {
+            options.list = true;
+        }
+        else if (std::strncmp(arg, "--filter=", 9) == 0)
+        {
+            options.filter = arg + 9;
+        }
+        else if (std::strncmp(arg, "--min-time=", 11) == 0)
+        {
+            options.minTime = std::atoi(arg + 11);
+        }
+        else if (std::strncmp(arg, "--repetitions=", 14) == 0)
+        {
+            options.repetitions = std::atoi(arg + 14);
+        }
+        else if (std::strncmp(arg, "--rows=", 7) == 0)
+        {
+            options.rows = static_cast<std::size_t>(std::atoi(arg + 7));
+        }
+        else if (i == 1 && arg[0] != '-')
+        {
+            options.connectString = arg;
+        }
+        else
+        {
+            std::cerr << "usage: " << argv[0]
+                << " [connectstring] [--json] [--list] [--filter=text]"
+                   " [--min-time=ms] [--repetitions=n] [--rows=n]\n";
+            return false;
+        }
+    }
+
+    if (options.minTime < 0 || options.repetitions < 1 || options.rows < 1)
+    {
+        std::cerr << "invalid benchmark options\n";
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace benchmarks
+
+} // namespace soci
+
+#endif // SOCI_BENCHMARK_H_INCLUDED
@@ -0,0 +1,443 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_COMMON_BENCHMARKS_H_INCLUDED
+#define SOCI_COMMON_BENCHMARKS_H_INCLUDED
+
+#include "benchmark.h"
+
+#include <sstream>
+
+namespace soci
+{
+
+namespace benchmarks
+{
+
+// the object mapped to a row of soci_bench table
+struct bench_record
+{
+    bench_record() : id(0), i(0), d(0) {}
+
+    int id;
+    int i;
+    double d;
+    std::string s;
+};
+
+} // namespace benchmarks
+
+template <>
+struct type_conversion<benchmarks::bench_record>
+{
+    typedef values base_type;
+
+    static void from_base(values const & v, indicator /* ind */,
+        benchmarks::bench_record & r)
+    {
+        // use the positions as the case of the column names depends on the
+        // backend
+        r.id = v.get<int>(0);
+        r.i = v.get<int>(1);
+        r.d = v.get<double>(2);
+        r.s = v.get<std::string>(3);
+    }
+
+    static void to_base(benchmarks::bench_record const & r, values & v,
+        indicator & ind)
+    {
+        v.set("id", r.id);
+        v.set("i", r.i);
+        v.set("d", r.d);
+        v.set("s", r.s);
+        ind = i_ok;
+    }
+};
+
+namespace benchmarks
+{
+
+// Each benchmark function below performs the measured operation on the
+// soci_bench(id, i, d, s) table containing params.rows rows with the ids
+// from 0 to params.rows - 1.
+
+void once_into(session & sql, benchmark_params const &, long long iterations)
+{
+    int i = 0;
+    for (long long n = 0; n != iterations; ++n)
+    {
+        sql << "select i from soci_bench where id = 1", into(i);
+    }
+}
+
+void once_into_use(session & sql, benchmark_params const & params,
+    long long iterations)
+{
+    int i = 0;
+    int id = 0;
+    for (long long n = 0; n != iterations; ++n)
+    {
+        id = static_cast<int>(n % params.rows);
+        sql << "select i from soci_bench where id = :id", into(i), use(id);
+    }
+}
+
+void prepared_into_use(session & sql, benchmark_params const & params,
+    long long iterations)
+{
+    int i = 0;
+    int id = 0;
+    statement st = (sql.prepare <<
+        "select i from soci_bench where id = :id", into(i), use(id));
+
+    for (long long n = 0; n != iterations; ++n)
+    {
+        id = static_cast<int>(n % params.rows);
+        st.execute(true);
+    }
+}
+
+void prepared_use(session & sql, benchmark_params const & params,
+    long long iterations)
+{
+    int i = 0;
+    int id = 0;
+    statement st = (sql.prepare <<
+        "update soci_bench set i = :i where id = :id", use(i), use(id));
+
+    for (long long n = 0; n != iterations; ++n)
+    {
+        id = static_cast<int>(n % params.rows);
+        i = static_cast<int>(n);
+        st.execute(true);
+    }
+}
+
+// fetch the whole table using vectors of params.size elements
+void bulk_fetch(session & sql, benchmark_params const & params,
+    long long iterations)
+{
+    std::vector<int> ids;
+    std::vector<double> ds;
+    std::vector<std::string> ss;
+    statement st = (sql.prepare <<
+        "select id, d, s from soci_bench", into(ids), into(ds), into(ss));
+
+    for (long long n = 0; n != iterations; ++n)
+    {
+        // the vectors are shrunk to 0 elements when there is no more data
+        ids.resize(params.size);
+        ds.resize(params.size);
+        ss.resize(params.size);
+
+        st.execute();
+        while (st.fetch())
+        {
+        }
+    }
+}
+
+// insert params.size rows at once, the rows are removed by rolling back the
+// transaction, whose cost is included
+void bulk_insert(session & sql, benchmark_params const & params,
+    long long iterations)
+{
+    std::vector<int> ids(params.size);
+    std::vector<int> is(params.size);
+    std::vector<double> ds(params.size);
+    std::vector<std::string> ss(params.size);
+    for (std::size_t k = 0; k != params.size; ++k)
+    {
+        ids[k] = static_cast<int>(params.rows + k);
+        is[k] = static_cast<int>(k);
+        ds[k] = k / 4.0;
+        ss[k] = "inserted";
+    }
+
+    statement st = (sql.prepare <<
+        "insert into soci_bench(id, i, d, s) values(:id, :i, :d, :s)",
+        use(ids), use(is), use(ds), use(ss));
+
+    for (long long n = 0; n != iterations; ++n)
+    {
+        transaction tr(sql);
+        st.execute(true);
+        tr.rollback();
+    }
+}
+
+// iterate over the whole table with the rowset prefetch size of params.size
+void rowset_row(session & sql, benchmark_params const & params,
+    long long iterations)
+{
+    std::size_t const prefetchSize = sql.get_rowset_prefetch_size();
+    sql.set_rowset_prefetch_size(params.size);
+
+    long long sum = 0;
+    for (long long n = 0; n != iterations; ++n)
+    {
+        rowset<row> rs = (sql.prepare << "select id, i, d, s from soci_bench");
+        for (rowset<row>::const_iterator it = rs.begin(); it != rs.end(); ++it)
+        {
+            row const & r = *it;
+            sum += r.get<int>(0) + r.get<int>(1);
+            sum += static_cast<long long>(r.get<double>(2));
+            sum += static_cast<long long>(r.get<std::string>(3).size());
+        }
+    }
+
+    sql.set_rowset_prefetch_size(prefetchSize);
+
+    if (sum < 0)
+    {
+        std::cerr << "unexpected sum of the values\n";
+    }
+}
+
+void orm_into(session & sql, benchmark_params const & params,
+    long long iterations)
+{
+    bench_record r;
+    int id = 0;
+    statement st = (sql.prepare <<
+        "select id, i, d, s from soci_bench where id = :id", into(r), use(id));
+
+    for (long long n = 0; n != iterations; ++n)
+    {
+        id = static_cast<int>(n % params.rows);
+        st.execute(true);
+    }
+}
+
+void orm_use(session & sql, benchmark_params const & params,
+    long long iterations)
+{
+    bench_record r;
+    r.s = "updated";
+    statement st = (sql.prepare <<
+        "update soci_bench set i = :i, d = :d, s = :s where id = :id", use(r));
+
+    for (long long n = 0; n != iterations; ++n)
+    {
+        r.id = static_cast<int>(n % params.rows);
+        r.i = static_cast<int>(n);
+        r.d = n / 2.0;
+        st.execute(true);
+    }
+}
+
+void values_into_row(session & sql, benchmark_params const & params,
+    long long iterations)
+{
+    row r;
+    int id = 0;
+    statement st = (sql.prepare <<
+        "select id, i, d, s from soci_bench where id = :id", into(r), use(id));
+
+    for (long long n = 0; n != iterations; ++n)
+    {
+        id = static_cast<int>(n % params.rows);
+        st.execute(true);
+    }
+}
+
+void values_use(session & sql, benchmark_params const & params,
+    long long iterations)
+{
+    values v;
+    v.set("id", 0);
+    v.set("i", 0);
+    statement st = (sql.prepare <<
+        "update soci_bench set i = :i where id = :id", use(v));
+
+    for (long long n = 0; n != iterations; ++n)
+    {
+        v.set("id", static_cast<int>(n % params.rows));
+        v.set("i", static_cast<int>(n));
+        st.execute(true);
+    }
+}
+
+// Base class for the benchmarks of each backend, which can override the
+// creation of the tables and add their own benchmarks.
+class benchmark_context
+{
+public:
+    // the connect string can be empty if there is no sensible default
+    benchmark_context(backend_factory const & backEnd,
+        std::string const & backendName,
+        std::string const & defaultConnectString)
+        : backEnd_(backEnd), backendName_(backendName),
+          defaultConnectString_(defaultConnectString) {}
+
+    virtual ~benchmark_context() {}
+
+    // the backends not returning any rows only run the benchmarks not
+    // fetching them
+    virtual bool returns_rows() const { return true; }
+
+    virtual void create_tables(session & sql, std::size_t rows) const
+    {
+        drop_table(sql, "soci_bench");
+        sql << "create table soci_bench(id integer primary key, i integer,"
+               " d float, s varchar(20))";
+
+        std::vector<int> ids(rows);
+        std::vector<int> is(rows);
+        std::vector<double> ds(rows);
+        std::vector<std::string> ss(rows);
+        for (std::size_t k = 0; k != rows; ++k)
+        {
+            std::ostringstream os;
+            os << "row " << k;
+
+            ids[k] = static_cast<int>(k);
+            is[k] = static_cast<int>(k * 7 % 1000);
+            ds[k] = k / 3.0;
+            ss[k] = os.str();
+        }
+
+        transaction tr(sql);
+        sql << "insert into soci_bench(id, i, d, s) values(:id, :i, :d, :s)",
+            use(ids), use(is), use(ds), use(ss);
+        tr.commit();
+    }
+
+    virtual void drop_tables(session & sql) const
+    {
+        drop_table(sql, "soci_bench");
+    }
+
+    // the backend-specific benchmarks
+    virtual void add_benchmarks(benchmark_list & /* list */,
+        std::size_t /* rows */) const {}
+
+    int run(int argc, char ** argv) const
+    {
+        benchmark_options options;
+        options.connectString = defaultConnectString_;
+        if (parse_options(argc, argv, options) == false)
+        {
+            return EXIT_FAILURE;
+        }
+
+        if (options.connectString.empty() && options.list == false)
+        {
+            std::cerr << "usage: " << argv[0]
+                << " connectstring [options...]\n";
+            return EXIT_FAILURE;
+        }
+
+        benchmark_list list;
+        add_common_benchmarks(list, options.rows);
+        add_benchmarks(list, options.rows);
+
+        benchmark_list selected;
+        for (std::size_t i = 0; i != list.size(); ++i)
+        {
+            benchmark_case const & bc = list[i];
+            if ((bc.fetchesRows && returns_rows() == false) ||
+                bc.name.find(options.filter) == std::string::npos)
+            {
+                continue;
+            }
+
+            selected.push_back(bc);
+        }
+
+        if (options.list)
+        {
+            for (std::size_t i = 0; i != selected.size(); ++i)
+            {
+                std::cout << selected[i].name << '\n';
+            }
+            return EXIT_SUCCESS;
+        }
+
+        try
+        {
+            session sql(backEnd_, options.connectString);
+
+            create_tables(sql, options.rows);
+
+            std::vector<benchmark_result> results;
+            for (std::size_t i = 0; i != selected.size(); ++i)
+            {
+                results.push_back(run_benchmark(sql, selected[i], options));
+            }
+
+            drop_tables(sql);
+
+            if (options.json)
+            {
+                write_json(std::cout, backendName_, options, results);
+            }
+            else
+            {
+                write_text(std::cout, backendName_, results);
+            }
+        }
+        catch (std::exception const & e)
+        {
+            std::cerr << e.what() << '\n';
+            return EXIT_FAILURE;
+        }
+
+        return EXIT_SUCCESS;
+    }
+
+protected:
+    static void drop_table(session & sql, std::string const & name)
+    {
+        try
+        {
+            sql << "drop table " << name;
+        }
+        catch (soci_error const &)
+        {
+            // the table didn't exist
+        }
+    }
+
+private:
+    static void add_common_benchmarks(benchmark_list & list, std::size_t rows)
+    {
+        list.push_back(benchmark_case("once/into", once_into, 0, 1, false));
+        list.push_back(benchmark_case("once/into-use", once_into_use, 0, 1, false));
+        list.push_back(benchmark_case("prepared/into-use", prepared_into_use, 0, 1, false));
+        list.push_back(benchmark_case("prepared/use", prepared_use, 0, 1, false));
+
+        std::size_t const sizes[] = { 1, 10, 100, 1000 };
+        for (std::size_t k = 0; k != sizeof(sizes) / sizeof(sizes[0]); ++k)
+        {
+            std::ostringstream os;
+            os << sizes[k];
+
+            list.push_back(benchmark_case("bulk/fetch-" + os.str(),
+                bulk_fetch, sizes[k], rows, true));
+            list.push_back(benchmark_case("bulk/insert-" + os.str(),
+                bulk_insert, sizes[k], sizes[k], false));
+        }
+
+        list.push_back(benchmark_case("rowset/row", rowset_row, 1, rows, true));
+        list.push_back(benchmark_case("rowset/row-prefetch-100", rowset_row, 100, rows, true));
+        list.push_back(benchmark_case("orm/into", orm_into, 0, 1, true));
+        list.push_back(benchmark_case("orm/use", orm_use, 0, 1, false));
+        list.push_back(benchmark_case("values/into-row", values_into_row, 0, 1, true));
+        list.push_back(benchmark_case("values/use", values_use, 0, 1, false));
+    }
+
+    backend_factory const & backEnd_;
+    std::string const backendName_;
+    std::string const defaultConnectString_;
+};
+
+} // namespace benchmarks
+
+} // namespace soci
+
+#endif // SOCI_COMMON_BENCHMARKS_H_INCLUDED
@@ -0,0 +1,33 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "soci/soci.h"
+#include "soci/empty/soci-empty.h"
+#include "common-benchmarks.h"
+
+using namespace soci;
+using namespace soci::benchmarks;
+
+// The empty backend doesn't do anything, so these benchmarks measure the
+// overhead of the core library itself.
+class benchmark_context_empty : public benchmark_context
+{
+public:
+    benchmark_context_empty()
+        : benchmark_context(*factory_empty(), "empty", "dummy") {}
+
+    // the backend always reports success when fetching, so the benchmarks
+    // reading all rows would never end
+    virtual bool returns_rows() const { return false; }
+};
+
+int main(int argc, char ** argv)
+{
+    benchmark_context_empty context;
+
+    return context.run(argc, argv);
+}
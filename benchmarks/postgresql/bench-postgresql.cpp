@@ -0,0 +1,146 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "soci/soci.h"
+#include "soci/postgresql/soci-postgresql.h"
+#include "common-benchmarks.h"
+#include <ctime>
+
+using namespace soci;
+using namespace soci::benchmarks;
+
+namespace // anonymous
+{
+
+// fetch all rows of soci_bench_types, whose columns are all converted from
+// text when the results are in text format, using vectors of params.size
+// elements
+void fetch_types(session & sql, benchmark_params const & params,
+    long long iterations, bool binary)
+{
+    std::vector<int> ids;
+    std::vector<long long> bigs;
+    std::vector<double> ds;
+    std::vector<double> ns;
+    std::vector<std::tm> ts;
+    std::vector<std::string> ss;
+    statement st = (sql.prepare <<
+        "select id, big, d, n, t, s from soci_bench_types",
+        into(ids), into(bigs), into(ds), into(ns), into(ts), into(ss));
+    postgresql_set_binary_results(st, binary);
+
+    for (long long n = 0; n != iterations; ++n)
+    {
+        ids.resize(params.size);
+        bigs.resize(params.size);
+        ds.resize(params.size);
+        ns.resize(params.size);
+        ts.resize(params.size);
+        ss.resize(params.size);
+
+        st.execute();
+        while (st.fetch())
+        {
+        }
+    }
+}
+
+void fetch_text(session & sql, benchmark_params const & params,
+    long long iterations)
+{
+    fetch_types(sql, params, iterations, false);
+}
+
+void fetch_binary(session & sql, benchmark_params const & params,
+    long long iterations)
+{
+    fetch_types(sql, params, iterations, true);
+}
+
+// select a single row of soci_bench_types by its id
+void into_types(session & sql, benchmark_params const & params,
+    long long iterations, bool binary)
+{
+    int id = 0;
+    long long big = 0;
+    double d = 0;
+    double num = 0;
+    std::tm t = std::tm();
+    std::string s;
+    statement st = (sql.prepare <<
+        "select big, d, n, t, s from soci_bench_types where id = :id",
+        into(big), into(d), into(num), into(t), into(s), use(id));
+    postgresql_set_binary_results(st, binary);
+
+    for (long long n = 0; n != iterations; ++n)
+    {
+        id = static_cast<int>(n % params.rows);
+        st.execute(true);
+    }
+}
+
+void into_text(session & sql, benchmark_params const & params,
+    long long iterations)
+{
+    into_types(sql, params, iterations, false);
+}
+
+void into_binary(session & sql, benchmark_params const & params,
+    long long iterations)
+{
+    into_types(sql, params, iterations, true);
+}
+
+} // namespace anonymous
+
+// Compares the text and binary formats of the results in addition to the
+// common benchmarks.
+class benchmark_context_postgresql : public benchmark_context
+{
+public:
+    benchmark_context_postgresql()
+        : benchmark_context(*factory_postgresql(), "postgresql", "") {}
+
+    virtual void create_tables(session & sql, std::size_t rows) const
+    {
+        benchmark_context::create_tables(sql, rows);
+
+        drop_table(sql, "soci_bench_types");
+        sql << "create table soci_bench_types(id integer primary key,"
+               " big bigint, d float8, n numeric(20, 6), t timestamp, s text)";
+
+        sql << "insert into soci_bench_types"
+               " select g, g * 1000003, g / 7.0, g / 3.0,"
+               " timestamp '2020-01-01' + g * interval '1 minute',"
+               " 'row ' || g"
+               " from generate_series(0, " << rows - 1 << ") as g";
+    }
+
+    virtual void drop_tables(session & sql) const
+    {
+        drop_table(sql, "soci_bench_types");
+        benchmark_context::drop_tables(sql);
+    }
+
+    virtual void add_benchmarks(benchmark_list & list, std::size_t rows) const
+    {
+        list.push_back(benchmark_case("postgresql/into-text", into_text, 0, 1, true));
+        list.push_back(benchmark_case("postgresql/into-binary", into_binary, 0, 1, true));
+
+        list.push_back(benchmark_case("postgresql/fetch-text-100", fetch_text, 100, rows, true));
+        list.push_back(benchmark_case("postgresql/fetch-binary-100", fetch_binary, 100, rows, true));
+        list.push_back(benchmark_case("postgresql/fetch-text-1000", fetch_text, 1000, rows, true));
+        list.push_back(benchmark_case("postgresql/fetch-binary-1000", fetch_binary, 1000, rows, true));
+    }
+};
+
+int main(int argc, char ** argv)
+{
+    benchmark_context_postgresql context;
+
+    return context.run(argc, argv);
+}
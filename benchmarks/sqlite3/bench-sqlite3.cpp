@@ -0,0 +1,22 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "soci/soci.h"
+#include "soci/sqlite3/soci-sqlite3.h"
+#include "common-benchmarks.h"
+
+using namespace soci;
+using namespace soci::benchmarks;
+
+int main(int argc, char ** argv)
+{
+    // use an in-memory database by default to measure the library overhead
+    // rather than the disk access
+    benchmark_context context(*factory_sqlite3(), "sqlite3", ":memory:");
+
+    return context.run(argc, argv);
+}
@@ -0,0 +1,737 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Multi-threaded TPC-B-like workload executed using a connection pool.
+
+#include "soci/soci.h"
+#include "benchmark.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#else
+#include <process.h>
+#endif
+
+#include <cmath>
+#include <exception>
+
+using namespace soci;
+using namespace soci::benchmarks;
+
+namespace // anonymous
+{
+
+enum operation_type
+{
+    op_tpcb, // the TPC-B transaction updating the balances
+    op_read, // reading the balance of an account
+    op_count
+};
+
+char const * const operation_names[op_count] = { "tpcb", "read" };
+
+// the number of rows per branch, as in TPC-B
+int const tellers_per_branch = 10;
+int const accounts_per_branch = 100000;
+
+enum key_distribution
+{
+    kd_uniform,
+    kd_zipf
+};
+
+struct workload_options
+{
+    workload_options()
+        : connectString("sqlite3://db=soci_workload.db timeout=10"),
+          threads(4), poolSize(0), duration(10), scale(1), reads(50),
+          distribution(kd_uniform), zipfTheta(0.99), init(true), json(false) {}
+
+    std::string connectString; // including the backend name
+    int threads;
+    int poolSize; // the number of threads if 0
+    int duration; // in seconds
+    int scale;    // the number of branches
+    int reads;    // percentage of op_read operations
+    key_distribution distribution;
+    double zipfTheta;
+    bool init;
+    bool json;
+};
+
+// xorshift128 generator: it is fast and good enough for choosing the keys
+// and, unlike std::rand(), each thread can have its own one
+class random_generator
+{
+public:
+    explicit random_generator(unsigned seed)
+        : x_(123456789 ^ seed), y_(362436069), z_(521288629), w_(88675123)
+    {
+        // mix the seed into the whole state
+        for (int i = 0; i != 16; ++i)
+        {
+            next();
+        }
+    }
+
+    unsigned next()
+    {
+        unsigned const t = x_ ^ (x_ << 11);
+        x_ = y_;
+        y_ = z_;
+        z_ = w_;
+        w_ = w_ ^ (w_ >> 19) ^ (t ^ (t >> 8));
+        return w_;
+    }
+
+    // uniformly distributed in [0, 1)
+    double next_double()
+    {
+        return next() / 4294967296.0;
+    }
+
+    // uniformly distributed in [0, n)
+    int next_below(int n)
+    {
+        return static_cast<int>(next_double() * n);
+    }
+
+private:
+    unsigned x_;
+    unsigned y_;
+    unsigned z_;
+    unsigned w_;
+};
+
+// Chooses the keys in [0, n) range, either uniformly or following Zipf
+// distribution, in which case the key 0 is the most frequently used one.
+//
+// The Zipf keys are generated using the algorithm from "Quickly Generating
+// Billion-Record Synthetic Databases" by J. Gray et al.
+class key_generator
+{
+public:
+    key_generator(int n, key_distribution distribution, double theta)
+        : n_(n), distribution_(distribution), theta_(theta),
+          alpha_(0), zetan_(0), eta_(0)
+    {
+        if (distribution_ == kd_zipf)
+        {
+            for (int i = 1; i <= n_; ++i)
+            {
+                zetan_ += 1 / std::pow(static_cast<double>(i), theta_);
+            }
+
+            double const zeta2 = 1 + 1 / std::pow(2.0, theta_);
+
+            alpha_ = 1 / (1 - theta_);
+            eta_ = (1 - std::pow(2.0 / n_, 1 - theta_)) / (1 - zeta2 / zetan_);
+        }
+    }
+
+    int next(random_generator & rng) const
+    {
+        if (distribution_ == kd_uniform)
+        {
+            return rng.next_below(n_);
+        }
+
+        double const u = rng.next_double();
+        double const uz = u * zetan_;
+        if (uz < 1)
+        {
+            return 0;
+        }
+
+        if (uz < 1 + std::pow(0.5, theta_))
+        {
+            return 1;
+        }
+
+        int const key =
+            static_cast<int>(n_ * std::pow(eta_ * u - eta_ + 1, alpha_));
+        return key < n_ ? key : n_ - 1;
+    }
+
+private:
+    int const n_;
+    key_distribution const distribution_;
+    double const theta_;
+    double alpha_;
+    double zetan_;
+    double eta_;
+};
+
+struct operation_stats
+{
+    operation_stats() : errors(0) {}
+
+    std::vector<long long> latencies; // of the successful operations, in us
+    unsigned long long errors;
+    std::string firstError;
+};
+
+// the state of a single thread executing the workload
+struct worker
+{
+    worker()
+        : pool(NULL), accounts(NULL), seed(0), reads(0), tellers(0),
+          deadline(0) {}
+
+    connection_pool * pool;
+    key_generator const * accounts;
+    unsigned seed;
+    int reads;
+    int tellers;
+    long long deadline;
+
+    operation_stats stats[op_count];
+
+    // the error which stopped the thread, normally empty
+    std::string failure;
+};
+
+void run_tpcb(session & sql, random_generator & rng, worker const & w)
+{
+    int aid = w.accounts->next(rng);
+    int tid = rng.next_below(w.tellers);
+    int bid = tid / tellers_per_branch;
+    int delta = rng.next_below(10001) - 5000;
+    int balance = 0;
+
+    transaction tr(sql);
+
+    sql << "update workload_accounts set abalance = abalance + :delta"
+           " where aid = :aid", use(delta), use(aid);
+    sql << "select abalance from workload_accounts where aid = :aid",
+        into(balance), use(aid);
+    sql << "update workload_tellers set tbalance = tbalance + :delta"
+           " where tid = :tid", use(delta), use(tid);
+    sql << "update workload_branches set bbalance = bbalance + :delta"
+           " where bid = :bid", use(delta), use(bid);
+    sql << "insert into workload_history(tid, bid, aid, delta)"
+           " values(:tid, :bid, :aid, :delta)",
+        use(tid), use(bid), use(aid), use(delta);
+
+    tr.commit();
+}
+
+void run_read(session & sql, random_generator & rng, worker const & w)
+{
+    int aid = w.accounts->next(rng);
+    int balance = 0;
+
+    sql << "select abalance from workload_accounts where aid = :aid",
+        into(balance), use(aid);
+}
+
+void run_worker(worker & w)
+{
+    random_generator rng(w.seed);
+
+    while (get_nanoseconds() < w.deadline)
+    {
+        operation_type const op =
+            rng.next_below(100) < w.reads ? op_read : op_tpcb;
+        operation_stats & stats = w.stats[op];
+
+        // the time includes waiting for a session from the pool
+        long long const start = get_nanoseconds();
+        try
+        {
+            session sql(*w.pool);
+
+            if (op == op_tpcb)
+            {
+                run_tpcb(sql, rng, w);
+            }
+            else
+            {
+                run_read(sql, rng, w);
+            }
+        }
+        catch (soci_error const & e)
+        {
+            // e.g. a deadlock or a serialization failure, just go on
+            if (stats.errors++ == 0)
+            {
+                stats.firstError = e.what();
+            }
+            continue;
+        }
+
+        stats.latencies.push_back((get_nanoseconds() - start) / 1000);
+    }
+}
+
+} // namespace anonymous
+
+#ifndef _WIN32
+extern "C" void * workload_thread(void * arg)
+#else
+unsigned __stdcall workload_thread(void * arg)
+#endif
+{
+    worker & w = *static_cast<worker *>(arg);
+    try
+    {
+        run_worker(w);
+    }
+    catch (std::exception const & e)
+    {
+        w.failure = e.what();
+    }
+    catch (...)
+    {
+        w.failure = "unknown exception";
+    }
+
+    return 0;
+}
+
+namespace // anonymous
+{
+
+void run_workers(std::vector<worker> & workers)
+{
+#ifndef _WIN32
+    std::vector<pthread_t> threads(workers.size());
+    for (std::size_t i = 0; i != workers.size(); ++i)
+    {
+        if (pthread_create(&threads[i], NULL, workload_thread, &workers[i]) != 0)
+        {
+            throw soci_error("Cannot create the workload thread.");
+        }
+    }
+
+    for (std::size_t i = 0; i != threads.size(); ++i)
+    {
+        pthread_join(threads[i], NULL);
+    }
+#else
+    std::vector<HANDLE> threads(workers.size());
+    for (std::size_t i = 0; i != workers.size(); ++i)
+    {
+        threads[i] = reinterpret_cast<HANDLE>(_beginthreadex(NULL, 0,
+            workload_thread, &workers[i], 0, NULL));
+        if (threads[i] == NULL)
+        {
+            throw soci_error("Cannot create the workload thread.");
+        }
+    }
+
+    for (std::size_t i = 0; i != threads.size(); ++i)
+    {
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+    }
+#endif
+}
+
+void drop_table(session & sql, std::string const & name)
+{
+    try
+    {
+        sql << "drop table " << name;
+    }
+    catch (soci_error const &)
+    {
+        // the table didn't exist
+    }
+}
+
+// insert the rows with the ids from 0 to count - 1, in batches
+void fill_table(session & sql, std::string const & table,
+    std::string const & columns, int count, int perBranch)
+{
+    int const batch = 10000;
+
+    std::vector<int> ids;
+    std::vector<int> bids;
+    std::vector<int> balances;
+    statement st = (sql.prepare << "insert into " << table
+        << "(" << columns << ") values(:id, :bid, :balance)",
+        use(ids), use(bids), use(balances));
+
+    transaction tr(sql);
+    for (int first = 0; first < count; first += batch)
+    {
+        int const last = first + batch < count ? first + batch : count;
+
+        ids.clear();
+        bids.clear();
+        balances.assign(last - first, 0);
+        for (int id = first; id != last; ++id)
+        {
+            ids.push_back(id);
+            bids.push_back(id / perBranch);
+        }
+
+        st.execute(true);
+    }
+    tr.commit();
+}
+
+void create_tables(session & sql, int scale)
+{
+    drop_table(sql, "workload_history");
+    drop_table(sql, "workload_accounts");
+    drop_table(sql, "workload_tellers");
+    drop_table(sql, "workload_branches");
+
+    sql << "create table workload_branches(bid integer primary key,"
+           " bbalance integer)";
+    sql << "create table workload_tellers(tid integer primary key,"
+           " bid integer, tbalance integer)";
+    sql << "create table workload_accounts(aid integer primary key,"
+           " bid integer, abalance integer)";
+    sql << "create table workload_history(tid integer, bid integer,"
+           " aid integer, delta integer)";
+
+    {
+        transaction tr(sql);
+        for (int bid = 0; bid != scale; ++bid)
+        {
+            sql << "insert into workload_branches(bid, bbalance)"
+                   " values(:bid, 0)", use(bid);
+        }
+        tr.commit();
+    }
+
+    fill_table(sql, "workload_tellers", "tid, bid, tbalance",
+        scale * tellers_per_branch, tellers_per_branch);
+    fill_table(sql, "workload_accounts", "aid, bid, abalance",
+        scale * accounts_per_branch, accounts_per_branch);
+}
+
+bool parse_options(int argc, char ** argv, workload_options & options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        char const * const arg = argv[i];
+        if (std::strcmp(arg, "--json") == 0)
+        {
+            options.json = true;
+        }
+        else if (std::strcmp(arg, "--no-init") == 0)
+        {
+            options.init = false;
+        }
+        else if (std::strncmp(arg, "--threads=", 10) == 0)
+        {
+            options.threads = std::atoi(arg + 10);
+        }
+        else if (std::strncmp(arg, "--pool-size=", 12) == 0)
+        {
+            options.poolSize = std::atoi(arg + 12);
+        }
+        else if (std::strncmp(arg, "--duration=", 11) == 0)
+        {
+            options.duration = std::atoi(arg + 11);
+        }
+        else if (std::strncmp(arg, "--scale=", 8) == 0)
+        {
+            options.scale = std::atoi(arg + 8);
+        }
+        else if (std::strncmp(arg, "--reads=", 8) == 0)
+        {
+            options.reads = std::atoi(arg + 8);
+        }
+        else if (std::strcmp(arg, "--distribution=uniform") == 0)
+        {
+            options.distribution = kd_uniform;
+        }
+        else if (std::strcmp(arg, "--distribution=zipf") == 0)
+        {
+            options.distribution = kd_zipf;
+        }
+        else if (std::strncmp(arg, "--zipf-theta=", 13) == 0)
+        {
+            options.zipfTheta = std::atof(arg + 13);
+        }
+        else if (i == 1 && arg[0] != '-')
+        {
+            options.connectString = arg;
+        }
+        else
+        {
+            std::cerr << "usage: " << argv[0]
+                << " [backend://connectstring] [--threads=n] [--pool-size=n]"
+                   " [--duration=seconds] [--scale=n] [--reads=percent]"
+                   " [--distribution=uniform|zipf] [--zipf-theta=x]"
+                   " [--no-init] [--json]\n";
+            return false;
+        }
+    }
+
+    if (options.poolSize == 0)
+    {
+        options.poolSize = options.threads;
+    }
+
+    if (options.threads < 1 || options.poolSize < 1 || options.duration < 1 ||
+        options.scale < 1 || options.reads < 0 || options.reads > 100 ||
+        options.zipfTheta <= 0 || options.zipfTheta >= 1)
+    {
+        std::cerr << "invalid workload options\n";
+        return false;
+    }
+
+    return true;
+}
+
+long long percentile(std::vector<long long> const & sorted, double fraction)
+{
+    if (sorted.empty())
+    {
+        return 0;
+    }
+
+    std::size_t rank = static_cast<std::size_t>(
+        std::ceil(fraction * sorted.size()));
+    if (rank == 0)
+    {
+        rank = 1;
+    }
+
+    return sorted[rank - 1];
+}
+
+long long mean(std::vector<long long> const & values)
+{
+    if (values.empty())
+    {
+        return 0;
+    }
+
+    long long total = 0;
+    for (std::size_t i = 0; i != values.size(); ++i)
+    {
+        total += values[i];
+    }
+
+    return total / static_cast<long long>(values.size());
+}
+
+void write_text(std::ostream & os, std::string const & backend,
+    workload_options const & options, double elapsed,
+    operation_stats const (& stats)[op_count],
+    connection_pool_stats const & poolStats)
+{
+    os << "backend: " << backend
+       << ", threads: " << options.threads
+       << ", pool size: " << options.poolSize
+       << ", scale: " << options.scale
+       << ", reads: " << options.reads << "%"
+       << ", distribution: "
+       << (options.distribution == kd_zipf ? "zipf" : "uniform") << '\n'
+       << "duration: " << std::fixed << std::setprecision(1) << elapsed
+       << " s\n\n";
+
+    os << std::left << std::setw(10) << "operation" << std::right
+       << std::setw(10) << "count"
+       << std::setw(8) << "errors"
+       << std::setw(10) << "ops/s"
+       << std::setw(10) << "mean us"
+       << std::setw(10) << "p50 us"
+       << std::setw(10) << "p90 us"
+       << std::setw(10) << "p99 us"
+       << std::setw(10) << "p99.9 us"
+       << std::setw(10) << "max us" << '\n';
+
+    std::size_t total = 0;
+    for (int op = 0; op != op_count; ++op)
+    {
+        std::vector<long long> const & l = stats[op].latencies;
+        total += l.size();
+
+        os << std::left << std::setw(10) << operation_names[op] << std::right
+           << std::setw(10) << l.size()
+           << std::setw(8) << stats[op].errors
+           << std::setw(10) << l.size() / elapsed
+           << std::setw(10) << mean(l)
+           << std::setw(10) << percentile(l, 0.5)
+           << std::setw(10) << percentile(l, 0.9)
+           << std::setw(10) << percentile(l, 0.99)
+           << std::setw(10) << percentile(l, 0.999)
+           << std::setw(10) << (l.empty() ? 0 : l.back()) << '\n';
+    }
+
+    os << std::left << std::setw(10) << "total" << std::right
+       << std::setw(10) << total
+       << std::setw(8) << ""
+       << std::setw(10) << total / elapsed << "\n\n";
+
+    os << "pool: leases: " << poolStats.leases
+       << ", waits: " << poolStats.waits
+       << ", lease wait mean us: " << poolStats.lease_wait.mean()
+       << ", p99 us: " << poolStats.lease_wait.percentile(0.99)
+       << ", max us: " << poolStats.lease_wait.longest << '\n';
+
+    for (int op = 0; op != op_count; ++op)
+    {
+        if (stats[op].errors != 0)
+        {
+            os << "first " << operation_names[op] << " error: "
+               << stats[op].firstError << '\n';
+        }
+    }
+}
+
+void write_json(std::ostream & os, std::string const & backend,
+    workload_options const & options, double elapsed,
+    operation_stats const (& stats)[op_count],
+    connection_pool_stats const & poolStats)
+{
+    os << std::fixed << std::setprecision(1)
+       << "{\"backend\":\"" << backend << "\""
+       << ",\"threads\":" << options.threads
+       << ",\"pool_size\":" << options.poolSize
+       << ",\"scale\":" << options.scale
+       << ",\"reads_percent\":" << options.reads
+       << ",\"distribution\":\""
+       << (options.distribution == kd_zipf ? "zipf" : "uniform") << "\""
+       << ",\"duration_s\":" << elapsed
+       << ",\"operations\":[";
+
+    std::size_t total = 0;
+    for (int op = 0; op != op_count; ++op)
+    {
+        std::vector<long long> const & l = stats[op].latencies;
+        total += l.size();
+
+        if (op != 0)
+        {
+            os << ',';
+        }
+
+        os << "\n{\"name\":\"" << operation_names[op] << "\""
+           << ",\"count\":" << l.size()
+           << ",\"errors\":" << stats[op].errors
+           << ",\"ops_per_s\":" << l.size() / elapsed
+           << ",\"mean_us\":" << mean(l)
+           << ",\"p50_us\":" << percentile(l, 0.5)
+           << ",\"p90_us\":" << percentile(l, 0.9)
+           << ",\"p99_us\":" << percentile(l, 0.99)
+           << ",\"p999_us\":" << percentile(l, 0.999)
+           << ",\"max_us\":" << (l.empty() ? 0 : l.back())
+           << '}';
+    }
+
+    os << "\n],\"total_ops_per_s\":" << total / elapsed
+       << ",\"pool\":{\"leases\":" << poolStats.leases
+       << ",\"waits\":" << poolStats.waits
+       << ",\"lease_wait_mean_us\":" << poolStats.lease_wait.mean()
+       << ",\"lease_wait_p99_us\":" << poolStats.lease_wait.percentile(0.99)
+       << ",\"lease_wait_max_us\":" << poolStats.lease_wait.longest
+       << "}}\n";
+}
+
+} // namespace anonymous
+
+int main(int argc, char ** argv)
+{
+    workload_options options;
+    if (parse_options(argc, argv, options) == false)
+    {
+        return EXIT_FAILURE;
+    }
+
+    try
+    {
+        std::size_t const poolSize = static_cast<std::size_t>(options.poolSize);
+        connection_pool pool(connection_parameters(options.connectString),
+            poolSize, poolSize);
+
+        std::string backend;
+        {
+            session sql(pool);
+            backend = sql.get_backend_name();
+
+            if (options.init)
+            {
+                create_tables(sql, options.scale);
+            }
+            else
+            {
+                sql << "select count(*) from workload_branches",
+                    into(options.scale);
+            }
+        }
+
+        key_generator const accounts(options.scale * accounts_per_branch,
+            options.distribution, options.zipfTheta);
+
+        pool.reset_stats();
+
+        long long const start = get_nanoseconds();
+
+        std::vector<worker> workers(options.threads);
+        for (std::size_t i = 0; i != workers.size(); ++i)
+        {
+            worker & w = workers[i];
+            w.pool = &pool;
+            w.accounts = &accounts;
+            w.seed = static_cast<unsigned>(i + 1);
+            w.reads = options.reads;
+            w.tellers = options.scale * tellers_per_branch;
+            w.deadline = start +
+                static_cast<long long>(options.duration) * 1000000000;
+        }
+
+        run_workers(workers);
+
+        double const elapsed = (get_nanoseconds() - start) / 1e9;
+
+        operation_stats stats[op_count];
+        for (std::size_t i = 0; i != workers.size(); ++i)
+        {
+            worker const & w = workers[i];
+            if (w.failure.empty() == false)
+            {
+                throw soci_error("Workload thread failed: " + w.failure);
+            }
+
+            for (int op = 0; op != op_count; ++op)
+            {
+                operation_stats const & ws = w.stats[op];
+                operation_stats & s = stats[op];
+
+                s.latencies.insert(s.latencies.end(),
+                    ws.latencies.begin(), ws.latencies.end());
+                if (s.errors == 0)
+                {
+                    s.firstError = ws.firstError;
+                }
+                s.errors += ws.errors;
+            }
+        }
+
+        for (int op = 0; op != op_count; ++op)
+        {
+            std::sort(stats[op].latencies.begin(), stats[op].latencies.end());
+        }
+
+        if (options.json)
+        {
+            write_json(std::cout, backend, options, elapsed, stats,
+                pool.get_stats());
+        }
+        else
+        {
+            write_text(std::cout, backend, options, elapsed, stats,
+                pool.get_stats());
+        }
+    }
+    catch (std::exception const & e)
+    {
+        std::cerr << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
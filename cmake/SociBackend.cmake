@@ -354,3 +354,64 @@ macro(soci_backend_test)
 
   endif()
 endmacro()
+
+# Defines benchmark project of a database backend for SOCI library
+#
+# soci_backend_benchmark(BACKEND mybackend SOURCE mybench.cpp
+#   CONNSTR "my benchmark connection"
+#   DEPENDS library1 library2)
+#
+macro(soci_backend_benchmark)
+  parse_arguments(THIS_BENCHMARK
+    "BACKEND;SOURCE;CONNSTR;DEPENDS;"
+    ""
+    ${ARGN})
+
+  string(TOUPPER "${THIS_BENCHMARK_BACKEND}" BACKENDU)
+  string(TOLOWER "${THIS_BENCHMARK_BACKEND}" BACKENDL)
+
+  if(SOCI_BENCHMARKS AND SOCI_${BACKENDU})
+
+    set(BENCHMARK_TARGET soci_${BACKENDL}_benchmark)
+    set(NAMEU SOCI_${BACKENDU}_BENCHMARK)
+
+    soci_backend_deps_found(${NAMEU} "${THIS_BENCHMARK_DEPENDS}" ${NAMEU}_DEPS_FOUND)
+    if(${NAMEU}_DEPS_FOUND)
+      get_directory_property(THIS_INCLUDE_DIRS INCLUDE_DIRECTORIES)
+      get_directory_property(THIS_COMPILE_DEFS COMPILE_DEFINITIONS)
+
+      list(APPEND THIS_INCLUDE_DIRS ${${NAMEU}_DEPS_INCLUDE_DIRS})
+      list(APPEND THIS_COMPILE_DEFS ${${NAMEU}_DEPS_DEFS})
+
+      set_directory_properties(PROPERTIES
+        INCLUDE_DIRECTORIES "${THIS_INCLUDE_DIRS}"
+        COMPILE_DEFINITIONS "${THIS_COMPILE_DEFS}")
+    else()
+       colormsg(_RED_ "WARNING:")
+       colormsg(RED "Some dependencies of ${THIS_BENCHMARK_BACKEND} benchmark not found")
+    endif()
+
+    add_executable(${BENCHMARK_TARGET} ${THIS_BENCHMARK_SOURCE})
+
+    target_link_libraries(${BENCHMARK_TARGET}
+      ${SOCI_CORE_DEPS_LIBS}
+      ${${NAMEU}_DEPS_LIBRARIES}
+      soci_core
+      soci_${BACKENDL})
+
+    add_dependencies(benchmarks ${BENCHMARK_TARGET})
+
+    # Run the benchmark very briefly with the tests to check that it works,
+    # the real measurements should be done by running it directly.
+    if(THIS_BENCHMARK_CONNSTR)
+      add_test(${BENCHMARK_TARGET}
+        ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/${BENCHMARK_TARGET}
+        ${THIS_BENCHMARK_CONNSTR}
+        --min-time=0 --repetitions=1 --rows=10)
+    endif()
+
+    source_group("Source Files" FILES ${THIS_BENCHMARK_SOURCE})
+    source_group("CMake Files" FILES CMakeLists.txt)
+
+  endif()
+endmacro()
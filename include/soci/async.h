@@ -0,0 +1,116 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_ASYNC_H_INCLUDED
+#define SOCI_ASYNC_H_INCLUDED
+
+#include "soci/soci-config.h"
+#include "soci/soci-backend.h"
+
+namespace soci
+{
+
+class session;
+
+namespace details
+{
+
+// Operation executed asynchronously by the session.
+class async_task
+{
+public:
+    virtual ~async_task() {}
+
+    // Start executing the operation without blocking and return true or
+    // return false if it can't be done, in which case run() is called by the
+    // background thread of the session instead. If the operation is started,
+    // status is set to step_done if it has already completed or to the event
+    // of the session socket to wait for before calling step(), which
+    // continues it in the same way, and result() is called at the end.
+    virtual bool start(step_status & /* status */) { return false; }
+    virtual step_status step() { return step_done; }
+    virtual bool result() { return false; }
+
+    // execute the operation and return its result, this is only called if
+    // start() returned false
+    virtual bool run() = 0;
+};
+
+// The state of an asynchronous operation shared by the session executing it
+// and the async_result objects referring to it.
+class async_state;
+
+// The executor of the asynchronous operations of a single session, which
+// executes them one after another, in the order of their submission. The
+// operations which can be executed without blocking are advanced whenever
+// their results are checked or waited for, the other ones are executed by
+// a background thread created when it's needed for the first time.
+class SOCI_DECL async_worker
+{
+public:
+    explicit async_worker(session & s);
+
+    // waits until all the pending operations complete
+    ~async_worker();
+
+    // takes ownership of the task
+    async_state * submit(async_task * task);
+
+    // wait until all the operations submitted so far complete
+    void wait_all();
+
+    // implementation details, the worker is not copyable
+    struct async_worker_impl;
+
+private:
+    async_worker_impl * pimpl_;
+
+    async_worker(async_worker const &);
+    async_worker & operator=(async_worker const &);
+};
+
+} // namespace details
+
+// Handle of an operation started by one of the *_async() functions, which
+// can be used to wait for its completion and to retrieve its result.
+//
+// The handle can be freely copied, all copies refer to the same operation.
+// Destroying the handle doesn't cancel the operation.
+class SOCI_DECL async_result
+{
+public:
+    async_result();
+    explicit async_result(details::async_state * state);
+    async_result(async_result const & other);
+    async_result & operator=(async_result const & other);
+    ~async_result();
+
+    // false for default constructed objects not associated with any operation
+    bool valid() const { return state_ != 0; }
+
+    // true if the operation has completed, successfully or not
+    bool is_ready() const;
+
+    // wait for the operation to complete during at most the given number of
+    // milliseconds or indefinitely if it is negative, return true if it has
+    // completed
+    bool wait(int timeout = -1) const;
+
+    // wait for the operation to complete and return its result, i.e. the
+    // value which would have been returned by the synchronous version of
+    // the function, or throw the error which happened while executing it
+    // (errors not deriving from soci_error are reported as soci_error with
+    // the same message)
+    bool get() const;
+
+private:
+    details::async_state * state_;
+};
+
+} // namespace soci
+
+#endif // SOCI_ASYNC_H_INCLUDED
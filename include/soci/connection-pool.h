@@ -9,18 +9,60 @@
 #define SOCI_CONNECTION_POOL_H_INCLUDED
 
 #include "soci/soci-config.h"
+#include "soci/connection-parameters.h"
+#include "soci/duration-histogram.h"
 // std
 #include <cstddef>
+#include <string>
 
 namespace soci
 {
 
 class session;
+class slow_query_sink;
+
+// snapshot of the activity of the connection pool, all durations are in
+// microseconds
+struct SOCI_DECL connection_pool_stats
+{
+    connection_pool_stats()
+        : leases(0), timeouts(0), waits(0), opens(0), open_failures(0),
+          reconnects(0), reconnect_failures(0), idle_closes(0),
+          waiters(0), max_waiters(0), in_use(0), idle(0), broken(0) {}
+
+    unsigned long long leases;   // entries successfully leased
+    unsigned long long timeouts; // try_lease() calls which failed
+    unsigned long long waits;    // leases which had to wait for a free entry
+    unsigned long long opens;    // sessions opened by the elastic pool
+    unsigned long long open_failures;
+    unsigned long long reconnects; // broken sessions reconnected
+    unsigned long long reconnect_failures;
+    unsigned long long idle_closes; // sessions closed after idle timeout
+
+    std::size_t waiters;     // threads currently waiting for a free entry
+    std::size_t max_waiters; // most threads waiting at the same time
+    std::size_t in_use;      // entries currently leased
+    std::size_t idle;        // free entries
+    std::size_t broken;      // sessions waiting to be reconnected
+
+    duration_histogram lease_wait; // until an entry was available
+    duration_histogram lease_hold; // from leasing the entry to giving it back
+    duration_histogram open_time;
+    duration_histogram reconnect_time;
+};
 
 class SOCI_DECL connection_pool
 {
 public:
     explicit connection_pool(std::size_t size);
+
+    // Create an elastic pool, which opens its sessions itself using the given
+    // parameters: the first minSize of them are opened, in parallel, right
+    // now and the others only when they are leased while all the already
+    // opened ones are in use, up to maxSize sessions in total.
+    connection_pool(connection_parameters const & parameters,
+        std::size_t minSize, std::size_t maxSize);
+
     ~connection_pool();
 
     session & at(std::size_t pos);
@@ -29,9 +71,65 @@ public:
     bool try_lease(std::size_t & pos, int timeout);
     void give_back(std::size_t pos);
 
-private:
+    // If enabled, lease() prefers to return the entry last leased by the
+    // calling thread, if it's free, allowing the thread to reuse the
+    // statements prepared by the session. By default the most recently
+    // given back entry is returned.
+    void set_thread_affinity(bool enable);
+    bool get_thread_affinity() const;
+
+    // For elastic pools only: close the sessions, other than the first
+    // minSize ones, which remained unused for longer than the given number
+    // of milliseconds. This is done by a background thread created when the
+    // timeout is set for the first time. The default value of 0 means that
+    // the sessions are never closed.
+    void set_idle_timeout(int timeout);
+    int get_idle_timeout() const;
+
+    // Health checks of the sessions: the validation query is executed to
+    // check whether the session is still usable or, if it's empty (default),
+    // session::is_connected() is used. Sessions found to be broken are
+    // reconnected by a background thread and can't be leased until then.
+
+    // If enabled, check the session before returning it from lease(), unless
+    // it was checked very recently, and lease another one if it's broken.
+    void set_validate_on_lease(bool enable);
+    bool get_validate_on_lease() const;
+
+    // Check the free sessions unused for the given number of milliseconds in
+    // the background, the default value of 0 disables this.
+    void set_validation_interval(int interval);
+    int get_validation_interval() const;
+
+    void set_validation_query(std::string const & query);
+    std::string get_validation_query() const;
+
+    // Set the slow query log of all sessions of the pool, see
+    // session::set_slow_query_log(). The settings are applied to each
+    // session when it's leased, so the sessions leased right now keep their
+    // current ones until they are given back. As the sink is used by all of
+    // them, it must be thread-safe.
+    void set_slow_query_log(slow_query_sink * sink, int threshold,
+        std::size_t maxValueLength = 100);
+
+    // Number of sessions currently open (or being opened), both free and in
+    // use, for elastic pools. For the other ones this is just the pool size.
+    std::size_t get_open_count() const;
+
+    // Counters and durations collected since the pool creation or the last
+    // call to reset_stats(), which doesn't affect the current state values
+    // (waiters, in_use, idle and broken).
+    connection_pool_stats get_stats() const;
+    void reset_stats();
+
+    // implementation details, the pool is not copyable
     struct connection_pool_impl;
+
+private:
     connection_pool_impl * pimpl_;
+
+    connection_pool(connection_pool const &);
+    connection_pool & operator=(connection_pool const &);
 };
 
 }
@@ -55,6 +55,9 @@ public:
     db2_soci_error(std::string const & msg, SQLRETURN rc) : soci_error(msg),errorCode(rc) {};
     ~db2_soci_error() throw() { };
 
+    virtual soci_error * clone() const { return new db2_soci_error(*this); }
+    virtual void rethrow() const { throw *this; }
+
     //We have to extract error information before exception throwing, cause CLI handles could be broken at the construction time
     static const std::string sqlState(std::string const & msg,const SQLSMALLINT htype,const SQLHANDLE hndl);
 
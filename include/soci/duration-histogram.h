@@ -0,0 +1,46 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_DURATION_HISTOGRAM_H_INCLUDED
+#define SOCI_DURATION_HISTOGRAM_H_INCLUDED
+
+#include "soci/soci-config.h"
+
+namespace soci
+{
+
+// Distribution of the durations of some operation, in microseconds.
+//
+// The durations are counted in buckets whose bounds are powers of 2: the
+// bucket 0 counts the durations less than 1us and the bucket i > 0 those in
+// [2^(i-1), 2^i) range, except for the last one which counts all the longer
+// durations too.
+struct SOCI_DECL duration_histogram
+{
+    enum { bucket_count = 32 };
+
+    duration_histogram();
+
+    void add(unsigned long long duration);
+
+    // return the (approximate) duration not exceeded by the given fraction,
+    // between 0 and 1, of all durations, i.e. percentile(0.99) is the 99th
+    // percentile, or 0 if there are no durations at all
+    unsigned long long percentile(double fraction) const;
+
+    // average duration or 0 if there are no durations
+    unsigned long long mean() const;
+
+    unsigned long long count; // number of durations
+    unsigned long long total; // sum of all durations
+    unsigned long long longest; // maximal duration
+    unsigned long long buckets[bucket_count];
+};
+
+} // namespace soci
+
+#endif // SOCI_DURATION_HISTOGRAM_H_INCLUDED
@@ -20,6 +20,13 @@ class SOCI_DECL soci_error : public std::runtime_error
 {
 public:
     explicit soci_error(std::string const & msg);
+
+    // Create a copy of this error and throw this error, preserving its
+    // dynamic type, which allows to report the errors happening in the
+    // asynchronous operations to the code waiting for them. The classes
+    // deriving from this one must override both of these functions.
+    virtual soci_error * clone() const;
+    virtual void rethrow() const;
 };
 
 } // namespace soci
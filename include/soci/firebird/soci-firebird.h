@@ -51,6 +51,13 @@ public:
 
     ~firebird_soci_error() throw() {};
 
+    virtual soci_error * clone() const
+    {
+        return new firebird_soci_error(*this);
+    }
+
+    virtual void rethrow() const { throw *this; }
+
     std::vector<ISC_STATUS> status_;
 };
 
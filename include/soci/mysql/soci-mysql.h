@@ -29,18 +29,50 @@
 #include <winsock.h> // SOCKET
 #endif // _WIN32
 #include <mysql.h> // MySQL Client
+#include <map>
 #include <vector>
 
 
 namespace soci
 {
 
+namespace details
+{
+
+namespace mysql
+{
+
+// MySQL 8.0 client library replaced my_bool with bool in MYSQL_BIND.
+#if MYSQL_VERSION_ID >= 80001 && !defined(LIBMARIADB) && \
+    !defined(MARIADB_BASE_VERSION)
+typedef bool bool_type;
+#else
+typedef my_bool bool_type;
+#endif
+
+} // namespace mysql
+
+} // namespace details
+
+// Result column state used when fetching rows of a server-side prepared
+// statement, there is one of them for each row fetched at once.
+struct mysql_column_state
+{
+    details::mysql::bool_type isNull_;
+    details::mysql::bool_type error_;
+    unsigned long length_;
+    MYSQL_TIME time_;
+};
+
 class mysql_soci_error : public soci_error
 {
 public:
     mysql_soci_error(std::string const & msg, int errNum)
         : soci_error(msg), err_num_(errNum) {}
 
+    virtual soci_error * clone() const { return new mysql_soci_error(*this); }
+    virtual void rethrow() const { throw *this; }
+
     unsigned int err_num_;
 };
 
@@ -59,11 +91,16 @@ struct mysql_standard_into_type_backend : details::standard_into_type_backend
 
     virtual void clean_up();
 
+    // used with server-side prepared statements only
+    void bind_result(MYSQL_BIND &bind);
+    void fetch_result();
+
     mysql_statement_backend &statement_;
 
     void *data_;
     details::exchange_type type_;
     int position_;
+    mysql_column_state state_;
 };
 
 struct mysql_vector_into_type_backend : details::vector_into_type_backend
@@ -82,11 +119,16 @@ struct mysql_vector_into_type_backend : details::vector_into_type_backend
 
     virtual void clean_up();
 
+    // used with server-side prepared statements only
+    void bind_result(MYSQL_BIND &bind, int row);
+    void fetch_result(int row);
+
     mysql_statement_backend &statement_;
 
     void *data_;
     details::exchange_type type_;
     int position_;
+    std::vector<mysql_column_state> states_;
 };
 
 struct mysql_standard_use_type_backend : details::standard_use_type_backend
@@ -111,6 +153,10 @@ struct mysql_standard_use_type_backend : details::standard_use_type_backend
     int position_;
     std::string name_;
     char *buf_;
+
+    // parameter buffer used with server-side prepared statements
+    MYSQL_BIND bind_;
+    MYSQL_TIME time_;
 };
 
 struct mysql_vector_use_type_backend : details::vector_use_type_backend
@@ -136,6 +182,10 @@ struct mysql_vector_use_type_backend : details::vector_use_type_backend
     int position_;
     std::string name_;
     std::vector<char *> buffers_;
+
+    // parameter buffers used with server-side prepared statements
+    std::vector<MYSQL_BIND> binds_;
+    std::vector<MYSQL_TIME> times_;
 };
 
 struct mysql_session_backend;
@@ -151,6 +201,8 @@ struct mysql_statement_backend : details::statement_backend
     virtual exec_fetch_result execute(int number);
     virtual exec_fetch_result fetch(int number);
 
+    virtual void reset();
+
     virtual long long get_affected_rows();
     virtual int get_number_of_rows();
 
@@ -169,6 +221,12 @@ struct mysql_statement_backend : details::statement_backend
 
     MYSQL_RES *result_;
 
+    // Server-side prepared statement, NULL unless prepared statements are
+    // enabled for the session, the statement is not a one-time query and
+    // the server supports them for this query.
+    MYSQL_STMT *stmt_;
+    MYSQL_RES *metadata_; // result set metadata of stmt_, for describe
+
     // The query is split into chunks, separated by the named parameters;
     // e.g. for "SELECT id FROM ttt WHERE name = :foo AND gender = :bar"
     // we will have query chunks "SELECT id FROM ttt WHERE name = ",
@@ -176,6 +234,12 @@ struct mysql_statement_backend : details::statement_backend
     std::vector<std::string> queryChunks_;
     std::vector<std::string> names_; // list of names for named binds
 
+    // For the simple "INSERT ... VALUES (...)" statements, whose bulk
+    // execution can be done using multi-row inserts, the length of the part
+    // of the query before the values tuple and after it, otherwise 0.
+    std::size_t bulkInsertPrefix_;
+    std::size_t bulkInsertSuffix_;
+
     long long rowsAffectedBulk_; // number of rows affected by the last bulk operation
 
     int numberOfRows_;  // number of rows retrieved from the server
@@ -185,6 +249,23 @@ struct mysql_statement_backend : details::statement_backend
     bool justDescribed_; // to optimize row description with immediately
                          // following actual statement execution
 
+    // Use mysql_use_result() to read the rows from the server only when they
+    // are fetched instead of retrieving all of them when executing the query.
+    bool streamResults_;
+    bool streaming_; // the current result is being streamed
+    bool streamEnd_; // all the rows of the streamed result were read
+
+    // The values of the rows of the current fetch when streaming: the
+    // offsets in streamData_, or npos for NULLs, and lengths of the values
+    // of each row are stored consecutively.
+    std::vector<char> streamData_;
+    std::vector<std::size_t> streamOffsets_;
+    std::vector<unsigned long> streamLengths_;
+
+    // Returns the value of the given column (0-based) of the given row of
+    // the result or NULL if it is null.
+    char const * get_value(int row, int pos, unsigned long &length);
+
     // Prefetch the row offsets in order to use mysql_row_seek() for
     // random access to rows, since mysql_data_seek() is expensive.
     std::vector<MYSQL_ROW_OFFSET> resultRowOffsets_;
@@ -202,6 +283,36 @@ struct mysql_statement_backend : details::statement_backend
 
     typedef std::map<std::string, char **> UseByNameBuffersMap;
     UseByNameBuffersMap useByNameBuffers_;
+
+    // the same for the parameter buffers of the prepared statement
+
+    typedef std::map<int, MYSQL_BIND *> UseByPosBindsMap;
+    UseByPosBindsMap useByPosBinds_;
+
+    typedef std::map<std::string, MYSQL_BIND *> UseByNameBindsMap;
+    UseByNameBindsMap useByNameBinds_;
+
+    // called by the use elements when their parameter buffers are no longer
+    // valid
+    void remove_use_bind(int position, std::string const &name,
+        MYSQL_BIND *bind);
+
+    // into elements filled by fetching the rows of the prepared statement
+    std::vector<mysql_standard_into_type_backend *> intos_;
+    std::vector<mysql_vector_into_type_backend *> vectorIntos_;
+
+private:
+    void find_values_tuple();
+    void execute_bulk_query(std::string const &query,
+        long long &rowsAffectedBulkTemp);
+    void prepare_statement();
+    void close_prepared();
+    exec_fetch_result fetch_streamed(int number);
+    exec_fetch_result execute_prepared(int number);
+    exec_fetch_result fetch_prepared(int number);
+
+    std::vector<MYSQL_BIND> params_;
+    std::vector<MYSQL_BIND> results_;
 };
 
 struct mysql_rowid_backend : details::rowid_backend
@@ -242,6 +353,9 @@ struct mysql_session_backend : details::session_backend
 
     virtual std::string get_backend_name() const { return "mysql"; }
 
+    virtual int get_socket();
+    virtual bool is_connected();
+
     void clean_up();
 
     virtual mysql_statement_backend * make_statement_backend();
@@ -249,6 +363,21 @@ struct mysql_session_backend : details::session_backend
     virtual mysql_blob_backend * make_blob_backend();
 
     MYSQL *conn_;
+
+    // returns the value of max_allowed_packet server variable
+    std::size_t get_max_allowed_packet();
+
+    // use server-side prepared statements instead of sending the queries
+    // with the parameter values substituted into them
+    bool preparedStatements_;
+
+    // default value of streamResults_ for the statements of this session
+    bool streamResults_;
+
+    // combine bulk inserts into multi-row inserts
+    bool multiRowInserts_;
+
+    std::size_t maxAllowedPacket_; // 0 until retrieved from the server
 };
 
 
@@ -390,6 +390,9 @@ public:
     {
         return reinterpret_cast<SQLCHAR const *>(message_);
     }
+
+    virtual soci_error * clone() const { return new odbc_soci_error(*this); }
+    virtual void rethrow() const { throw *this; }
 };
 
 inline bool is_odbc_error(SQLRETURN rc)
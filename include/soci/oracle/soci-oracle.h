@@ -40,6 +40,9 @@ class SOCI_ORACLE_DECL oracle_soci_error : public soci_error
 public:
     oracle_soci_error(std::string const & msg, int errNum = 0);
 
+    virtual soci_error * clone() const { return new oracle_soci_error(*this); }
+    virtual void rethrow() const { throw *this; }
+
     int err_num_;
 };
 
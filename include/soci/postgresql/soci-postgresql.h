@@ -42,10 +42,44 @@ public:
 
     std::string sqlstate() const;
 
+    virtual soci_error * clone() const
+    {
+        return new postgresql_soci_error(*this);
+    }
+
+    virtual void rethrow() const { throw *this; }
+
 private:
     char sqlstate_[ 5 ];   // not std::string to keep copy-constructor no-throw
 };
 
+// Option allowing to request the query results in binary format instead of
+// the default text one for all the statements of the session. Its value must
+// be either "1" to enable binary results or "0" to disable them (default).
+extern SOCI_POSTGRESQL_DECL char const * postgresql_option_binary_results;
+
+// Option allowing to receive the rows of the query results from the server
+// one by one, as they are fetched, instead of retrieving the entire result
+// when the statement is executed. Its value must be either "1" or "0".
+extern SOCI_POSTGRESQL_DECL char const * postgresql_option_stream_results;
+
+// Option allowing to use COPY FROM STDIN for the bulk inserts, i.e. simple
+// INSERT statements with vector use elements. Its value must be "1" or "0".
+extern SOCI_POSTGRESQL_DECL char const * postgresql_option_copy_bulk_inserts;
+
+// Option allowing to send all the rows of the bulk operations to the server
+// at once in pipeline mode (requires libpq 14 or later) instead of waiting
+// for each of them to be executed. Its value must be "1" or "0".
+extern SOCI_POSTGRESQL_DECL char const * postgresql_option_pipeline_bulk_operations;
+
+class statement;
+
+// Enable or disable binary results (see postgresql_option_binary_results) for
+// a single statement of a PostgreSQL session, this must be done before
+// executing it. Throws if the statement doesn't use the PostgreSQL backend.
+SOCI_POSTGRESQL_DECL void postgresql_set_binary_results(statement & st,
+    bool binary);
+
 namespace details
 {
 
@@ -91,6 +125,15 @@ public:
     // provide.
     operator const PGresult*() const { return result_; }
 
+    // Give up the ownership of the associated result and return it, the
+    // caller becomes responsible for calling PQclear() on it.
+    PGresult* release()
+    {
+      PGresult* const result = result_;
+      result_ = NULL;
+      return result;
+    }
+
     // Get the associated result (which may be NULL). Unlike the implicit
     // conversion above, this one returns a non-const pointer, so you should be
     // careful to avoid really modifying it.
@@ -229,6 +272,14 @@ struct postgresql_statement_backend : details::statement_backend
     virtual exec_fetch_result execute(int number);
     virtual exec_fetch_result fetch(int number);
 
+    virtual bool start_execute(int number);
+    virtual step_status step_execute();
+    virtual exec_fetch_result finish_execute(int number);
+    virtual bool can_start_execute();
+    virtual bool can_fetch_without_blocking();
+
+    virtual void reset();
+
     virtual long long get_affected_rows();
     virtual int get_number_of_rows();
 
@@ -260,6 +311,44 @@ struct postgresql_statement_backend : details::statement_backend
     bool justDescribed_; // to optimize row description with immediately
                          // following actual statement execution
 
+    // if true, the results are requested in binary format, avoiding
+    // formatting and parsing them as text, this is initialized from the
+    // session option and may be changed by postgresql_set_binary_results()
+    bool binaryResults_;
+
+    // format in which the results are actually requested when binaryResults_
+    // is true: 1 (binary) if all the result columns can be decoded from it,
+    // 0 (text) otherwise or -1 if this hasn't been determined yet
+    int binaryResultFormat_;
+
+    // if true, the rows are received from the server in single row mode and
+    // only as many of them as needed for the next fetch are kept in result_,
+    // this is initialized from the session option and may be changed before
+    // executing the statement
+    bool streamResults_;
+
+    // true while there are more rows to receive in single row mode
+    bool streaming_;
+
+    // true while the statement is executed without blocking, the connection
+    // is in non-blocking mode during this time, and sending_ is true until
+    // the query is completely sent
+    bool nonBlocking_;
+    bool sending_;
+
+    // if true, and the statement is a simple INSERT (i.e. copyQuery_ is not
+    // empty), bulk operations send all the rows at once using COPY instead of
+    // executing the statement for each of them, this is initialized from the
+    // session option and may be changed before executing the statement
+    bool copyBulkInserts_;
+    std::string copyQuery_;
+
+    // if true, bulk operations not using COPY send the statements for all
+    // the rows in pipeline mode before receiving their results, this is
+    // initialized from the session option and may be changed before
+    // executing the statement
+    bool pipelineBulkOperations_;
+
     bool hasIntoElements_;
     bool hasVectorIntoElements_;
     bool hasUseElements_;
@@ -273,6 +362,39 @@ struct postgresql_statement_backend : details::statement_backend
 
     typedef std::map<std::string, char **> UseByNameBuffersMap;
     UseByNameBuffersMap useByNameBuffers_;
+
+private:
+    void get_param_values(int row, std::vector<char *> & paramValues);
+
+    // process result_ after executing the query
+    exec_fetch_result process_result(int number);
+
+    // true if the results may be requested in binary format, which needs
+    // describing the statement if binaryResultFormat_ is still unknown
+    bool result_format_needed() const;
+
+    // get the format to request the results in: 0 for text or 1 for binary
+    int get_result_format();
+
+    // send the query with the given parameters without waiting for results
+    void send_statement(int nParams, char const * const * paramValues,
+        int resultFormat);
+
+    // true if start_execute() executes the statement synchronously
+    bool requires_synchronous_execution() const;
+
+    // switch back to blocking mode after executing without blocking
+    void finish_nonblocking();
+
+    // helpers for bulk operations using COPY or pipeline mode
+    void copy_rows(int numberOfRows);
+    void pipeline_rows(int numberOfRows, int resultFormat);
+
+    // helpers for streaming results
+    void send_query(int nParams, char const * const * paramValues,
+        int resultFormat);
+    void receive_rows(int number);
+    void finish_streaming();
 };
 
 struct postgresql_rowid_backend : details::rowid_backend
@@ -321,6 +443,9 @@ struct postgresql_session_backend : details::session_backend
 
     virtual std::string get_backend_name() const { return "postgresql"; }
 
+    virtual int get_socket();
+    virtual bool is_connected();
+
     void clean_up();
 
     virtual postgresql_statement_backend * make_statement_backend();
@@ -331,6 +456,17 @@ struct postgresql_session_backend : details::session_backend
 
     int statementCount_;
     PGconn * conn_;
+
+    // default binaryResults_, streamResults_, copyBulkInserts_ and
+    // pipelineBulkOperations_ values for the statements of this session
+    bool binaryResults_;
+    bool streamResults_;
+    bool copyBulkInserts_;
+    bool pipelineBulkOperations_;
+
+    // whether timestamps are sent as integers (the default) or as floats in
+    // binary format, as given by integer_datetimes server parameter
+    bool integerDatetimes_;
 };
 
 
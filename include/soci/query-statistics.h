@@ -0,0 +1,76 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_QUERY_STATISTICS_H_INCLUDED
+#define SOCI_QUERY_STATISTICS_H_INCLUDED
+
+#include "soci/soci-config.h"
+#include "soci/duration-histogram.h"
+// std
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace soci
+{
+
+// aggregated statistics of all executions of the same (normalized) query,
+// the times are in microseconds
+struct SOCI_DECL query_stats
+{
+    query_stats() : calls(0), errors(0), rows(0), shortest(0) {}
+
+    std::string query;
+
+    unsigned long long calls;  // number of executions
+    unsigned long long errors; // executions failed with an exception
+    unsigned long long rows;   // rows fetched or affected
+
+    // time of each execution, including fetching its rows and preparing
+    // the statement if it's executed for the first time
+    duration_histogram time;
+    unsigned long long shortest;
+};
+
+// Process-wide registry of the statistics of the queries executed by all
+// sessions, aggregated per query text with the literals replaced by '?'.
+namespace query_statistics
+{
+
+// Collecting the statistics is disabled by default. It should be enabled or
+// disabled only when the sessions are not used by the other threads, e.g.
+// when the application starts.
+SOCI_DECL void enable(bool enable);
+SOCI_DECL bool is_enabled();
+
+// At most this number (1000 by default) of different queries is tracked,
+// all the other ones are counted together under the "<other>" query.
+SOCI_DECL void set_max_queries(std::size_t count);
+SOCI_DECL std::size_t get_max_queries();
+
+// Return the statistics of all queries, the ones which took the most time
+// in total first.
+SOCI_DECL std::vector<query_stats> get();
+SOCI_DECL void reset();
+
+SOCI_DECL void dump_text(std::ostream & os);
+SOCI_DECL void dump_json(std::ostream & os);
+
+// Replace the string and numeric literals in the query with '?' and all
+// consecutive white space with a single space, keeping the placeholders.
+SOCI_DECL std::string normalize(std::string const & query);
+
+// used internally by statement: account for a single execution
+SOCI_DECL void add(std::string const & normalizedQuery,
+    long long time, long long rows, bool failed);
+
+} // namespace query_statistics
+
+} // namespace soci
+
+#endif // SOCI_QUERY_STATISTICS_H_INCLUDED
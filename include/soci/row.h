@@ -14,7 +14,7 @@
 // std
 #include <cassert>
 #include <cstddef>
-#include <map>
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -27,7 +27,7 @@ class SOCI_DECL column_properties
     // of the getters lazy in the future
 public:
 
-    std::string get_name() const { return name_; }
+    std::string const& get_name() const { return name_; }
     data_type get_data_type() const { return dataType_; }
 
     void set_name(std::string const& name) { name_ = name; }
@@ -49,29 +49,59 @@ public:
     std::size_t size() const;
     void clean_up();
 
+    // Allocate the storage for the values of all the columns added with
+    // add_properties() in a single block, this is called by the statement
+    // once the row is described.
+    void alloc_holders();
+
+    // Direct access to the value and indicator of the given column, used by
+    // the statement for fetching the data into the row.
+    template <typename T>
+    T& holder_value(std::size_t pos)
+    {
+        return *static_cast<T*>(
+            get_holder_data(pos, details::holder_traits<T>::type));
+    }
+
+    indicator& holder_indicator(std::size_t pos)
+    {
+        assert(holders_.size() >= pos + 1);
+        return holders_[pos].ind_;
+    }
+
     indicator get_indicator(std::size_t pos) const;
     indicator get_indicator(std::string const& name) const;
 
-    template <typename T>
-    inline void add_holder(T* t, indicator* ind)
+    template <std::size_t N>
+    indicator get_indicator(char const (&name)[N]) const
     {
-        holders_.push_back(new details::type_holder<T>(t));
-        indicators_.push_back(ind);
+        return get_indicator(find_column(name, std::strlen(name)));
     }
 
     column_properties const& get_properties(std::size_t pos) const;
     column_properties const& get_properties(std::string const& name) const;
 
+    // Return the position of the column with the given name or throw if
+    // there is no such column. The position remains valid for all the rows
+    // fetched by the same statement, so it can be looked up once and then
+    // used with the functions taking the column position instead of the
+    // name to avoid the name lookup for each row.
+    std::size_t find_column(std::string const& name) const
+    {
+        return find_column(name.c_str(), name.size());
+    }
+
     template <typename T>
     T get(std::size_t pos) const
     {
         assert(holders_.size() >= pos + 1);
 
         typedef typename type_conversion<T>::base_type base_type;
-        base_type const& baseVal = holders_[pos]->get<base_type>();
+        base_type const& baseVal = *static_cast<base_type const*>(
+            get_holder_data(pos, details::holder_traits<base_type>::type));
 
         T ret;
-        type_conversion<T>::from_base(baseVal, *indicators_[pos], ret);
+        type_conversion<T>::from_base(baseVal, holders_[pos].ind_, ret);
         return ret;
     }
 
@@ -80,7 +110,7 @@ public:
     {
         assert(holders_.size() >= pos + 1);
 
-        if (i_null == *indicators_[pos])
+        if (i_null == holders_[pos].ind_)
         {
             return nullValue;
         }
@@ -98,14 +128,21 @@ public:
     template <typename T>
     T get(std::string const &name, T const &nullValue) const
     {
-        std::size_t const pos = find_column(name);
+        return get<T>(find_column(name), nullValue);
+    }
 
-        if (i_null == *indicators_[pos])
-        {
-            return nullValue;
-        }
+    // overloads for the names given as string literals, which avoid creating
+    // a temporary std::string for every lookup
+    template <typename T, std::size_t N>
+    T get(char const (&name)[N]) const
+    {
+        return get<T>(find_column(name, std::strlen(name)));
+    }
 
-        return get<T>(pos);
+    template <typename T, std::size_t N>
+    T get(char const (&name)[N], T const &nullValue) const
+    {
+        return get<T>(find_column(name, std::strlen(name)), nullValue);
     }
 
     template <typename T>
@@ -131,12 +168,23 @@ private:
     row(row const &);
     void operator=(row const &);
 
-    std::size_t find_column(std::string const& name) const;
+    std::size_t find_column(char const* name, std::size_t len) const;
+
+    // return the pointer to the value of the given column after checking
+    // that it is of the given type, throws std::bad_cast otherwise
+    void* get_holder_data(std::size_t pos, int type);
+    void const* get_holder_data(std::size_t pos, int type) const;
 
     std::vector<column_properties> columns_;
-    std::vector<details::holder*> holders_;
-    std::vector<indicator*> indicators_;
-    std::map<std::string, std::size_t> index_;
+    std::vector<details::holder> holders_;
+
+    // hash table of the column names using open addressing, each slot
+    // contains either the position of the column plus one or 0 if unused
+    std::vector<std::size_t> index_;
+
+    // the values of all columns, at the offsets given by their holders
+    char* data_;
+    std::size_t dataSize_;
 
     bool uppercaseColumnNames_;
     mutable std::size_t currentPos_;
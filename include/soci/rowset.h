@@ -116,13 +116,21 @@ public:
 
     typedef rowset_iterator<T> iterator;
 
-    rowset_impl(details::prepare_temp_type const & prep)
+    rowset_impl(details::prepare_temp_type const & prep,
+        std::size_t prefetchSize)
         : refs_(1), st_(new statement(prep)), define_(new T())
     {
         assert(0 != st_.get());
         assert(0 != define_.get());
 
         st_->exchange_for_rowset(into(*define_));
+
+        // override the session default if explicitly specified
+        if (prefetchSize != 0)
+        {
+            st_->set_row_prefetch_size(prefetchSize);
+        }
+
         st_->execute();
     }
 
@@ -182,7 +190,16 @@ public:
 
     // this is a conversion constructor
     rowset(details::prepare_temp_type const& prep)
-        : pimpl_(new details::rowset_impl<T>(prep))
+        : pimpl_(new details::rowset_impl<T>(prep, 0))
+    {
+        assert(0 != pimpl_);
+    }
+
+    // fetch the given number of rows at once instead of using the session
+    // rowset prefetch size, this only matters for dynamic rows (and user
+    // types converted from values)
+    rowset(details::prepare_temp_type const& prep, std::size_t prefetchSize)
+        : pimpl_(new details::rowset_impl<T>(prep, prefetchSize))
     {
         assert(0 != pimpl_);
     }
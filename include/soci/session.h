@@ -8,9 +8,13 @@
 #ifndef SOCI_SESSION_H_INCLUDED
 #define SOCI_SESSION_H_INCLUDED
 
+#include "soci/async.h"
 #include "soci/once-temp-type.h"
 #include "soci/query_transformation.h"
 #include "soci/connection-parameters.h"
+#include "soci/statement-cache.h"
+#include "soci/statement-observer.h"
+#include "soci/slow-query-log.h"
 
 // std
 #include <cstddef>
@@ -97,6 +101,77 @@ public:
 
     bool get_uppercase_column_names() const;
 
+    // Number of rows fetched at once by rowset<> iterating over dynamic rows
+    // (including user types converted from values), the rows are then
+    // returned one by one from the internal buffer. The default value of 1
+    // fetches each row separately.
+    void set_rowset_prefetch_size(std::size_t size);
+    std::size_t get_rowset_prefetch_size() const;
+
+    // Functions for caching the statements of "once" queries (sql << ...).
+
+    // Keep at most the given number of prepared statements for reuse by
+    // the queries with identical text, the least recently used statements
+    // are dropped first. The default value of 0 disables the cache.
+    void set_statement_cache_size(std::size_t size);
+    std::size_t get_statement_cache_size() const;
+
+    statement_cache_stats get_statement_cache_stats() const;
+    void reset_statement_cache_stats();
+
+    // Drop all cached statements, this must be done if the database schema
+    // changes in a way affecting the already prepared statements.
+    void clear_statement_cache();
+
+    // Functions for observing the statements executed by the session.
+
+    // Report the prepare, execute, fetch and clean up phases of all
+    // statements to the given observer, which is not owned by the session,
+    // or stop doing it if it's NULL. The events are buffered and passed to
+    // the observer in batches of at most bufferSize of them.
+    void set_statement_observer(statement_observer * observer,
+        std::size_t bufferSize = 64);
+    statement_observer * get_statement_observer() const;
+
+    // Pass all the buffered events to the observer right now.
+    void flush_statement_events();
+
+    // for internal use: NULL if the statements are not observed
+    details::statement_event_buffer * get_statement_events();
+
+    // Pass the details of the statement executions, including fetching all
+    // of their rows, which took at least the given number of milliseconds
+    // to the given sink, which is not owned by the session, or stop doing it
+    // if it's NULL. The strings and vectors among the values of the use
+    // elements are cut after maxValueLength characters or elements.
+    void set_slow_query_log(slow_query_sink * sink, int threshold,
+        std::size_t maxValueLength = 100);
+    slow_query_sink * get_slow_query_sink() const;
+    int get_slow_query_threshold() const;
+    std::size_t get_slow_query_max_value_length() const;
+
+    // Functions for executing the operations asynchronously.
+
+    // The operations are executed one after another, in the order of their
+    // submission. If the backend supports it (currently only PostgreSQL),
+    // they are executed without blocking (see statement::start_execute())
+    // and advanced when their results are checked or waited for, otherwise
+    // by a background thread created for the session when it's needed. The
+    // session and the statements involved must not be used in any other way
+    // until the operations complete.
+
+    // Execute the query, which can't have any into nor use elements,
+    // asynchronously. The result is the same as that of got_data().
+    async_result once_async(std::string const & query);
+
+    // Wait until all the asynchronous operations complete, this is also done
+    // when the session is destroyed.
+    void wait_async();
+
+    // for internal use: execute the task asynchronously, taking ownership
+    // of it
+    async_result run_async(details::async_task * task);
+
     // Functions for dealing with sequence/auto-increment values.
 
     // If true is returned, value is filled with the next value from the given
@@ -112,6 +187,19 @@ public:
     bool get_last_insert_id(std::string const & table, long & value);
 
 
+    // Return the descriptor of the socket connected to the server, which can
+    // be watched by an event loop while statements are executed without
+    // blocking (see statement::start_execute()), or -1 if the backend
+    // doesn't use one or doesn't provide access to it.
+    int get_socket();
+
+    // Check whether the connection to the database is still alive, using the
+    // backend-specific method, which may need a round trip to the server.
+    // Returns false if the session is not open. Notice that the backends
+    // without such method (currently all except PostgreSQL, MySQL and
+    // SQLite3) always return true for the open sessions.
+    bool is_connected();
+
     // for diagnostics and advanced users
     // (downcast it to expected back-end session class)
     details::session_backend * get_backend() { return backEnd_; }
@@ -122,6 +210,9 @@ public:
     details::rowid_backend * make_rowid_backend();
     details::blob_backend * make_blob_backend();
 
+    // NULL if the statement cache is disabled
+    details::statement_cache * get_statement_cache();
+
 private:
     session(session const &);
     session& operator=(session const &);
@@ -136,8 +227,22 @@ private:
 
     bool uppercaseColumnNames_;
 
+    std::size_t rowsetPrefetchSize_;
+
     details::session_backend * backEnd_;
 
+    details::statement_cache * statementCache_;
+
+    // NULL unless there is a statement observer
+    details::statement_event_buffer * statementEvents_;
+
+    slow_query_sink * slowQuerySink_;
+    int slowQueryThreshold_;
+    std::size_t slowQueryMaxValueLength_;
+
+    // NULL until the first asynchronous operation
+    details::async_worker * asyncWorker_;
+
     bool gotData_;
 
     bool isFromPool_;
@@ -0,0 +1,67 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_SLOW_QUERY_LOG_H_INCLUDED
+#define SOCI_SLOW_QUERY_LOG_H_INCLUDED
+
+#include "soci/soci-config.h"
+// std
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace soci
+{
+
+class session;
+
+// details of a single slow execution of a statement, the times are in
+// microseconds
+struct SOCI_DECL slow_query
+{
+    slow_query()
+        : rows(0), fetches(0), prepare_time(0), execute_time(0),
+          fetch_time(0), failed(false) {}
+
+    std::string query;
+
+    // values of the use elements, in the order of binding them
+    std::vector<std::string> parameters;
+
+    long long rows;      // rows fetched or affected
+    std::size_t fetches; // number of fetch() calls getting more rows
+
+    // time of preparing the statement, if it was done for this execution
+    // only, i.e. this is the first execution of the statement, or 0
+    long long prepare_time;
+
+    long long execute_time;
+    long long fetch_time;  // all fetch() calls together
+
+    bool failed; // the execution ended with an exception
+};
+
+// writes the query on a single line
+SOCI_DECL std::ostream & operator<<(std::ostream & os, slow_query const & q);
+
+// Base class for the destinations of the slow query log.
+class SOCI_DECL slow_query_sink
+{
+public:
+    virtual ~slow_query_sink() {}
+
+    // Called from the thread using the session when the execution of the
+    // statement ends, which happens after fetching all its rows or, if not
+    // all of them were fetched, when it's executed again or destroyed. This
+    // function must not throw.
+    virtual void on_slow_query(session & s, slow_query const & q) = 0;
+};
+
+} // namespace soci
+
+#endif // SOCI_SLOW_QUERY_LOG_H_INCLUDED
@@ -27,6 +27,10 @@ enum data_type
 // the enum type for indicator variables
 enum indicator { i_ok, i_null, i_truncated };
 
+// the state of a statement executed without blocking: either completed or
+// waiting for the session socket to become readable or writable
+enum step_status { step_done, step_wait_read, step_wait_write };
+
 class session;
 
 namespace details
@@ -167,6 +171,33 @@ public:
     virtual exec_fetch_result execute(int number) = 0;
     virtual exec_fetch_result fetch(int number) = 0;
 
+    // Support for executing the statement without blocking: start_execute()
+    // sends the statement to the server and step_execute() advances its
+    // execution as far as possible without blocking until it returns
+    // step_done, after which finish_execute() returns the same result as
+    // execute() would have. Backends which don't support this (or not for
+    // the given statement) return false from start_execute() and execute()
+    // is used instead.
+    virtual bool start_execute(int /* number */) { return false; }
+    virtual step_status step_execute() { return step_done; }
+    virtual exec_fetch_result finish_execute(int /* number */)
+    {
+        return ef_no_data;
+    }
+
+    // Return true if start_execute() would execute the statement without
+    // blocking at all, i.e. without any synchronous round trips to the
+    // server, and, respectively, if fetch() only uses the data already
+    // received from it.
+    virtual bool can_start_execute() { return false; }
+    virtual bool can_fetch_without_blocking() { return false; }
+
+    // Called when a prepared statement is kept around for a later execution
+    // with different bindings (e.g. by the session statement cache) to
+    // release any results still pending. This is not pure virtual as most
+    // backends simply discard the previous results on the next execution.
+    virtual void reset() {}
+
     virtual long long get_affected_rows() = 0;
     virtual int get_number_of_rows() = 0;
 
@@ -246,6 +277,15 @@ public:
 
     virtual std::string get_backend_name() const = 0;
 
+    // Return the descriptor of the socket used for communicating with the
+    // server or -1 if there is none or it is not available.
+    virtual int get_socket() { return -1; }
+
+    // Check whether the connection to the server is still usable, possibly
+    // by communicating with it. Backends which can't check it natively just
+    // return true.
+    virtual bool is_connected() { return true; }
+
     virtual statement_backend* make_statement_backend() = 0;
     virtual rowid_backend* make_rowid_backend() = 0;
     virtual blob_backend* make_blob_backend() = 0;
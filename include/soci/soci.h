@@ -13,10 +13,12 @@
 #endif
 
 // namespace soci
+#include "soci/async.h"
 #include "soci/backend-loader.h"
 #include "soci/blob.h"
 #include "soci/blob-exchange.h"
 #include "soci/connection-pool.h"
+#include "soci/duration-histogram.h"
 #include "soci/error.h"
 #include "soci/exchange-traits.h"
 #include "soci/into.h"
@@ -24,6 +26,7 @@
 #include "soci/once-temp-type.h"
 #include "soci/prepare-temp-type.h"
 #include "soci/procedure.h"
+#include "soci/query-statistics.h"
 #include "soci/ref-counted-prepare-info.h"
 #include "soci/ref-counted-statement.h"
 #include "soci/row.h"
@@ -32,10 +35,13 @@
 #include "soci/rowid-exchange.h"
 #include "soci/rowset.h"
 #include "soci/session.h"
+#include "soci/slow-query-log.h"
 #include "soci/soci-backend.h"
 #include "soci/soci-config.h"
 #include "soci/soci-platform.h"
 #include "soci/statement.h"
+#include "soci/statement-cache.h"
+#include "soci/statement-observer.h"
 #include "soci/transaction.h"
 #include "soci/type-conversion.h"
 #include "soci/type-conversion-traits.h"
@@ -93,17 +93,22 @@ struct sqlite3_vector_into_type_backend : details::vector_into_type_backend
 
     virtual void clean_up();
 
+    // store the value of the current row of the statement at the given
+    // index of the user vector, called for each row as it is stepped to
+    void fetch_row(int row);
+
     sqlite3_statement_backend& statement_;
 
     void *data_;
     details::exchange_type type_;
     int position_;
+    std::vector<indicator> indicators_;
 };
 
 struct sqlite3_standard_use_type_backend : details::standard_use_type_backend
 {
     sqlite3_standard_use_type_backend(sqlite3_statement_backend &st)
-        : statement_(st), buf_(0) {}
+        : statement_(st) {}
 
     virtual void bind_by_pos(int &position,
         void *data, details::exchange_type type, bool readOnly);
@@ -121,7 +126,6 @@ struct sqlite3_standard_use_type_backend : details::standard_use_type_backend
     details::exchange_type type_;
     int position_;
     std::string name_;
-    char *buf_;
 };
 
 struct sqlite3_vector_use_type_backend : details::vector_use_type_backend
@@ -148,12 +152,24 @@ struct sqlite3_vector_use_type_backend : details::vector_use_type_backend
     std::string name_;
 };
 
+// the way in which the value of a use element is bound to the statement
+enum sqlite3_bind_type
+{
+    bt_null, bt_int64, bt_double, bt_text, bt_blob
+};
+
 struct sqlite3_column
 {
-    std::string data_;
-    bool isNull_;
-    char * blobBuf_;
-    std::size_t blobSize_;
+    sqlite3_bind_type type_;
+    sqlite_api::sqlite3_int64 int64_;
+    double double_;
+
+    // text and blob values are bound directly from the memory owned by the
+    // use element, except for the values formatted into buf_, for which
+    // data_ is null
+    char const * data_;
+    std::size_t size_;
+    char buf_[32];
 };
 
 typedef std::vector<sqlite3_column> sqlite3_row;
@@ -173,6 +189,8 @@ struct sqlite3_statement_backend : details::statement_backend
     virtual exec_fetch_result execute(int number);
     virtual exec_fetch_result fetch(int number);
 
+    virtual void reset();
+
     virtual long long get_affected_rows();
     virtual int get_number_of_rows();
 
@@ -189,8 +207,11 @@ struct sqlite3_statement_backend : details::statement_backend
 
     sqlite3_session_backend &session_;
     sqlite_api::sqlite3_stmt *stmt_;
-    sqlite3_recordset dataCache_;
     sqlite3_recordset useData_;
+
+    // vector into elements filled directly from each row as it is read
+    std::vector<sqlite3_vector_into_type_backend*> vectorIntos_;
+    int numberOfRows_; // number of rows read by the last execute or fetch
     bool databaseReady_;
     bool boundByName_;
     bool boundByPos_;
@@ -230,6 +251,9 @@ struct sqlite3_blob_backend : details::blob_backend
 
     std::size_t set_data(char const *buf, std::size_t toWrite);
 
+    // direct access to the data, used for binding it without copying
+    char const * get_buffer() const { return buf_; }
+
 private:
     char *buf_;
     size_t len_;
@@ -249,6 +273,9 @@ struct sqlite3_session_backend : details::session_backend
 
     virtual std::string get_backend_name() const { return "sqlite3"; }
 
+    // the database is local, so the connection can't be lost
+    virtual bool is_connected() { return conn_ != NULL; }
+
     void clean_up();
 
     virtual sqlite3_statement_backend * make_statement_backend();
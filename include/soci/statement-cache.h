@@ -0,0 +1,91 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_STATEMENT_CACHE_H_INCLUDED
+#define SOCI_STATEMENT_CACHE_H_INCLUDED
+
+#include "soci/soci-config.h"
+// std
+#include <cstddef>
+#include <list>
+#include <map>
+#include <string>
+#include <utility>
+
+namespace soci
+{
+
+// counters describing the activity of the session statement cache
+struct SOCI_DECL statement_cache_stats
+{
+    statement_cache_stats()
+        : hits(0), misses(0), evictions(0), size(0) {}
+
+    unsigned long long hits;      // queries executed with a cached statement
+    unsigned long long misses;    // queries that had to be prepared
+    unsigned long long evictions; // statements dropped to respect the limit
+    std::size_t size;             // statements currently in the cache
+};
+
+namespace details
+{
+
+class statement_backend;
+
+// Bounded (LRU) cache of the backend statements prepared for the queries
+// executed with the "once" syntax, keyed by the full query text.
+//
+// Statements are checked out of the cache while they are used, so that the
+// same cached object is never shared by two statements at the same time.
+class SOCI_DECL statement_cache
+{
+public:
+    explicit statement_cache(std::size_t maxSize);
+    ~statement_cache();
+
+    std::size_t get_max_size() const { return maxSize_; }
+    void set_max_size(std::size_t maxSize);
+
+    // Removes the statement prepared for the given query from the cache and
+    // returns it or returns NULL if there is none.
+    statement_backend * acquire(std::string const & query);
+
+    // Gives back the statement prepared for the given query, possibly
+    // evicting the least recently used ones. The cache takes ownership of
+    // the statement.
+    void release(std::string const & query, statement_backend * st);
+
+    void clear();
+
+    statement_cache_stats get_stats() const;
+    void reset_stats();
+
+private:
+    typedef std::list<std::pair<std::string, statement_backend *> > entries_t;
+    typedef std::map<std::string, entries_t::iterator> index_t;
+
+    void evict_to(std::size_t size);
+    static void destroy(statement_backend * st);
+
+    std::size_t maxSize_;
+
+    // most recently used entries come first
+    entries_t entries_;
+    index_t index_;
+
+    statement_cache_stats stats_;
+
+    // noncopyable
+    statement_cache(statement_cache const &);
+    statement_cache& operator=(statement_cache const &);
+};
+
+} // namespace details
+
+} // namespace soci
+
+#endif // SOCI_STATEMENT_CACHE_H_INCLUDED
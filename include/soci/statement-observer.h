@@ -0,0 +1,117 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_STATEMENT_OBSERVER_H_INCLUDED
+#define SOCI_STATEMENT_OBSERVER_H_INCLUDED
+
+#include "soci/soci-config.h"
+// std
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace soci
+{
+
+class session;
+
+namespace details
+{
+
+class session_backend;
+
+} // namespace details
+
+// the phases of the statement life reported to the statement observers
+enum statement_phase
+{
+    sp_prepare,
+    sp_execute,
+    sp_fetch,     // fetching of a batch of rows
+    sp_clean_up
+};
+
+struct SOCI_DECL statement_event
+{
+    statement_event()
+        : phase(sp_prepare), start(0), duration(0), rows(-1), parameters(0),
+          failed(false) {}
+
+    statement_phase phase;
+
+    // when the phase started, in microseconds since some unspecified point,
+    // not affected by the changes of the system clock, and how long it took
+    long long start;
+    long long duration;
+
+    // rows fetched by execute or fetch or affected by execute of the
+    // statements without into elements, -1 if unknown or not applicable
+    long long rows;
+
+    std::size_t parameters; // number of use elements
+    bool failed;            // the phase ended with an exception
+
+    std::string query;
+    std::string backend;    // name of the backend of the session
+};
+
+// Base class for the observers of the statements executed by the session.
+class SOCI_DECL statement_observer
+{
+public:
+    virtual ~statement_observer() {}
+
+    // Called with the events in the order of their occurrence, from the
+    // thread using the session, when the buffer of the session is full or
+    // when it is flushed explicitly, which also happens when the session is
+    // closed or the observer changed. This function must not throw.
+    virtual void on_events(session & s,
+        statement_event const * events, std::size_t count) = 0;
+};
+
+namespace details
+{
+
+// Fixed size buffer of the events not yet passed to the observer. As the
+// session is used by a single thread at a time, filling it doesn't need any
+// synchronization and, once its events are allocated, any allocations.
+class SOCI_DECL statement_event_buffer
+{
+public:
+    statement_event_buffer(session & s, statement_observer & observer,
+        std::size_t capacity);
+
+    statement_observer & get_observer() const { return observer_; }
+
+    // Returns the event to be filled by the caller, passing the buffered
+    // events to the observer first if there is no more space.
+    statement_event & add();
+
+    void flush();
+
+    // name of the backend of the session, cached between the calls
+    std::string const & get_backend_name(session_backend * backEnd);
+
+private:
+    session & session_;
+    statement_observer & observer_;
+    std::vector<statement_event> events_;
+    std::size_t count_;
+
+    session_backend * backEnd_;
+    std::string backendName_;
+
+    // noncopyable
+    statement_event_buffer(statement_event_buffer const &);
+    statement_event_buffer & operator=(statement_event_buffer const &);
+};
+
+} // namespace details
+
+} // namespace soci
+
+#endif // SOCI_STATEMENT_OBSERVER_H_INCLUDED
@@ -8,13 +8,17 @@
 #ifndef SOCI_STATEMENT_H_INCLUDED
 #define SOCI_STATEMENT_H_INCLUDED
 
+#include "soci/async.h"
 #include "soci/into-type.h"
 #include "soci/into.h"
 #include "soci/use-type.h"
 #include "soci/soci-backend.h"
 #include "soci/row.h"
+#include "soci/statement-observer.h"
+#include "soci/slow-query-log.h"
 // std
 #include <cstddef>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -30,6 +34,9 @@ namespace details
 class into_type_base;
 class use_type_base;
 class prepare_temp_type;
+class statement_cache;
+class statement_event_buffer;
+class prefetch_buffer_base;
 
 class SOCI_DECL statement_impl
 {
@@ -46,15 +53,29 @@ public:
 
     void prepare(std::string const & query,
                     statement_type eType = st_repeatable_query);
+    void prepare_cached(std::string const & query);
     void define_and_bind();
     void undefine_and_bind();
     bool execute(bool withDataExchange = false);
     long long get_affected_rows();
     bool fetch();
+
+    // non-blocking execution, gotData is filled when step_done is returned
+    step_status start_execute(bool withDataExchange, bool & gotData);
+    step_status step(bool & gotData);
+
+    // true if start_execute() and fetch() don't block at all
+    bool can_start_execute();
+    bool can_fetch_without_blocking();
+
     void describe();
     void set_row(row * r);
     void exchange_for_rowset(into_type_ptr const & i);
 
+    // fetch this many rows at once for the into(row) element, if it's the
+    // only into element, and return them one by one from fetch()
+    void set_row_prefetch_size(std::size_t size);
+
     // for diagnostics and advanced users
     // (downcast it to expected back-end statement class)
     statement_backend * get_backend() { return backEnd_; }
@@ -85,6 +106,13 @@ private:
     std::size_t initialFetchSize_;
     std::string query_;
 
+    // the names of the placeholders used in the query, extracted from it
+    // once when they are needed for binding named use elements of values
+    std::set<std::string> placeholders_;
+    bool placeholdersParsed_;
+
+    bool is_placeholder_used(std::string const & name);
+
     std::vector<into_type_base *> intosForRow_;
     int definePositionForRow_;
 
@@ -92,19 +120,82 @@ private:
     void define_for_row();
 
     template<typename T>
-    void into_row()
-    {
-        T * t = new T();
-        indicator * ind = new indicator(i_ok);
-        row_->add_holder(t, ind);
-        exchange_for_row(into(*t, *ind));
-    }
+    void into_row(std::size_t pos);
 
     template<data_type>
-    void bind_into();
+    void bind_into(std::size_t pos);
+
+    // the buffers holding the prefetched rows, one per column, empty if
+    // the rows are not prefetched
+    std::size_t rowPrefetchSize_;
+    std::vector<prefetch_buffer_base *> prefetchBuffers_;
+    std::size_t prefetchedRows_;
+    std::size_t prefetchedPos_;
+    bool prefetchExhausted_;
+
+    bool load_prefetched_rows(statement_backend::exec_fetch_result res,
+        bool calledFromFetch);
+    bool fetch_prefetched_row();
+    void copy_prefetched_row();
 
     bool alreadyDescribed_;
 
+    // the cache the backend statement was taken from and will be returned
+    // to if it was successfully executed, NULL if it is not cached
+    statement_cache * cache_;
+    bool backEndReusable_;
+
+    // the parts of execute() done before and after the backend executes
+    // the statement, begin_execute() returns the number of rows to exchange
+    int begin_execute(bool withDataExchange);
+    bool end_execute(statement_backend::exec_fetch_result res, int num);
+
+    // the number of rows to exchange while the statement is being executed
+    // without blocking, -1 otherwise
+    int nonBlockingNum_;
+
+    // reporting of the statement phases to the observer of the session:
+    // the phase_reporter objects measure the phases and call report_phase()
+    class phase_reporter;
+    friend class phase_reporter;
+
+    void report_phase(statement_event_buffer & events, statement_phase phase,
+        long long start, long long end, long long rows, bool failed);
+
+    // rows fetched or affected by the last execute() or fetch()
+    long long get_reported_rows(bool gotData, bool executed);
+
+    // when the execution without blocking started, if it's observed
+    long long nonBlockingStart_;
+
+    // The current execution of the statement, from execute() until fetching
+    // all of its rows, accounted for in the query statistics and the slow
+    // query log when it ends.
+    bool cycleActive_;
+    long long cyclePrepareTime_;
+    long long cycleExecuteTime_;
+    long long cycleFetchTime_;
+    std::size_t cycleFetches_;
+    long long cycleRows_;
+    bool cycleFailed_;
+
+    // values of the use elements at the start of the current execution, only
+    // filled in if the slow query log is enabled
+    std::vector<std::string> cycleParameters_;
+
+    // time of preparing the statement, until it's executed for the first time
+    long long prepareTime_;
+
+    // the query with the literals removed, computed when it's needed
+    std::string normalizedQuery_;
+
+    bool is_tracked(statement_phase phase);
+    void add_to_cycle(statement_phase phase, long long duration,
+        long long rows, bool failed);
+    void end_cycle();
+    void log_slow_query(slow_query_sink & sink);
+    void save_cycle_parameters();
+
     std::size_t intos_size();
     std::size_t uses_size();
     void pre_fetch();
@@ -161,6 +252,13 @@ public:
         impl_->prepare(query, eType);
     }
 
+    // prepare one-time query, possibly reusing the statement from the
+    // session statement cache
+    void prepare_cached(std::string const & query)
+    {
+        impl_->prepare_cached(query);
+    }
+
     void define_and_bind() { impl_->define_and_bind(); }
     void undefine_and_bind()  { impl_->undefine_and_bind(); }
     bool execute(bool withDataExchange = false)
@@ -180,6 +278,36 @@ public:
         return gotData_;
     }
 
+    // Execute the statement without blocking: start_execute() starts doing
+    // it and step() continues, each of them returns step_done when the
+    // execution completes, after which got_data() returns the same value as
+    // execute() would, or which of the events of the session socket (see
+    // session::get_socket()) to wait for before calling step() again.
+    step_status start_execute(bool withDataExchange = false)
+    {
+        return impl_->start_execute(withDataExchange, gotData_);
+    }
+
+    step_status step()
+    {
+        return impl_->step(gotData_);
+    }
+
+    // Return true if start_execute() executes the statement without blocking
+    // at all, false if it would need to do it synchronously, at least
+    // partially, and, similarly, if fetch() doesn't block.
+    bool can_start_execute() { return impl_->can_start_execute(); }
+    bool can_fetch_without_blocking()
+    {
+        return impl_->can_fetch_without_blocking();
+    }
+
+    // Asynchronous versions of execute() and fetch(), see
+    // session::run_async(). This object must not be used nor destroyed until
+    // the operation completes.
+    async_result execute_async(bool withDataExchange = false);
+    async_result fetch_async();
+
     bool got_data() const { return gotData_; }
 
     void describe()       { impl_->describe(); }
@@ -189,6 +317,11 @@ public:
         impl_->exchange_for_rowset(i);
     }
 
+    void set_row_prefetch_size(std::size_t size)
+    {
+        impl_->set_row_prefetch_size(size);
+    }
+
     // for diagnostics and advanced users
     // (downcast it to expected back-end statement class)
     details::statement_backend * get_backend()
@@ -7,8 +7,12 @@
 
 #ifndef SOCI_TYPE_HOLDER_H_INCLUDED
 #define SOCI_TYPE_HOLDER_H_INCLUDED
+
+#include "soci/soci-backend.h"
 // std
-#include <typeinfo>
+#include <cstddef>
+#include <ctime>
+#include <string>
 
 namespace soci
 {
@@ -16,49 +20,57 @@ namespace soci
 namespace details
 {
 
-// Base class holder + derived class type_holder for storing type data
-// instances in a container of holder objects
-template <typename T>
-class type_holder;
+// Description of a single value stored in a row: its type, its indicator and
+// its location in the memory block holding the values of all the columns.
+struct holder
+{
+    exchange_type type_;
+    indicator ind_;
+    std::size_t offset_;
+};
 
-class holder
+// Type tags of the types which can be stored in a row, used to check that the
+// value is retrieved with the correct type. Any other type can't be stored.
+template <typename T>
+struct holder_traits
 {
-public:
-    holder() {}
-    virtual ~holder() {}
+    enum { type = -1 };
+};
 
-    template<typename T>
-    T get()
-    {
-        type_holder<T>* p = dynamic_cast<type_holder<T> *>(this);
-        if (p)
-        {
-            return p->template value<T>();
-        }
-        else
-        {
-            throw std::bad_cast();
-        }
-    }
+template <>
+struct holder_traits<std::string>
+{
+    enum { type = x_stdstring };
+};
 
-private:
+template <>
+struct holder_traits<double>
+{
+    enum { type = x_double };
+};
 
-    template<typename T>
-    T value();
+template <>
+struct holder_traits<int>
+{
+    enum { type = x_integer };
 };
 
-template <typename T>
-class type_holder : public holder
+template <>
+struct holder_traits<long long>
 {
-public:
-    type_holder(T * t) : t_(t) {}
-    ~type_holder() { delete t_; }
+    enum { type = x_long_long };
+};
 
-    template<typename TypeValue>
-    TypeValue value() const { return *t_; }
+template <>
+struct holder_traits<unsigned long long>
+{
+    enum { type = x_unsigned_long_long };
+};
 
-private:
-    T * t_;
+template <>
+struct holder_traits<std::tm>
+{
+    enum { type = x_stdtm };
 };
 
 } // namespace details
@@ -13,6 +13,7 @@
 #include "soci/exchange-traits.h"
 // std
 #include <cstddef>
+#include <iosfwd>
 #include <string>
 #include <vector>
 
@@ -33,6 +34,12 @@ public:
     virtual void clean_up() = 0;
 
     virtual std::size_t size() const = 0;  // returns the number of elements
+
+    // write the value (or values) for diagnostic purposes, cutting the
+    // strings and vectors after maxLength characters or elements, nothing
+    // is written for the elements which don't have any value of their own
+    virtual void dump_value(std::ostream & /* os */,
+        std::size_t /* maxLength */) const {}
 };
 
 typedef type_ptr<use_type_base> use_type_ptr;
@@ -70,9 +77,11 @@ public:
 
     virtual ~standard_use_type();
     virtual void bind(statement_impl & st, int & position);
-    std::string get_name() const { return name_; }
+    std::string const & get_name() const { return name_; }
     virtual void * get_data() { return data_; }
 
+    virtual void dump_value(std::ostream & os, std::size_t maxLength) const;
+
     // conversion hook (from arbitrary user type to base type)
     virtual void convert_to_base() {}
     virtual void convert_from_base() {}
@@ -118,6 +127,8 @@ public:
 
     ~vector_use_type();
 
+    virtual void dump_value(std::ostream & os, std::size_t maxLength) const;
+
 private:
     virtual void bind(statement_impl& st, int & position);
     virtual void pre_use();
@@ -49,11 +49,26 @@ class SOCI_DECL values
 
 public:
 
-    values() : row_(NULL), currentPos_(0), uppercaseColumnNames_(false) {}
+    values()
+        : row_(NULL), columnCacheHint_(0), currentPos_(0),
+          uppercaseColumnNames_(false) {}
 
     indicator get_indicator(std::size_t pos) const;
     indicator get_indicator(std::string const & name) const;
 
+    template <std::size_t N>
+    indicator get_indicator(char const (&name)[N]) const
+    {
+        return row_ != NULL
+            ? row_->get_indicator(find_cached_column(name))
+            : get_indicator(std::string(name));
+    }
+
+    // Return the position of the column with the given name, which can be
+    // used instead of the name for all the rows of the same statement, see
+    // row::find_column().
+    std::size_t find_column(std::string const & name) const;
+
     template <typename T>
     T get(std::size_t pos) const
     {
@@ -106,6 +121,25 @@ public:
             : get_from_uses<T>(name, nullValue);
     }
 
+    // overloads for the names given as string literals, which are typically
+    // used by type_conversion<>::from_base(): their positions in the row are
+    // only looked up for the first row and then reused for all the others
+    template <typename T, std::size_t N>
+    T get(char const (&name)[N]) const
+    {
+        return row_ != NULL
+            ? row_->get<T>(find_cached_column(name))
+            : get_from_uses<T>(std::string(name));
+    }
+
+    template <typename T, std::size_t N>
+    T get(char const (&name)[N], T const & nullValue) const
+    {
+        return row_ != NULL
+            ? row_->get<T>(find_cached_column(name), nullValue)
+            : get_from_uses<T>(std::string(name), nullValue);
+    }
+
     template <typename T>
     values const & operator>>(T & value) const
     {
@@ -249,10 +283,21 @@ private:
     std::map<std::string, std::size_t> index_;
     std::vector<details::copy_base *> deepCopies_;
 
+    // positions of the row columns already looked up by find_cached_column()
+    // indexed by the addresses of their names, which are the same for all the
+    // rows when they are string literals, and the index of the entry to check
+    // first, as the columns are usually looked up in the same order
+    typedef std::pair<char const *, std::size_t> cached_column;
+    mutable std::vector<cached_column> columnCache_;
+    mutable std::size_t columnCacheHint_;
+
     mutable std::size_t currentPos_;
 
     bool uppercaseColumnNames_;
 
+    // find the position of the column in row_ using columnCache_
+    std::size_t find_cached_column(char const * name) const;
+
     // When type_conversion::to() is called, a values object is created
     // without an underlying row object.  In that case, get_from_uses()
     // returns the underlying field values
@@ -312,6 +357,9 @@ private:
 
     row& get_row()
     {
+        columnCache_.clear();
+        columnCacheHint_ = 0;
+
         row_ = new row();
         row_->uppercase_column_names(uppercaseColumnNames_);
 
@@ -332,6 +380,9 @@ private:
         delete row_;
         row_ = NULL;
 
+        columnCache_.clear();
+        columnCacheHint_ = 0;
+
         // delete any uses and indicators which were created  by set() but
         // were not bound by the Statement
         // (bound uses and indicators are deleted in Statement::clean_up())
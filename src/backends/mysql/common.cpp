@@ -7,6 +7,7 @@
 
 #include "common.h"
 #include "soci/soci-backend.h"
+#include "soci-exchange-cast.h"
 #include <ciso646>
 #include <cstdlib>
 #include <cstring>
@@ -85,3 +86,207 @@ char * soci::details::mysql::quote(MYSQL * conn, const char *s, int len)
 
     return retv;
 }
+
+void * soci::details::mysql::vector_element(void *p, exchange_type type,
+    std::size_t i)
+{
+    switch (type)
+    {
+    case x_char:         return get_vector_element<char>         (p, i);
+    case x_short:        return get_vector_element<short>        (p, i);
+    case x_integer:      return get_vector_element<int>          (p, i);
+    case x_long_long:    return get_vector_element<long long>    (p, i);
+    case x_unsigned_long_long:
+        return get_vector_element<unsigned long long>(p, i);
+    case x_double:       return get_vector_element<double>       (p, i);
+    case x_stdstring:    return get_vector_element<std::string>  (p, i);
+    case x_stdtm:        return get_vector_element<std::tm>      (p, i);
+
+    default:
+        throw soci_error("Vector element used with non-supported type.");
+    }
+}
+
+void soci::details::mysql::bind_param(MYSQL_BIND &bind, void *data,
+    exchange_type type, MYSQL_TIME &time)
+{
+    std::memset(&bind, 0, sizeof(bind));
+
+    // The numeric values are sent directly from the user's variables.
+    switch (type)
+    {
+    case x_char:
+        bind.buffer_type = MYSQL_TYPE_STRING;
+        bind.buffer = data;
+        bind.buffer_length = 1;
+        break;
+    case x_stdstring:
+        {
+            std::string const& s = exchange_type_cast<x_stdstring>(data);
+            bind.buffer_type = MYSQL_TYPE_STRING;
+            bind.buffer = const_cast<char *>(s.data());
+            bind.buffer_length = static_cast<unsigned long>(s.size());
+        }
+        break;
+    case x_short:
+        bind.buffer_type = MYSQL_TYPE_SHORT;
+        bind.buffer = data;
+        break;
+    case x_integer:
+        bind.buffer_type = MYSQL_TYPE_LONG;
+        bind.buffer = data;
+        break;
+    case x_long_long:
+        bind.buffer_type = MYSQL_TYPE_LONGLONG;
+        bind.buffer = data;
+        break;
+    case x_unsigned_long_long:
+        bind.buffer_type = MYSQL_TYPE_LONGLONG;
+        bind.buffer = data;
+        bind.is_unsigned = 1;
+        break;
+    case x_double:
+        if (is_infinity_or_nan(exchange_type_cast<x_double>(data)))
+        {
+            throw soci_error(
+                "Use element used with infinity or NaN, which are "
+                "not supported by the MySQL server.");
+        }
+
+        bind.buffer_type = MYSQL_TYPE_DOUBLE;
+        bind.buffer = data;
+        break;
+    case x_stdtm:
+        {
+            std::tm const& t = exchange_type_cast<x_stdtm>(data);
+
+            std::memset(&time, 0, sizeof(time));
+            time.year = t.tm_year + 1900;
+            time.month = t.tm_mon + 1;
+            time.day = t.tm_mday;
+            time.hour = t.tm_hour;
+            time.minute = t.tm_min;
+            time.second = t.tm_sec;
+            time.time_type = MYSQL_TIMESTAMP_DATETIME;
+
+            bind.buffer_type = MYSQL_TYPE_DATETIME;
+            bind.buffer = &time;
+        }
+        break;
+    default:
+        throw soci_error("Use element used with non-supported type.");
+    }
+}
+
+void soci::details::mysql::bind_result(MYSQL_BIND &bind, void *data,
+    exchange_type type, mysql_column_state &state)
+{
+    std::memset(&bind, 0, sizeof(bind));
+    bind.is_null = &state.isNull_;
+    bind.error = &state.error_;
+    bind.length = &state.length_;
+
+    // The numeric values are converted to the requested type by the client
+    // library and stored directly in the user's variables.
+    switch (type)
+    {
+    case x_char:
+        bind.buffer_type = MYSQL_TYPE_STRING;
+        bind.buffer = data;
+        bind.buffer_length = 1;
+        break;
+    case x_stdstring:
+        // The length is not known in advance, so only retrieve it when
+        // fetching the row and get the data itself in fetch_result().
+        bind.buffer_type = MYSQL_TYPE_STRING;
+        break;
+    case x_short:
+        bind.buffer_type = MYSQL_TYPE_SHORT;
+        bind.buffer = data;
+        break;
+    case x_integer:
+        bind.buffer_type = MYSQL_TYPE_LONG;
+        bind.buffer = data;
+        break;
+    case x_long_long:
+        bind.buffer_type = MYSQL_TYPE_LONGLONG;
+        bind.buffer = data;
+        break;
+    case x_unsigned_long_long:
+        bind.buffer_type = MYSQL_TYPE_LONGLONG;
+        bind.buffer = data;
+        bind.is_unsigned = 1;
+        break;
+    case x_double:
+        bind.buffer_type = MYSQL_TYPE_DOUBLE;
+        bind.buffer = data;
+        break;
+    case x_stdtm:
+        bind.buffer_type = MYSQL_TYPE_DATETIME;
+        bind.buffer = &state.time_;
+        break;
+    default:
+        throw soci_error("Into element used with non-supported type.");
+    }
+}
+
+void soci::details::mysql::fetch_result(MYSQL_STMT *stmt, int pos,
+    void *data, exchange_type type, mysql_column_state &state)
+{
+    if (state.isNull_)
+    {
+        return;
+    }
+
+    switch (type)
+    {
+    case x_char:
+        // truncation to the first character is expected here
+        break;
+    case x_stdstring:
+        {
+            std::string& dest = exchange_type_cast<x_stdstring>(data);
+            dest.resize(state.length_);
+            if (state.length_ != 0)
+            {
+                MYSQL_BIND bind;
+                std::memset(&bind, 0, sizeof(bind));
+                bind.buffer_type = MYSQL_TYPE_STRING;
+                bind.buffer = &dest[0];
+                bind.buffer_length = state.length_;
+
+                if (0 != mysql_stmt_fetch_column(stmt, &bind, pos, 0))
+                {
+                    throw mysql_soci_error(mysql_stmt_error(stmt),
+                        mysql_stmt_errno(stmt));
+                }
+            }
+        }
+        break;
+    case x_stdtm:
+        {
+            MYSQL_TIME const& time = state.time_;
+            std::tm& t = exchange_type_cast<x_stdtm>(data);
+
+            // use the same default date as parse_std_tm() for TIME columns
+            bool const hasDate = time.time_type != MYSQL_TIMESTAMP_TIME;
+
+            t.tm_isdst = -1;
+            t.tm_year = hasDate ? static_cast<int>(time.year) - 1900 : 100;
+            t.tm_mon  = hasDate ? static_cast<int>(time.month) - 1 : 0;
+            t.tm_mday = hasDate ? static_cast<int>(time.day) : 1;
+            t.tm_hour = time.hour;
+            t.tm_min  = time.minute;
+            t.tm_sec  = time.second;
+
+            std::mktime(&t);
+        }
+        break;
+    default:
+        if (state.error_)
+        {
+            throw soci_error("Cannot convert data.");
+        }
+        break;
+    }
+}
@@ -84,6 +84,31 @@ std::size_t get_vector_size(void *p)
     return v->size();
 }
 
+template <typename T>
+void * get_vector_element(void *p, std::size_t i)
+{
+    std::vector<T> *v = static_cast<std::vector<T> *>(p);
+    return &(*v)[i];
+}
+
+// returns the address of the i-th element of the vector of the given type
+void * vector_element(void *p, exchange_type type, std::size_t i);
+
+// helpers for server-side prepared statements
+
+// sets up the bind to pass the value pointed to by data to the server,
+// the time buffer is used for std::tm values which need to be converted
+void bind_param(MYSQL_BIND &bind, void *data, exchange_type type,
+    MYSQL_TIME &time);
+
+// sets up the bind to fetch the column value directly into data, if possible
+void bind_result(MYSQL_BIND &bind, void *data, exchange_type type,
+    mysql_column_state &state);
+
+// completes fetching the column value into data after the row was fetched
+void fetch_result(MYSQL_STMT *stmt, int pos, void *data, exchange_type type,
+    mysql_column_state &state);
+
 } // namespace mysql
 
 } // namespace details
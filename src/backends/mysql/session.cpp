@@ -157,7 +157,10 @@ void parse_connect_string(const string & connectString,
     int *port, bool *port_p, string *ssl_ca, bool *ssl_ca_p,
     string *ssl_cert, bool *ssl_cert_p, string *ssl_key, bool *ssl_key_p,
     int *local_infile, bool *local_infile_p,
-    string *charset, bool *charset_p)
+    string *charset, bool *charset_p,
+    int *prepared_statements, bool *prepared_statements_p,
+    int *multi_row_inserts, bool *multi_row_inserts_p,
+    int *stream_results, bool *stream_results_p)
 {
     *host_p = false;
     *user_p = false;
@@ -170,6 +173,9 @@ void parse_connect_string(const string & connectString,
     *ssl_key_p = false;
     *local_infile_p = false;
     *charset_p = false;
+    *prepared_statements_p = false;
+    *multi_row_inserts_p = false;
+    *stream_results_p = false;
     string err = "Malformed connection string.";
     string::const_iterator i = connectString.begin(),
         end = connectString.end();
@@ -199,7 +205,7 @@ void parse_connect_string(const string & connectString,
                 throw soci_error(err);
             }
             *port = std::atoi(val.c_str());
-            if (port < 0)
+            if (*port < 0)
             {
                 throw soci_error(err);
             }
@@ -263,6 +269,45 @@ void parse_connect_string(const string & connectString,
             *charset = val;
             *charset_p = true;
         }
+        else if (par == "prepared_statements" and not *prepared_statements_p)
+        {
+            if (not valid_int(val))
+            {
+                throw soci_error(err);
+            }
+            *prepared_statements = std::atoi(val.c_str());
+            if (*prepared_statements != 0 and *prepared_statements != 1)
+            {
+                throw soci_error(err);
+            }
+            *prepared_statements_p = true;
+        }
+        else if (par == "multi_row_inserts" and not *multi_row_inserts_p)
+        {
+            if (not valid_int(val))
+            {
+                throw soci_error(err);
+            }
+            *multi_row_inserts = std::atoi(val.c_str());
+            if (*multi_row_inserts != 0 and *multi_row_inserts != 1)
+            {
+                throw soci_error(err);
+            }
+            *multi_row_inserts_p = true;
+        }
+        else if (par == "stream_results" and not *stream_results_p)
+        {
+            if (not valid_int(val))
+            {
+                throw soci_error(err);
+            }
+            *stream_results = std::atoi(val.c_str());
+            if (*stream_results != 0 and *stream_results != 1)
+            {
+                throw soci_error(err);
+            }
+            *stream_results_p = true;
+        }
         else
         {
             throw soci_error(err);
@@ -277,14 +322,23 @@ mysql_session_backend::mysql_session_backend(
 {
     string host, user, password, db, unix_socket, ssl_ca, ssl_cert, ssl_key,
         charset;
-    int port, local_infile;
+    int port, local_infile, prepared_statements, multi_row_inserts,
+        stream_results;
     bool host_p, user_p, password_p, db_p, unix_socket_p, port_p,
-        ssl_ca_p, ssl_cert_p, ssl_key_p, local_infile_p, charset_p;
+        ssl_ca_p, ssl_cert_p, ssl_key_p, local_infile_p, charset_p,
+        prepared_statements_p, multi_row_inserts_p, stream_results_p;
     parse_connect_string(parameters.get_connect_string(), &host, &host_p, &user, &user_p,
         &password, &password_p, &db, &db_p,
         &unix_socket, &unix_socket_p, &port, &port_p,
         &ssl_ca, &ssl_ca_p, &ssl_cert, &ssl_cert_p, &ssl_key, &ssl_key_p,
-        &local_infile, &local_infile_p, &charset, &charset_p);
+        &local_infile, &local_infile_p, &charset, &charset_p,
+        &prepared_statements, &prepared_statements_p,
+        &multi_row_inserts, &multi_row_inserts_p,
+        &stream_results, &stream_results_p);
+    preparedStatements_ = prepared_statements_p and prepared_statements == 1;
+    multiRowInserts_ = multi_row_inserts_p and multi_row_inserts == 1;
+    streamResults_ = stream_results_p and stream_results == 1;
+    maxAllowedPacket_ = 0;
     conn_ = mysql_init(NULL);
     if (conn_ == NULL)
     {
@@ -372,6 +426,46 @@ bool mysql_session_backend::get_last_insert_id(
     return true;
 }
 
+std::size_t mysql_session_backend::get_max_allowed_packet()
+{
+    if (maxAllowedPacket_ == 0)
+    {
+        hard_exec(conn_, "SELECT @@max_allowed_packet");
+
+        MYSQL_RES *result = mysql_store_result(conn_);
+        if (result == NULL)
+        {
+            throw mysql_soci_error(mysql_error(conn_), mysql_errno(conn_));
+        }
+
+        MYSQL_ROW row = mysql_fetch_row(result);
+        if (row != NULL and row[0] != NULL)
+        {
+            maxAllowedPacket_ = std::strtoul(row[0], NULL, 10);
+        }
+        mysql_free_result(result);
+
+        if (maxAllowedPacket_ == 0)
+        {
+            throw soci_error("Failed to retrieve max_allowed_packet value.");
+        }
+    }
+
+    return maxAllowedPacket_;
+}
+
+int mysql_session_backend::get_socket()
+{
+    // the client library doesn't have a function for this, but the
+    // descriptor is accessible in the public connection structure
+    return conn_ != NULL ? static_cast<int>(conn_->net.fd) : -1;
+}
+
+bool mysql_session_backend::is_connected()
+{
+    return conn_ != NULL && mysql_ping(conn_) == 0;
+}
+
 void mysql_session_backend::clean_up()
 {
     if (conn_ != NULL)
@@ -12,6 +12,7 @@
 #include "common.h"
 #include "soci-exchange-cast.h"
 // std
+#include <algorithm>
 #include <cassert>
 #include <ciso646>
 #include <cstdlib>
@@ -34,6 +35,8 @@ void mysql_standard_into_type_backend::define_by_pos(
     data_ = data;
     type_ = type;
     position_ = position++;
+
+    statement_.intos_.push_back(this);
 }
 
 void mysql_standard_into_type_backend::pre_fetch()
@@ -51,14 +54,30 @@ void mysql_standard_into_type_backend::post_fetch(
         return;
     }
 
-    if (gotData)
+    if (gotData && statement_.stmt_ != NULL)
+    {
+        // the value was already stored by fetch_result()
+        if (state_.isNull_)
+        {
+            if (ind == NULL)
+            {
+                throw soci_error(
+                    "Null value fetched and no indicator defined.");
+            }
+            *ind = i_null;
+        }
+        else if (ind != NULL)
+        {
+            *ind = i_ok;
+        }
+    }
+    else if (gotData)
     {
         int pos = position_ - 1;
-        //mysql_data_seek(statement_.result_, statement_.currentRow_);
-        mysql_row_seek(statement_.result_,
-            statement_.resultRowOffsets_[statement_.currentRow_]);
-        MYSQL_ROW row = mysql_fetch_row(statement_.result_);
-        if (row[pos] == NULL)
+        unsigned long length = 0;
+        const char *buf = statement_.get_value(statement_.currentRow_, pos,
+            length);
+        if (buf == NULL)
         {
             if (ind == NULL)
             {
@@ -75,7 +94,6 @@ void mysql_standard_into_type_backend::post_fetch(
                 *ind = i_ok;
             }
         }
-        const char *buf = row[pos] != NULL ? row[pos] : "";
         switch (type_)
         {
         case x_char:
@@ -84,9 +102,7 @@ void mysql_standard_into_type_backend::post_fetch(
         case x_stdstring:
             {
                 std::string& dest = exchange_type_cast<x_stdstring>(data_);
-                unsigned long * lengths =
-                    mysql_fetch_lengths(statement_.result_);
-                dest.assign(buf, lengths[pos]);
+                dest.assign(buf, length);
             }
             break;
         case x_short:
@@ -116,5 +132,17 @@ void mysql_standard_into_type_backend::post_fetch(
 
 void mysql_standard_into_type_backend::clean_up()
 {
-    // nothing to do here
+    std::vector<mysql_standard_into_type_backend *> &intos
+        = statement_.intos_;
+    intos.erase(std::remove(intos.begin(), intos.end(), this), intos.end());
+}
+
+void mysql_standard_into_type_backend::bind_result(MYSQL_BIND &bind)
+{
+    mysql::bind_result(bind, data_, type_, state_);
+}
+
+void mysql_standard_into_type_backend::fetch_result()
+{
+    mysql::fetch_result(statement_.stmt_, position_ - 1, data_, type_, state_);
 }
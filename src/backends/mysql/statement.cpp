@@ -10,6 +10,7 @@
 #include "soci/mysql/soci-mysql.h"
 #include <cctype>
 #include <ciso646>
+#include <cstring>
 //#include <iostream>
 
 #ifdef _MSC_VER
@@ -23,8 +24,11 @@ using std::string;
 
 mysql_statement_backend::mysql_statement_backend(
     mysql_session_backend &session)
-    : session_(session), result_(NULL),
+    : session_(session), result_(NULL), stmt_(NULL), metadata_(NULL),
+       bulkInsertPrefix_(0), bulkInsertSuffix_(0),
        rowsAffectedBulk_(-1LL), justDescribed_(false),
+       streamResults_(session.streamResults_), streaming_(false),
+       streamEnd_(false),
        hasIntoElements_(false), hasVectorIntoElements_(false),
        hasUseElements_(false), hasVectorUseElements_(false)
 {
@@ -40,6 +44,11 @@ void mysql_statement_backend::clean_up()
     // 'reset' the value for a
     // potential new execution.
     rowsAffectedBulk_ = -1;
+    streaming_ = false;
+
+    // this is only called before executing plain queries or when the
+    // statement is destroyed
+    close_prepared();
 
     if (result_ != NULL)
     {
@@ -48,10 +57,49 @@ void mysql_statement_backend::clean_up()
     }
 }
 
+void mysql_statement_backend::reset()
+{
+    if (stmt_ != NULL)
+    {
+        mysql_stmt_free_result(stmt_);
+    }
+    else
+    {
+        clean_up();
+    }
+}
+
+namespace // anonymous
+{
+
+// Server error returned when trying to prepare a statement which can't be
+// used with the prepared statements protocol (ER_UNSUPPORTED_PS).
+unsigned int const unsupported_prepared_statement = 1295;
+
+} // namespace anonymous
+
+void mysql_statement_backend::close_prepared()
+{
+    if (metadata_ != NULL)
+    {
+        mysql_free_result(metadata_);
+        metadata_ = NULL;
+    }
+
+    if (stmt_ != NULL)
+    {
+        mysql_stmt_close(stmt_);
+        stmt_ = NULL;
+    }
+}
+
 void mysql_statement_backend::prepare(std::string const & query,
-    statement_type /* eType */)
+    statement_type eType)
 {
+    close_prepared();
+
     queryChunks_.clear();
+    names_.clear();
     enum { eNormal, eInQuotes, eInName } state = eNormal;
 
     std::string name;
@@ -109,6 +157,15 @@ void mysql_statement_backend::prepare(std::string const & query,
     {
         names_.push_back(name);
     }
+
+    find_values_tuple();
+
+    // preparing the one-time queries would only add the round trips for
+    // preparing and closing them, so send them as text
+    if (session_.preparedStatements_ && eType == st_repeatable_query)
+    {
+        prepare_statement();
+    }
 /*
   cerr << "Chunks: ";
   for (std::vector<std::string>::iterator i = queryChunks_.begin();
@@ -126,9 +183,473 @@ void mysql_statement_backend::prepare(std::string const & query,
 */
 }
 
+void mysql_statement_backend::find_values_tuple()
+{
+    bulkInsertPrefix_ = 0;
+    bulkInsertSuffix_ = 0;
+
+    if (names_.empty())
+    {
+        return;
+    }
+
+    // Work with the query template in which the parameters are replaced by
+    // placeholders: the values substituted for them can't change its
+    // structure, as they are quoted.
+    std::string query;
+    for (std::size_t i = 0; i != queryChunks_.size(); ++i)
+    {
+        query += queryChunks_[i];
+        if (i < names_.size())
+        {
+            query += '?';
+        }
+    }
+
+    std::string lower(query);
+    for (std::string::iterator it = lower.begin(); it != lower.end(); ++it)
+    {
+        *it = static_cast<char>(
+            std::tolower(static_cast<unsigned char>(*it)));
+    }
+
+    std::size_t pos = lower.find_first_not_of(" \t\r\n");
+    if (pos == std::string::npos or
+        (lower.compare(pos, 7, "insert ") != 0 and
+         lower.compare(pos, 8, "replace ") != 0))
+    {
+        return;
+    }
+
+    // Find the VALUES keyword followed by the opening parenthesis outside of
+    // the quoted strings and identifiers, as a separate word.
+    std::size_t start = std::string::npos;
+    char quote = '\0';
+    for (std::size_t i = pos; i != lower.size(); ++i)
+    {
+        char const c = lower[i];
+        if (quote != '\0')
+        {
+            if (c == '\\' and quote != '`')
+            {
+                ++i;
+            }
+            else if (c == quote)
+            {
+                quote = '\0';
+            }
+        }
+        else if (c == '\'' or c == '"' or c == '`')
+        {
+            quote = c;
+        }
+        else if (lower.compare(i, 6, "values") == 0 and
+            (i == 0 or not (std::isalnum(static_cast<unsigned char>(lower[i - 1]))
+                            or lower[i - 1] == '_')))
+        {
+            std::size_t const paren = lower.find_first_not_of(" \t\r\n", i + 6);
+            if (paren != std::string::npos and lower[paren] == '(')
+            {
+                start = paren;
+            }
+            break;
+        }
+    }
+
+    // The values must not depend on the parameters as they are sent only
+    // once for all the rows.
+    if (start == std::string::npos or start > queryChunks_.front().size())
+    {
+        return;
+    }
+
+    // The tuple must be the end of the statement, i.e. there must be no ON
+    // DUPLICATE KEY UPDATE or anything else after it.
+    std::size_t end = std::string::npos;
+    int depth = 0;
+    quote = '\0';
+    for (std::size_t i = start; i != lower.size(); ++i)
+    {
+        char const c = lower[i];
+        if (quote != '\0')
+        {
+            if (c == '\\' and quote != '`')
+            {
+                ++i;
+            }
+            else if (c == quote)
+            {
+                quote = '\0';
+            }
+        }
+        else if (c == '\'' or c == '"' or c == '`')
+        {
+            quote = c;
+        }
+        else if (c == '(')
+        {
+            ++depth;
+        }
+        else if (c == ')' and --depth == 0)
+        {
+            end = i + 1;
+            break;
+        }
+    }
+
+    if (end == std::string::npos or
+        lower.find_first_not_of(" \t\r\n;", end) != std::string::npos)
+    {
+        return;
+    }
+
+    bulkInsertPrefix_ = start;
+    bulkInsertSuffix_ = lower.size() - end;
+}
+
+void mysql_statement_backend::prepare_statement()
+{
+    // replace the named parameters with the positional placeholders
+    std::string query;
+    for (std::size_t i = 0; i != queryChunks_.size(); ++i)
+    {
+        query += queryChunks_[i];
+        if (i < names_.size())
+        {
+            query += '?';
+        }
+    }
+
+    stmt_ = mysql_stmt_init(session_.conn_);
+    if (stmt_ == NULL)
+    {
+        throw mysql_soci_error(mysql_error(session_.conn_),
+            mysql_errno(session_.conn_));
+    }
+
+    if (0 != mysql_stmt_prepare(stmt_, query.c_str(),
+            static_cast<unsigned long>(query.size())))
+    {
+        std::string const errMsg = mysql_stmt_error(stmt_);
+        unsigned int const errNum = mysql_stmt_errno(stmt_);
+
+        close_prepared();
+
+        // some statements can only be executed as plain queries, just fall
+        // back to doing it for them
+        if (errNum != unsupported_prepared_statement)
+        {
+            throw mysql_soci_error(errMsg, errNum);
+        }
+    }
+}
+
+statement_backend::exec_fetch_result
+mysql_statement_backend::execute_prepared(int number)
+{
+    rowsAffectedBulk_ = -1;
+    mysql_stmt_free_result(stmt_);
+
+    if (number > 1 && hasIntoElements_)
+    {
+         throw soci_error(
+              "Bulk use with single into elements is not supported.");
+    }
+
+    if (not useByPosBinds_.empty() and not useByNameBinds_.empty())
+    {
+        throw soci_error(
+            "Binding for use elements must be either by position "
+            "or by name.");
+    }
+
+    // number of loops to perform, as for the plain queries
+    int numberOfExecutions = 1;
+    if (number > 0 and not hasUseElements_)
+    {
+        numberOfExecutions = number;
+    }
+
+    std::size_t const paramCount = mysql_stmt_param_count(stmt_);
+    bool const hasUses
+        = not useByPosBinds_.empty() or not useByNameBinds_.empty();
+    if (hasUses != (paramCount != 0))
+    {
+        throw soci_error("Wrong number of parameters.");
+    }
+    if (not hasUses)
+    {
+        numberOfExecutions = 1;
+    }
+
+    params_.resize(paramCount);
+
+    long long rowsAffectedBulkTemp = 0;
+    for (int i = 0; i != numberOfExecutions; ++i)
+    {
+        if (paramCount != 0)
+        {
+            std::size_t n = 0;
+            if (not useByPosBinds_.empty())
+            {
+                // use elements bind by position, in the natural order of
+                // the map
+                if (useByPosBinds_.size() != paramCount)
+                {
+                    throw soci_error("Wrong number of parameters.");
+                }
+
+                for (UseByPosBindsMap::iterator
+                         it = useByPosBinds_.begin(),
+                         end = useByPosBinds_.end();
+                     it != end; ++it, ++n)
+                {
+                    params_[n] = it->second[i];
+                }
+            }
+            else
+            {
+                // use elements bind by name, the same element may be used
+                // for more than one placeholder
+                if (names_.size() != paramCount)
+                {
+                    throw soci_error("Wrong number of parameters.");
+                }
+
+                for (std::vector<std::string>::iterator
+                         it = names_.begin(), end = names_.end();
+                     it != end; ++it, ++n)
+                {
+                    UseByNameBindsMap::iterator b = useByNameBinds_.find(*it);
+                    if (b == useByNameBinds_.end())
+                    {
+                        std::string msg(
+                            "Missing use element for bind by name (");
+                        msg += *it;
+                        msg += ").";
+                        throw soci_error(msg);
+                    }
+                    params_[n] = b->second[i];
+                }
+            }
+
+            if (0 != mysql_stmt_bind_param(stmt_, &params_[0]))
+            {
+                rowsAffectedBulk_ = rowsAffectedBulkTemp;
+                throw mysql_soci_error(mysql_stmt_error(stmt_),
+                    mysql_stmt_errno(stmt_));
+            }
+        }
+
+        if (0 != mysql_stmt_execute(stmt_))
+        {
+            // preserve the number of rows affected so far.
+            if (numberOfExecutions > 1)
+            {
+                rowsAffectedBulk_ = rowsAffectedBulkTemp;
+            }
+            throw mysql_soci_error(mysql_stmt_error(stmt_),
+                mysql_stmt_errno(stmt_));
+        }
+
+        if (numberOfExecutions > 1)
+        {
+            if (mysql_stmt_field_count(stmt_) != 0)
+            {
+                rowsAffectedBulk_ = rowsAffectedBulkTemp;
+                throw soci_error("The query shouldn't have returned"
+                    " any data but it did.");
+            }
+
+            rowsAffectedBulkTemp +=
+                static_cast<long long>(mysql_stmt_affected_rows(stmt_));
+        }
+    }
+
+    if (numberOfExecutions > 1)
+    {
+        // bulk
+        rowsAffectedBulk_ = rowsAffectedBulkTemp;
+        return ef_no_data;
+    }
+
+    unsigned int const columns = mysql_stmt_field_count(stmt_);
+    if (columns == 0)
+    {
+        // it was not a SELECT
+        return ef_no_data;
+    }
+
+    // Unless streaming, bring the entire result set to the client, as the
+    // plain queries do, to know the number of rows and to allow executing
+    // other statements before this one is completely fetched.
+    streaming_ = streamResults_;
+    streamEnd_ = false;
+    if (not streaming_ and 0 != mysql_stmt_store_result(stmt_))
+    {
+        throw mysql_soci_error(mysql_stmt_error(stmt_),
+            mysql_stmt_errno(stmt_));
+    }
+
+    // the columns without into elements are skipped when fetching the rows
+    results_.resize(columns);
+    std::memset(&results_[0], 0, columns * sizeof(MYSQL_BIND));
+    for (std::size_t i = 0; i != columns; ++i)
+    {
+        results_[i].buffer_type = MYSQL_TYPE_NULL;
+    }
+
+    currentRow_ = 0;
+    rowsToConsume_ = 0;
+
+    if (streaming_)
+    {
+        // the number of rows is unknown until all of them are read
+        numberOfRows_ = 0;
+        return number > 0 ? fetch_prepared(number) : ef_success;
+    }
+
+    numberOfRows_ = static_cast<int>(mysql_stmt_num_rows(stmt_));
+    if (numberOfRows_ == 0)
+    {
+        return ef_no_data;
+    }
+    else if (number > 0)
+    {
+        return fetch_prepared(number);
+    }
+    else
+    {
+        // execute(0) was meant to only perform the query
+        return ef_success;
+    }
+}
+
+statement_backend::exec_fetch_result
+mysql_statement_backend::fetch_prepared(int number)
+{
+    // forward the "cursor" from the last fetch
+    currentRow_ += rowsToConsume_;
+
+    if (streaming_ and not streamEnd_)
+    {
+        // try to read as many rows as requested, the actual number of them
+        // is updated below if the end of the rowset is reached
+        numberOfRows_ = currentRow_ + number;
+    }
+
+    if (currentRow_ >= numberOfRows_)
+    {
+        // all rows were already consumed
+        rowsToConsume_ = 0;
+        return ef_no_data;
+    }
+
+    rowsToConsume_ = numberOfRows_ - currentRow_;
+    if (rowsToConsume_ > number)
+    {
+        rowsToConsume_ = number;
+    }
+
+    // Unlike with plain queries, the rows are really fetched here, directly
+    // into the user's buffers: the standard into elements are always bound
+    // to the same variables but the vector ones need to be rebound to the
+    // next element for each row.
+    for (int i = 0; i != rowsToConsume_; ++i)
+    {
+        if (i == 0 or not vectorIntos_.empty())
+        {
+            for (std::size_t n = 0; n != intos_.size(); ++n)
+            {
+                mysql_standard_into_type_backend * const into = intos_[n];
+                if (into->position_ > static_cast<int>(results_.size()))
+                {
+                    throw soci_error("Into element position is out of range.");
+                }
+                into->bind_result(results_[into->position_ - 1]);
+            }
+            for (std::size_t n = 0; n != vectorIntos_.size(); ++n)
+            {
+                mysql_vector_into_type_backend * const into = vectorIntos_[n];
+                if (into->position_ > static_cast<int>(results_.size()))
+                {
+                    throw soci_error("Into element position is out of range.");
+                }
+                into->bind_result(results_[into->position_ - 1], i);
+            }
+
+            if (0 != mysql_stmt_bind_result(stmt_, &results_[0]))
+            {
+                throw mysql_soci_error(mysql_stmt_error(stmt_),
+                    mysql_stmt_errno(stmt_));
+            }
+        }
+
+        int const res = mysql_stmt_fetch(stmt_);
+        if (res == 1)
+        {
+            throw mysql_soci_error(mysql_stmt_error(stmt_),
+                mysql_stmt_errno(stmt_));
+        }
+        else if (res == MYSQL_NO_DATA)
+        {
+            if (not streaming_)
+            {
+                throw soci_error("Unexpected end of the result set.");
+            }
+
+            streamEnd_ = true;
+            rowsToConsume_ = i;
+            numberOfRows_ = currentRow_ + i;
+            break;
+        }
+
+        // MYSQL_DATA_TRUNCATED is expected for the strings, whose data is
+        // retrieved now, while the other columns check for it themselves.
+        for (std::size_t n = 0; n != intos_.size(); ++n)
+        {
+            intos_[n]->fetch_result();
+        }
+        for (std::size_t n = 0; n != vectorIntos_.size(); ++n)
+        {
+            vectorIntos_[n]->fetch_result(i);
+        }
+    }
+
+    // this simulates the behaviour of Oracle, see fetch()
+    return rowsToConsume_ < number ? ef_no_data : ef_success;
+}
+
+void mysql_statement_backend::execute_bulk_query(std::string const & query,
+    long long & rowsAffectedBulkTemp)
+{
+    if (0 != mysql_real_query(session_.conn_, query.c_str(),
+            static_cast<unsigned long>(query.size())))
+    {
+        // preserve the number of rows affected so far.
+        rowsAffectedBulk_ = rowsAffectedBulkTemp;
+        throw mysql_soci_error(mysql_error(session_.conn_),
+            mysql_errno(session_.conn_));
+    }
+    else
+    {
+        rowsAffectedBulkTemp += static_cast<long long>(mysql_affected_rows(session_.conn_));
+    }
+    if (mysql_field_count(session_.conn_) != 0)
+    {
+        throw soci_error("The query shouldn't have returned"
+            " any data but it did.");
+    }
+}
+
 statement_backend::exec_fetch_result
 mysql_statement_backend::execute(int number)
 {
+    if (stmt_ != NULL)
+    {
+        return execute_prepared(number);
+    }
+
     if (justDescribed_ == false)
     {
         clean_up();
@@ -155,6 +676,19 @@ mysql_statement_backend::execute(int number)
                     "Binding for use elements must be either by position "
                     "or by name.");
             }
+            // Simple inserts of many rows are combined into multi-row
+            // inserts, each of them limited by the maximal packet size
+            // accepted by the server (minus some margin for the protocol).
+            bool const multiRowInsert = numberOfExecutions > 1
+                and bulkInsertPrefix_ != 0 and session_.multiRowInserts_;
+            std::size_t maxQuerySize = 0;
+            if (multiRowInsert)
+            {
+                maxQuerySize = session_.get_max_allowed_packet();
+                maxQuerySize -= maxQuerySize > 2048 ? 1024 : 0;
+            }
+            std::string batch;
+
             long long rowsAffectedBulkTemp = 0;
             for (int i = 0; i != numberOfExecutions; ++i)
             {
@@ -223,26 +757,43 @@ mysql_statement_backend::execute(int number)
                 {
                     // bulk operation
                     //std::cerr << "bulk operation:\n" << query << std::endl;
-                    if (0 != mysql_real_query(session_.conn_, query.c_str(),
-                            query.size()))
+                    if (multiRowInsert)
                     {
-                        // preserve the number of rows affected so far.
-                        rowsAffectedBulk_ = rowsAffectedBulkTemp;
-                        throw mysql_soci_error(mysql_error(session_.conn_),
-                            mysql_errno(session_.conn_));
+                        // append the values tuple of this row to the
+                        // current multi-row insert, sending it first if
+                        // it would become too big
+                        std::size_t const tupleLength = query.size()
+                            - bulkInsertPrefix_ - bulkInsertSuffix_;
+                        if (not batch.empty() and
+                            batch.size() + 1 + tupleLength > maxQuerySize)
+                        {
+                            execute_bulk_query(batch, rowsAffectedBulkTemp);
+                            batch.clear();
+                        }
+
+                        if (batch.empty())
+                        {
+                            batch.assign(query, 0,
+                                bulkInsertPrefix_ + tupleLength);
+                        }
+                        else
+                        {
+                            batch += ',';
+                            batch.append(query, bulkInsertPrefix_,
+                                tupleLength);
+                        }
                     }
                     else
                     {
-                        rowsAffectedBulkTemp += static_cast<long long>(mysql_affected_rows(session_.conn_));
-                    }
-                    if (mysql_field_count(session_.conn_) != 0)
-                    {
-                        throw soci_error("The query shouldn't have returned"
-                            " any data but it did.");
+                        execute_bulk_query(query, rowsAffectedBulkTemp);
                     }
                     query.clear();
                 }
             }
+            if (not batch.empty())
+            {
+                execute_bulk_query(batch, rowsAffectedBulkTemp);
+            }
             rowsAffectedBulk_ = rowsAffectedBulkTemp;
             if (numberOfExecutions > 1)
             {
@@ -262,13 +813,21 @@ mysql_statement_backend::execute(int number)
             throw mysql_soci_error(mysql_error(session_.conn_),
                 mysql_errno(session_.conn_));
         }
-        result_ = mysql_store_result(session_.conn_);
+        streaming_ = streamResults_;
+        streamEnd_ = false;
+        result_ = streaming_ ? mysql_use_result(session_.conn_)
+                             : mysql_store_result(session_.conn_);
         if (result_ == NULL and mysql_field_count(session_.conn_) != 0)
         {
+            streaming_ = false;
             throw mysql_soci_error(mysql_error(session_.conn_),
                 mysql_errno(session_.conn_));
         }
-        if (result_ != NULL)
+        if (result_ == NULL)
+        {
+            streaming_ = false;
+        }
+        else if (not streaming_)
         {
             // Cache the rows offsets to have random access to the rows later.
             // [mysql_data_seek() is O(n) so we don't want to use it].
@@ -286,7 +845,16 @@ mysql_statement_backend::execute(int number)
         justDescribed_ = false;
     }
 
-    if (result_ != NULL)
+    if (result_ != NULL and streaming_)
+    {
+        // the number of rows is unknown until all of them are read
+        currentRow_ = 0;
+        rowsToConsume_ = 0;
+        numberOfRows_ = 0;
+
+        return number > 0 ? fetch(number) : ef_success;
+    }
+    else if (result_ != NULL)
     {
         currentRow_ = 0;
         rowsToConsume_ = 0;
@@ -317,6 +885,91 @@ mysql_statement_backend::execute(int number)
     }
 }
 
+statement_backend::exec_fetch_result
+mysql_statement_backend::fetch_streamed(int number)
+{
+    // The rows are read from the server only now and, as they remain valid
+    // only until the next one is read, the values of the rows to consume
+    // are copied, so that no more than the fetch size of them is kept.
+    currentRow_ += rowsToConsume_;
+    rowsToConsume_ = 0;
+
+    streamData_.clear();
+    streamOffsets_.clear();
+    streamLengths_.clear();
+
+    unsigned int const columns = mysql_num_fields(result_);
+    while (rowsToConsume_ < number and not streamEnd_)
+    {
+        MYSQL_ROW row = mysql_fetch_row(result_);
+        if (row == NULL)
+        {
+            // either the end of the rowset or an error
+            streamEnd_ = true;
+            if (mysql_errno(session_.conn_) != 0)
+            {
+                throw mysql_soci_error(mysql_error(session_.conn_),
+                    mysql_errno(session_.conn_));
+            }
+            break;
+        }
+
+        unsigned long const *lengths = mysql_fetch_lengths(result_);
+        for (unsigned int i = 0; i != columns; ++i)
+        {
+            if (row[i] == NULL)
+            {
+                streamOffsets_.push_back(std::string::npos);
+                streamLengths_.push_back(0);
+            }
+            else
+            {
+                streamOffsets_.push_back(streamData_.size());
+                streamLengths_.push_back(lengths[i]);
+                streamData_.insert(streamData_.end(),
+                    row[i], row[i] + lengths[i]);
+                streamData_.push_back('\0');
+            }
+        }
+
+        ++rowsToConsume_;
+    }
+
+    numberOfRows_ = currentRow_ + rowsToConsume_;
+
+    // this simulates the behaviour of Oracle, see fetch()
+    return rowsToConsume_ < number ? ef_no_data : ef_success;
+}
+
+char const * mysql_statement_backend::get_value(int row, int pos,
+    unsigned long & length)
+{
+    if (streaming_)
+    {
+        // only the rows of the current batch are available
+        std::size_t const i = (row - currentRow_) * mysql_num_fields(result_)
+            + pos;
+        if (streamOffsets_[i] == std::string::npos)
+        {
+            return NULL;
+        }
+
+        length = streamLengths_[i];
+        return &streamData_[streamOffsets_[i]];
+    }
+
+    //mysql_data_seek(result_, row);
+    mysql_row_seek(result_, resultRowOffsets_[row]);
+    MYSQL_ROW values = mysql_fetch_row(result_);
+    if (values[pos] == NULL)
+    {
+        return NULL;
+    }
+
+    length = mysql_fetch_lengths(result_)[pos];
+    return values[pos];
+}
+
 statement_backend::exec_fetch_result
 mysql_statement_backend::fetch(int number)
 {
@@ -326,6 +979,16 @@ mysql_statement_backend::fetch(int number)
     // in the postFetch functions, called for each into element.
     // Here, we only prepare for this to happen (to emulate "the Oracle way").
 
+    if (stmt_ != NULL)
+    {
+        return fetch_prepared(number);
+    }
+
+    if (streaming_)
+    {
+        return fetch_streamed(number);
+    }
+
     // forward the "cursor" from the last fetch
     currentRow_ += rowsToConsume_;
 
@@ -359,6 +1022,10 @@ long long mysql_statement_backend::get_affected_rows()
     {
         return rowsAffectedBulk_;
     }
+    if (stmt_ != NULL)
+    {
+        return static_cast<long long>(mysql_stmt_affected_rows(stmt_));
+    }
     return static_cast<long long>(mysql_affected_rows(session_.conn_));
 }
 
@@ -367,6 +1034,27 @@ int mysql_statement_backend::get_number_of_rows()
     return numberOfRows_ - currentRow_;
 }
 
+void mysql_statement_backend::remove_use_bind(int position,
+    std::string const &name, MYSQL_BIND *bind)
+{
+    if (position > 0)
+    {
+        UseByPosBindsMap::iterator const it = useByPosBinds_.find(position);
+        if (it != useByPosBinds_.end() and it->second == bind)
+        {
+            useByPosBinds_.erase(it);
+        }
+    }
+    else
+    {
+        UseByNameBindsMap::iterator const it = useByNameBinds_.find(name);
+        if (it != useByNameBinds_.end() and it->second == bind)
+        {
+            useByNameBinds_.erase(it);
+        }
+    }
+}
+
 std::string mysql_statement_backend::rewrite_for_procedure_call(
     std::string const &query)
 {
@@ -377,7 +1065,20 @@ std::string mysql_statement_backend::rewrite_for_procedure_call(
 
 int mysql_statement_backend::prepare_for_describe()
 {
-    execute(1);
+    if (stmt_ != NULL)
+    {
+        // the metadata is available without executing the statement
+        if (metadata_ == NULL)
+        {
+            metadata_ = mysql_stmt_result_metadata(stmt_);
+        }
+
+        return metadata_ != NULL ? mysql_num_fields(metadata_) : 0;
+    }
+
+    // don't consume the first row when streaming, as it couldn't be fetched
+    // again by the following execute()
+    execute(streamResults_ ? 0 : 1);
     justDescribed_ = true;
 
     int columns = mysql_field_count(session_.conn_);
@@ -388,7 +1089,8 @@ void mysql_statement_backend::describe_column(int colNum,
     data_type & type, std::string & columnName)
 {
     int pos = colNum - 1;
-    MYSQL_FIELD *field = mysql_fetch_field_direct(result_, pos);
+    MYSQL_FIELD *field = mysql_fetch_field_direct(
+        stmt_ != NULL ? metadata_ : result_, pos);
     switch (field->type)
     {
     case FIELD_TYPE_CHAR:       //MYSQL_TYPE_TINY:
@@ -10,6 +10,7 @@
 #include "soci/mysql/soci-mysql.h"
 #include "common.h"
 #include "soci/soci-platform.h"
+#include <algorithm>
 #include <ciso646>
 #include <cstdlib>
 
@@ -28,6 +29,8 @@ void mysql_vector_into_type_backend::define_by_pos(
     data_ = data;
     type_ = type;
     position_ = position++;
+
+    statement_.vectorIntos_.push_back(this);
 }
 
 void mysql_vector_into_type_backend::pre_fetch()
@@ -52,7 +55,27 @@ void set_invector_(void *p, int indx, T const &val)
 
 void mysql_vector_into_type_backend::post_fetch(bool gotData, indicator *ind)
 {
-    if (gotData)
+    if (gotData && statement_.stmt_ != NULL)
+    {
+        // the values were already stored by fetch_result()
+        for (int i = 0; i != statement_.rowsToConsume_; ++i)
+        {
+            if (states_[i].isNull_)
+            {
+                if (ind == NULL)
+                {
+                    throw soci_error(
+                        "Null value fetched and no indicator defined.");
+                }
+                ind[i] = i_null;
+            }
+            else if (ind != NULL)
+            {
+                ind[i] = i_ok;
+            }
+        }
+    }
+    else if (gotData)
     {
         // Here, rowsToConsume_ in the Statement object designates
         // the number of rows that need to be put in the user's buffers.
@@ -62,15 +85,15 @@ void mysql_vector_into_type_backend::post_fetch(bool gotData, indicator *ind)
 
         int const endRow = statement_.currentRow_ + statement_.rowsToConsume_;
 
-        //mysql_data_seek(statement_.result_, statement_.currentRow_);
-        mysql_row_seek(statement_.result_,
-            statement_.resultRowOffsets_[statement_.currentRow_]);
         for (int curRow = statement_.currentRow_, i = 0;
              curRow != endRow; ++curRow, ++i)
         {
-            MYSQL_ROW row = mysql_fetch_row(statement_.result_);
+            // buffer with data retrieved from server, in text format
+            unsigned long length = 0;
+            const char *buf = statement_.get_value(curRow, pos, length);
+
             // first, deal with indicators
-            if (row[pos] == NULL)
+            if (buf == NULL)
             {
                 if (ind == NULL)
                 {
@@ -91,9 +114,6 @@ void mysql_vector_into_type_backend::post_fetch(bool gotData, indicator *ind)
                 }
             }
 
-            // buffer with data retrieved from server, in text format
-            const char *buf = row[pos] != NULL ? row[pos] : "";
-
             switch (type_)
             {
             case x_char:
@@ -101,15 +121,13 @@ void mysql_vector_into_type_backend::post_fetch(bool gotData, indicator *ind)
                 break;
             case x_stdstring:
                 {
-                    unsigned long * lengths =
-                        mysql_fetch_lengths(statement_.result_);
                     // Not sure if it's necessary, but the code below is used
                     // instead of
-                    // set_invector_(data_, i, std::string(buf, lengths[pos]);
+                    // set_invector_(data_, i, std::string(buf, length);
                     // to avoid copying the (possibly large) temporary string.
                     std::vector<std::string> *dest =
                         static_cast<std::vector<std::string> *>(data_);
-                    (*dest)[i].assign(buf, lengths[pos]);
+                    (*dest)[i].assign(buf, length);
                 }
                 break;
             case x_short:
@@ -227,5 +245,24 @@ std::size_t mysql_vector_into_type_backend::size()
 
 void mysql_vector_into_type_backend::clean_up()
 {
-    // nothing to do here
+    std::vector<mysql_vector_into_type_backend *> &intos
+        = statement_.vectorIntos_;
+    intos.erase(std::remove(intos.begin(), intos.end(), this), intos.end());
+}
+
+void mysql_vector_into_type_backend::bind_result(MYSQL_BIND &bind, int row)
+{
+    if (row == 0)
+    {
+        states_.resize(size());
+    }
+
+    mysql::bind_result(bind, vector_element(data_, type_, row), type_,
+        states_[row]);
+}
+
+void mysql_vector_into_type_backend::fetch_result(int row)
+{
+    mysql::fetch_result(statement_.stmt_, position_ - 1,
+        vector_element(data_, type_, row), type_, states_[row]);
 }
@@ -50,6 +50,38 @@ void mysql_vector_use_type_backend::bind_by_name(
 void mysql_vector_use_type_backend::pre_use(indicator const *ind)
 {
     std::size_t const vsize = size();
+
+    if (statement_.stmt_ != NULL)
+    {
+        // the values are sent directly from the elements of the vector
+        binds_.resize(vsize);
+        times_.resize(vsize);
+        for (std::size_t i = 0; i != vsize; ++i)
+        {
+            if (ind != NULL && ind[i] == i_null)
+            {
+                std::memset(&binds_[i], 0, sizeof(binds_[i]));
+                binds_[i].buffer_type = MYSQL_TYPE_NULL;
+            }
+            else
+            {
+                bind_param(binds_[i], vector_element(data_, type_, i), type_,
+                    times_[i]);
+            }
+        }
+
+        if (position_ > 0)
+        {
+            statement_.useByPosBinds_[position_] = &binds_[0];
+        }
+        else
+        {
+            statement_.useByNameBinds_[name_] = &binds_[0];
+        }
+
+        return;
+    }
+
     for (size_t i = 0; i != vsize; ++i)
     {
         char *buf;
@@ -213,6 +245,11 @@ std::size_t mysql_vector_use_type_backend::size()
 
 void mysql_vector_use_type_backend::clean_up()
 {
+    if (binds_.empty() == false)
+    {
+        statement_.remove_use_bind(position_, name_, &binds_[0]);
+    }
+
     std::size_t const bsize = buffers_.size();
     for (std::size_t i = 0; i != bsize; ++i)
     {
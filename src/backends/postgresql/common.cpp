@@ -7,8 +7,13 @@
 
 #include "soci/soci-platform.h"
 #include "soci/soci-backend.h"
+#include "soci-cstrtod.h"
+#include <cmath>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
+#include <limits>
+#include <string>
 #include "common.h"
 
 namespace // anonymous
@@ -29,6 +34,577 @@ long parse10(char const * & p1, char * & p2, char const * msg)
     }
 }
 
+// fill std::tm with the given broken down date and time values
+void set_std_tm(long year, long month, long day,
+    long hour, long minute, long second, std::tm & t)
+{
+    t.tm_isdst = -1;
+    t.tm_year = year - 1900;
+    t.tm_mon  = month - 1;
+    t.tm_mday = day;
+    t.tm_hour = hour;
+    t.tm_min  = minute;
+    t.tm_sec  = second;
+
+    std::mktime(&t);
+}
+
+// Binary format support.
+//
+// See the corresponding *_send() functions in PostgreSQL sources for the
+// description of the binary representation of the different types.
+
+// type OIDs, from pg_type
+unsigned long const oid_bool = 16;
+unsigned long const oid_bytea = 17;
+unsigned long const oid_char = 18;
+unsigned long const oid_name = 19;
+unsigned long const oid_int8 = 20;
+unsigned long const oid_int2 = 21;
+unsigned long const oid_int4 = 23;
+unsigned long const oid_text = 25;
+unsigned long const oid_oid = 26;
+unsigned long const oid_json = 114;
+unsigned long const oid_xml = 142;
+unsigned long const oid_float4 = 700;
+unsigned long const oid_float8 = 701;
+unsigned long const oid_unknown = 705;
+unsigned long const oid_bpchar = 1042;
+unsigned long const oid_varchar = 1043;
+unsigned long const oid_date = 1082;
+unsigned long const oid_time = 1083;
+unsigned long const oid_timestamp = 1114;
+unsigned long const oid_timestamptz = 1184;
+unsigned long const oid_interval = 1186;
+unsigned long const oid_numeric = 1700;
+unsigned long const oid_cstring = 2275;
+unsigned long const oid_uuid = 2950;
+unsigned long const oid_jsonb = 3802;
+
+// sign field values of numeric (infinities are sent since PostgreSQL 14)
+unsigned const numeric_pos = 0x0000;
+unsigned const numeric_neg = 0x4000;
+unsigned const numeric_nan = 0xC000;
+unsigned const numeric_pinf = 0xD000;
+unsigned const numeric_ninf = 0xF000;
+
+// version of the jsonb binary format, which is just the text after it
+char const jsonb_version = 1;
+
+// number of days between the Unix epoch and PostgreSQL one (2000-01-01)
+long long const postgresql_epoch_days = 10957;
+
+char const * const errMsgData = "Cannot convert data.";
+char const * const errMsgTm = "Cannot convert data to std::tm.";
+
+void check_length(int len, int expected, char const * msg)
+{
+    if (len != expected)
+    {
+        throw soci::soci_error(msg);
+    }
+}
+
+// read an unsigned integer of the given size in network byte order
+unsigned long long read_uint(char const * buf, int len)
+{
+    unsigned long long v = 0;
+    for (int i = 0; i != len; ++i)
+    {
+        v = (v << 8) | static_cast<unsigned char>(buf[i]);
+    }
+
+    return v;
+}
+
+short read_int16(char const * buf)
+{
+    return static_cast<short>(static_cast<unsigned short>(read_uint(buf, 2)));
+}
+
+int read_int32(char const * buf)
+{
+    return static_cast<int>(static_cast<unsigned int>(read_uint(buf, 4)));
+}
+
+long long read_int64(char const * buf)
+{
+    return static_cast<long long>(read_uint(buf, 8));
+}
+
+double read_float8(char const * buf)
+{
+    unsigned long long const bits = read_uint(buf, 8);
+    double d;
+    std::memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+float read_float4(char const * buf)
+{
+    unsigned int const bits = static_cast<unsigned int>(read_uint(buf, 4));
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+bool is_finite(double d)
+{
+    double const max = (std::numeric_limits<double>::max)();
+    return d >= -max && d <= max;
+}
+
+// division rounding towards minus infinity
+long long floor_div(long long a, long long b)
+{
+    long long q = a / b;
+    if (a % b < 0)
+    {
+        --q;
+    }
+
+    return q;
+}
+
+// check the numeric header and return the number of its base 10000 digits
+int read_numeric_header(char const * buf, int len, int & weight, bool & neg)
+{
+    if (len < 8)
+    {
+        throw soci::soci_error(errMsgData);
+    }
+
+    int const ndigits = read_int16(buf);
+    weight = read_int16(buf + 2);
+    unsigned const sign = static_cast<unsigned>(read_uint(buf + 4, 2));
+    if ((sign != numeric_pos && sign != numeric_neg) ||
+        ndigits < 0 || len != 8 + 2 * ndigits)
+    {
+        throw soci::soci_error(errMsgData);
+    }
+
+    neg = sign == numeric_neg;
+    return ndigits;
+}
+
+double numeric_to_double(char const * buf, int len)
+{
+    int weight;
+    bool neg;
+    int const ndigits = read_numeric_header(buf, len, weight, neg);
+
+    double v = 0;
+    for (int i = 0; i != ndigits; ++i)
+    {
+        v = v * 10000 + read_int16(buf + 8 + 2 * i);
+    }
+
+    v *= std::pow(10000.0, weight - ndigits + 1);
+
+    return neg ? -v : v;
+}
+
+long long numeric_to_long_long(char const * buf, int len)
+{
+    int weight;
+    bool neg;
+    int const ndigits = read_numeric_header(buf, len, weight, neg);
+
+    // trailing zero digits are never sent, so having more digits than the
+    // integer part contains means that there is a fractional part
+    if (ndigits > weight + 1)
+    {
+        throw soci::soci_error(errMsgData);
+    }
+
+    unsigned long long const max
+        = (std::numeric_limits<unsigned long long>::max)();
+
+    unsigned long long v = 0;
+    for (int i = 0; i <= weight; ++i)
+    {
+        unsigned const d = i < ndigits ? read_int16(buf + 8 + 2 * i) : 0;
+        if (v > (max - d) / 10000)
+        {
+            throw soci::soci_error(errMsgData);
+        }
+
+        v = v * 10000 + d;
+    }
+
+    unsigned long long const limit
+        = static_cast<unsigned long long>(
+            (std::numeric_limits<long long>::max)());
+    if (neg)
+    {
+        if (v > limit + 1)
+        {
+            throw soci::soci_error(errMsgData);
+        }
+
+        return v == limit + 1
+            ? (std::numeric_limits<long long>::min)()
+            : -static_cast<long long>(v);
+    }
+
+    if (v > limit)
+    {
+        throw soci::soci_error(errMsgData);
+    }
+
+    return static_cast<long long>(v);
+}
+
+bool is_text_type(unsigned long typeOid)
+{
+    switch (typeOid)
+    {
+    case oid_text:
+    case oid_varchar:
+    case oid_cstring:
+    case oid_char:
+    case oid_name:
+    case oid_bpchar:
+    case oid_xml:
+    case oid_json:
+    case oid_unknown:
+    case oid_bytea:
+        return true;
+    }
+
+    return false;
+}
+
+// read timestamp or time value as the number of microseconds
+long long read_time_usecs(char const * buf, int len, bool integerDatetimes)
+{
+    check_length(len, 8, errMsgTm);
+
+    if (integerDatetimes)
+    {
+        long long const usecs = read_int64(buf);
+        if (usecs == (std::numeric_limits<long long>::max)() ||
+            usecs == (std::numeric_limits<long long>::min)())
+        {
+            // infinity can't be represented by std::tm
+            throw soci::soci_error(errMsgTm);
+        }
+
+        return usecs;
+    }
+
+    double const secs = read_float8(buf);
+    if (!is_finite(secs))
+    {
+        throw soci::soci_error(errMsgTm);
+    }
+
+    return static_cast<long long>(std::floor(secs)) * 1000000;
+}
+
+// convert the number of days since the Unix epoch to the civil date
+void days_to_date(long long days, long & year, long & month, long & day)
+{
+    long long const z = days + 719468;
+    long long const era = floor_div(z, 146097);
+    long long const doe = z - era * 146097;
+    long long const yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    long long const doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    long long const mp = (5 * doy + 2) / 153;
+
+    day = static_cast<long>(doy - (153 * mp + 2) / 5 + 1);
+    month = static_cast<long>(mp < 10 ? mp + 3 : mp - 9);
+    year = static_cast<long>(yoe + era * 400 + (month <= 2 ? 1 : 0));
+}
+
+// Helpers for formatting the values received in binary format in the same
+// way as the server does it for the text format, using the default DateStyle
+// ("ISO") and IntervalStyle ("postgres").
+
+// append the number padded with zeros to the given width
+void append_padded(std::string & s, long long v, int width)
+{
+    char buf[32];
+    std::sprintf(buf, "%0*" LL_FMT_FLAGS "d", width, v);
+    s += buf;
+}
+
+// append the shortest representation of the floating point number which can
+// be converted back to the same value, the fixed point notation is used for
+// the exponents in [-4, maxFixedExp) range and the scientific one otherwise
+template <typename T>
+void append_float(std::string & s, T v, int maxPrecision, int maxFixedExp)
+{
+    if (!is_finite(v))
+    {
+        // NaN is neither less nor greater than anything
+        s += v < 0 ? "-Infinity" : v > 0 ? "Infinity" : "NaN";
+        return;
+    }
+
+    // the current locale is used consistently by both sprintf() and strtod()
+    // here, the decimal separator is replaced with the point below
+    char buf[64];
+    int precision = 1;
+    for (; precision != maxPrecision; ++precision)
+    {
+        std::sprintf(buf, "%.*e", precision - 1, static_cast<double>(v));
+        T const converted = static_cast<T>(std::strtod(buf, NULL));
+        if (!(converted < v) && !(v < converted))
+        {
+            break;
+        }
+    }
+
+    std::sprintf(buf, "%.*e", precision - 1, static_cast<double>(v));
+
+    int const exp = std::atoi(std::strchr(buf, 'e') + 1);
+    if (exp >= -4 && exp < maxFixedExp)
+    {
+        int const decimals = precision - 1 - exp;
+        std::sprintf(buf, "%.*f", decimals > 0 ? decimals : 0,
+            static_cast<double>(v));
+    }
+
+    char * const comma = std::strchr(buf, ',');
+    if (comma != NULL)
+    {
+        *comma = '.';
+    }
+
+    s += buf;
+}
+
+void append_numeric(std::string & s, char const * buf, int len)
+{
+    if (len >= 8)
+    {
+        switch (read_uint(buf + 4, 2))
+        {
+        case numeric_nan:
+            s += "NaN";
+            return;
+        case numeric_pinf:
+            s += "Infinity";
+            return;
+        case numeric_ninf:
+            s += "-Infinity";
+            return;
+        }
+    }
+
+    int weight;
+    bool neg;
+    int const ndigits = read_numeric_header(buf, len, weight, neg);
+    std::size_t const dscale = static_cast<std::size_t>(read_uint(buf + 6, 2));
+
+    if (neg)
+    {
+        s += '-';
+    }
+
+    if (weight < 0)
+    {
+        s += '0';
+    }
+
+    for (int i = 0; i <= weight; ++i)
+    {
+        int const d = i < ndigits ? read_int16(buf + 8 + 2 * i) : 0;
+        append_padded(s, d, i == 0 ? 1 : 4);
+    }
+
+    if (dscale != 0)
+    {
+        s += '.';
+
+        std::size_t const start = s.size();
+        for (int i = weight + 1; s.size() - start < dscale; ++i)
+        {
+            int const d = i >= 0 && i < ndigits
+                ? read_int16(buf + 8 + 2 * i)
+                : 0;
+            append_padded(s, d, 4);
+        }
+
+        s.resize(start + dscale);
+    }
+}
+
+// append the date given as the number of days since the PostgreSQL epoch,
+// returns true if it's BC, in which case the caller must append " BC"
+bool append_date(std::string & s, long long days)
+{
+    long year, month, day;
+    days_to_date(days + postgresql_epoch_days, year, month, day);
+
+    // there is no year 0, 1 BC comes immediately before 1 AD
+    bool const bc = year <= 0;
+
+    append_padded(s, bc ? 1 - year : year, 4);
+    s += '-';
+    append_padded(s, month, 2);
+    s += '-';
+    append_padded(s, day, 2);
+
+    return bc;
+}
+
+// append the (non-negative) time given as the number of microseconds, the
+// number of hours is not limited to 24 as this is also used for intervals
+void append_time(std::string & s, unsigned long long usecs)
+{
+    unsigned long long const secs = usecs / 1000000;
+
+    append_padded(s, static_cast<long long>(secs / 3600), 2);
+    s += ':';
+    append_padded(s, static_cast<long long>(secs / 60 % 60), 2);
+    s += ':';
+    append_padded(s, static_cast<long long>(secs % 60), 2);
+
+    long long fraction = static_cast<long long>(usecs % 1000000);
+    if (fraction != 0)
+    {
+        int digits = 6;
+        while (fraction % 10 == 0)
+        {
+            fraction /= 10;
+            --digits;
+        }
+
+        s += '.';
+        append_padded(s, fraction, digits);
+    }
+}
+
+void append_timestamp(std::string & s, char const * buf, int len,
+    bool integerDatetimes, bool withTimeZone)
+{
+    if (integerDatetimes && len == 8)
+    {
+        long long const usecs = read_int64(buf);
+        if (usecs == (std::numeric_limits<long long>::max)())
+        {
+            s += "infinity";
+            return;
+        }
+        if (usecs == (std::numeric_limits<long long>::min)())
+        {
+            s += "-infinity";
+            return;
+        }
+    }
+
+    long long const usecs = read_time_usecs(buf, len, integerDatetimes);
+    long long const days = floor_div(usecs, 86400000000LL);
+
+    bool const bc = append_date(s, days);
+    s += ' ';
+    append_time(s,
+        static_cast<unsigned long long>(usecs - days * 86400000000LL));
+
+    if (withTimeZone)
+    {
+        // timestamptz is always sent in UTC
+        s += "+00";
+    }
+
+    if (bc)
+    {
+        s += " BC";
+    }
+}
+
+// append a part of the interval, using the same rules as PostgreSQL
+// EncodeInterval() for its "postgres" style
+void append_interval_part(std::string & s, int value, char const * units,
+    bool & isZero, bool & isBefore)
+{
+    if (value == 0)
+    {
+        return;
+    }
+
+    if (!isZero)
+    {
+        s += ' ';
+    }
+
+    if (isBefore && value > 0)
+    {
+        s += '+';
+    }
+
+    append_padded(s, value, 1);
+    s += ' ';
+    s += units;
+    if (value != 1)
+    {
+        s += 's';
+    }
+
+    isBefore = value < 0;
+    isZero = false;
+}
+
+void append_interval(std::string & s, char const * buf, int len,
+    bool integerDatetimes)
+{
+    check_length(len, 16, errMsgData);
+
+    long long const usecs = integerDatetimes
+        ? read_int64(buf)
+        : static_cast<long long>(read_float8(buf) * 1000000);
+    int const days = read_int32(buf + 8);
+    int const months = read_int32(buf + 12);
+
+    bool isZero = true;
+    bool isBefore = false;
+    append_interval_part(s, months / 12, "year", isZero, isBefore);
+    append_interval_part(s, months % 12, "mon", isZero, isBefore);
+    append_interval_part(s, days, "day", isZero, isBefore);
+
+    if (isZero || usecs != 0)
+    {
+        if (!isZero)
+        {
+            s += ' ';
+        }
+
+        if (usecs < 0)
+        {
+            s += '-';
+        }
+        else if (isBefore)
+        {
+            s += '+';
+        }
+
+        // avoid overflow when negating the minimal value
+        append_time(s, usecs < 0
+            ? 0 - static_cast<unsigned long long>(usecs)
+            : static_cast<unsigned long long>(usecs));
+    }
+}
+
+void append_uuid(std::string & s, char const * buf, int len)
+{
+    check_length(len, 16, errMsgData);
+
+    char const * const hex = "0123456789abcdef";
+    for (int i = 0; i != 16; ++i)
+    {
+        if (i == 4 || i == 6 || i == 8 || i == 10)
+        {
+            s += '-';
+        }
+
+        unsigned char const c = static_cast<unsigned char>(buf[i]);
+        s += hex[c >> 4];
+        s += hex[c & 0xF];
+    }
+}
+
 } // namespace anonymous
 
 
@@ -81,13 +657,273 @@ void soci::details::postgresql::parse_std_tm(char const * buf, std::tm & t)
         }
     }
 
-    t.tm_isdst = -1;
-    t.tm_year = year - 1900;
-    t.tm_mon  = month - 1;
-    t.tm_mday = day;
-    t.tm_hour = hour;
-    t.tm_min  = minute;
-    t.tm_sec  = second;
+    set_std_tm(year, month, day, hour, minute, second, t);
+}
 
-    std::mktime(&t);
+bool soci::details::postgresql::is_binary_type_supported(
+    unsigned long typeOid)
+{
+    if (is_text_type(typeOid))
+    {
+        return true;
+    }
+
+    switch (typeOid)
+    {
+    case oid_bool:
+    case oid_int2:
+    case oid_int4:
+    case oid_int8:
+    case oid_oid:
+    case oid_float4:
+    case oid_float8:
+    case oid_numeric:
+    case oid_date:
+    case oid_time:
+    case oid_timestamp:
+    case oid_timestamptz:
+    case oid_interval:
+    case oid_uuid:
+    case oid_jsonb:
+        return true;
+    }
+
+    return false;
 }
+
+long long soci::details::postgresql::binary_to_long_long(
+    char const * buf, int len, unsigned long typeOid)
+{
+    // the values of the text types are parsed as in the text format, libpq
+    // always terminates them with NUL even in binary format
+    if (is_text_type(typeOid))
+    {
+        return string_to_integer<long long>(buf);
+    }
+
+    switch (typeOid)
+    {
+    case oid_bool:
+        check_length(len, 1, errMsgData);
+        return buf[0] != 0 ? 1 : 0;
+    case oid_int2:
+        check_length(len, 2, errMsgData);
+        return read_int16(buf);
+    case oid_int4:
+        check_length(len, 4, errMsgData);
+        return read_int32(buf);
+    case oid_int8:
+        check_length(len, 8, errMsgData);
+        return read_int64(buf);
+    case oid_oid:
+        check_length(len, 4, errMsgData);
+        return static_cast<long long>(read_uint(buf, 4));
+    case oid_numeric:
+        return numeric_to_long_long(buf, len);
+    }
+
+    throw soci_error(errMsgData);
+}
+
+double soci::details::postgresql::binary_to_double(
+    char const * buf, int len, unsigned long typeOid)
+{
+    if (is_text_type(typeOid))
+    {
+        return cstring_to_double(buf);
+    }
+
+    switch (typeOid)
+    {
+    case oid_float4:
+        check_length(len, 4, errMsgData);
+        return read_float4(buf);
+    case oid_float8:
+        check_length(len, 8, errMsgData);
+        return read_float8(buf);
+    case oid_int2:
+    case oid_int4:
+    case oid_int8:
+    case oid_oid:
+        return static_cast<double>(binary_to_long_long(buf, len, typeOid));
+    case oid_numeric:
+        return numeric_to_double(buf, len);
+    }
+
+    throw soci_error(errMsgData);
+}
+
+char soci::details::postgresql::binary_to_char(
+    char const * buf, int len, unsigned long typeOid, bool integerDatetimes)
+{
+    if (is_text_type(typeOid))
+    {
+        return len > 0 ? buf[0] : '\0';
+    }
+
+    // use the first character of the text representation, as in text format
+    std::string s;
+    binary_to_string(buf, len, typeOid, integerDatetimes, s);
+
+    return s.empty() ? '\0' : s[0];
+}
+
+void soci::details::postgresql::binary_to_string(
+    char const * buf, int len, unsigned long typeOid, bool integerDatetimes,
+    std::string & s)
+{
+    // the binary representation of all text types is just the text itself
+    // while for bytea it's the raw bytes instead of their escaped form used
+    // in the text format
+    if (is_text_type(typeOid))
+    {
+        s.assign(buf, len);
+        return;
+    }
+
+    // the other types are formatted as the server would do it
+    s.clear();
+
+    switch (typeOid)
+    {
+    case oid_bool:
+        check_length(len, 1, errMsgData);
+        s = buf[0] != 0 ? "t" : "f";
+        break;
+
+    case oid_int2:
+    case oid_int4:
+    case oid_int8:
+    case oid_oid:
+        append_padded(s, binary_to_long_long(buf, len, typeOid), 1);
+        break;
+
+    case oid_float4:
+        check_length(len, 4, errMsgData);
+        append_float(s, read_float4(buf), 9, 6);
+        break;
+
+    case oid_float8:
+        check_length(len, 8, errMsgData);
+        append_float(s, read_float8(buf), 17, 15);
+        break;
+
+    case oid_numeric:
+        append_numeric(s, buf, len);
+        break;
+
+    case oid_date:
+        {
+            check_length(len, 4, errMsgData);
+
+            int const days = read_int32(buf);
+            if (days == (std::numeric_limits<int>::max)())
+            {
+                s = "infinity";
+            }
+            else if (days == (std::numeric_limits<int>::min)())
+            {
+                s = "-infinity";
+            }
+            else if (append_date(s, days))
+            {
+                s += " BC";
+            }
+        }
+        break;
+
+    case oid_time:
+        append_time(s, static_cast<unsigned long long>(
+            read_time_usecs(buf, len, integerDatetimes)));
+        break;
+
+    case oid_timestamp:
+    case oid_timestamptz:
+        append_timestamp(s, buf, len, integerDatetimes,
+            typeOid == oid_timestamptz);
+        break;
+
+    case oid_interval:
+        append_interval(s, buf, len, integerDatetimes);
+        break;
+
+    case oid_uuid:
+        append_uuid(s, buf, len);
+        break;
+
+    case oid_jsonb:
+        if (len < 1 || buf[0] != jsonb_version)
+        {
+            throw soci_error(errMsgData);
+        }
+
+        s.assign(buf + 1, len - 1);
+        break;
+
+    default:
+        throw soci_error(errMsgData);
+    }
+}
+
+void soci::details::postgresql::binary_to_std_tm(
+    char const * buf, int len, unsigned long typeOid,
+    bool integerDatetimes, std::tm & t)
+{
+    if (is_text_type(typeOid))
+    {
+        parse_std_tm(buf, t);
+        return;
+    }
+
+    long year, month, day;
+
+    switch (typeOid)
+    {
+    case oid_date:
+        {
+            check_length(len, 4, errMsgTm);
+
+            int const days = read_int32(buf);
+            if (days == (std::numeric_limits<int>::max)() ||
+                days == (std::numeric_limits<int>::min)())
+            {
+                throw soci_error(errMsgTm);
+            }
+
+            days_to_date(days + postgresql_epoch_days, year, month, day);
+            set_std_tm(year, month, day, 0, 0, 0, t);
+        }
+        break;
+
+    case oid_timestamp:
+    case oid_timestamptz:
+        {
+            // timestamptz is always sent in UTC
+            long long const secs
+                = floor_div(read_time_usecs(buf, len, integerDatetimes),
+                    1000000);
+            long long const days = floor_div(secs, 86400);
+            long const secOfDay = static_cast<long>(secs - days * 86400);
+
+            days_to_date(days + postgresql_epoch_days, year, month, day);
+            set_std_tm(year, month, day,
+                secOfDay / 3600, secOfDay / 60 % 60, secOfDay % 60, t);
+        }
+        break;
+
+    case oid_time:
+        {
+            // leave the date part as 1900-01-01, as for the text format
+            long const secOfDay = static_cast<long>(
+                read_time_usecs(buf, len, integerDatetimes) / 1000000);
+
+            set_std_tm(1900, 1, 1,
+                secOfDay / 3600, secOfDay / 60 % 60, secOfDay % 60, t);
+        }
+        break;
+
+    default:
+        throw soci_error(errMsgTm);
+    }
+}
+
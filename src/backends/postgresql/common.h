@@ -13,6 +13,7 @@
 #include <cstdio>
 #include <cstring>
 #include <ctime>
+#include <string>
 #include <vector>
 
 namespace soci
@@ -115,6 +116,65 @@ T string_to_unsigned_integer(char const * buf)
 // helper function for parsing datetime values
 void parse_std_tm(char const * buf, std::tm & t);
 
+// helper functions for decoding the values received in binary format (see
+// postgresql_statement_backend::binaryResults_), they take the value length
+// and the column type as returned by PQgetlength() and PQftype()
+
+// check if the values of this type can be decoded by the functions below,
+// the results must be requested in text format otherwise
+bool is_binary_type_supported(unsigned long typeOid);
+
+long long binary_to_long_long(char const * buf, int len,
+    unsigned long typeOid);
+
+template <typename T>
+T binary_to_integer(char const * buf, int len, unsigned long typeOid)
+{
+    long long const t = binary_to_long_long(buf, len, typeOid);
+
+    const T max = (std::numeric_limits<T>::max)();
+    const T min = (std::numeric_limits<T>::min)();
+    if (t <= static_cast<long long>(max) &&
+        t >= static_cast<long long>(min))
+    {
+        return static_cast<T>(t);
+    }
+    else
+    {
+        // value out of target range
+        throw soci_error("Cannot convert data.");
+    }
+}
+
+template <typename T>
+T binary_to_unsigned_integer(char const * buf, int len,
+    unsigned long typeOid)
+{
+    long long const t = binary_to_long_long(buf, len, typeOid);
+
+    const T max = (std::numeric_limits<T>::max)();
+    if (t >= 0 && static_cast<unsigned long long>(t) <= max)
+    {
+        return static_cast<T>(t);
+    }
+    else
+    {
+        // value out of target range
+        throw soci_error("Cannot convert data.");
+    }
+}
+
+double binary_to_double(char const * buf, int len, unsigned long typeOid);
+
+char binary_to_char(char const * buf, int len, unsigned long typeOid,
+    bool integerDatetimes);
+
+void binary_to_string(char const * buf, int len, unsigned long typeOid,
+    bool integerDatetimes, std::string & s);
+
+void binary_to_std_tm(char const * buf, int len, unsigned long typeOid,
+    bool integerDatetimes, std::tm & t);
+
 // helper for vector operations
 template <typename T>
 std::size_t get_vector_size(void * p)
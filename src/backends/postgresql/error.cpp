@@ -10,6 +10,12 @@
 #include <cstring>
 #include <cassert>
 
+#ifdef SOCI_POSTGRESQL_NOPARAMS
+#ifndef SOCI_POSTGRESQL_NOSINGLEROWMODE
+#define SOCI_POSTGRESQL_NOSINGLEROWMODE
+#endif // SOCI_POSTGRESQL_NOSINGLEROWMODE
+#endif // SOCI_POSTGRESQL_NOPARAMS
+
 using namespace soci;
 using namespace soci::details;
 
@@ -44,6 +50,9 @@ details::postgresql_result::check_for_data(char const* errMsg) const
             return false;
 
         case PGRES_TUPLES_OK:
+#ifndef SOCI_POSTGRESQL_NOSINGLEROWMODE
+        case PGRES_SINGLE_TUPLE:
+#endif // SOCI_POSTGRESQL_NOSINGLEROWMODE
             return true;
 
         default:
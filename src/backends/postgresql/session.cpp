@@ -29,6 +29,12 @@
 using namespace soci;
 using namespace soci::details;
 
+char const * soci::postgresql_option_binary_results = "postgresql.binary_results";
+char const * soci::postgresql_option_stream_results = "postgresql.stream_results";
+char const * soci::postgresql_option_copy_bulk_inserts = "postgresql.copy_bulk_inserts";
+char const * soci::postgresql_option_pipeline_bulk_operations
+    = "postgresql.pipeline_bulk_operations";
+
 namespace // unnamed
 {
 
@@ -38,11 +44,41 @@ void hard_exec(PGconn * conn, char const * query, char const * errMsg)
     postgresql_result(PQexec(conn, query)).check_for_errors(errMsg);
 }
 
+// helper function for boolean options
+bool get_bool_option(connection_parameters const & parameters,
+    char const * name)
+{
+    std::string value;
+    if (parameters.get_option(name, value) == false || value == "0")
+    {
+        return false;
+    }
+
+    if (value != "1")
+    {
+        std::string msg = "Invalid value of \"";
+        msg += name;
+        msg += "\" option, \"0\" or \"1\" expected.";
+        throw soci_error(msg);
+    }
+
+    return true;
+}
+
 } // namespace unnamed
 
 postgresql_session_backend::postgresql_session_backend(
     connection_parameters const& parameters)
     : statementCount_(0)
+    , binaryResults_(get_bool_option(parameters,
+        postgresql_option_binary_results))
+    , streamResults_(get_bool_option(parameters,
+        postgresql_option_stream_results))
+    , copyBulkInserts_(get_bool_option(parameters,
+        postgresql_option_copy_bulk_inserts))
+    , pipelineBulkOperations_(get_bool_option(parameters,
+        postgresql_option_pipeline_bulk_operations))
+    , integerDatetimes_(true)
 {
     PGconn* conn = PQconnectdb(parameters.get_connect_string().c_str());
     if (0 == conn || CONNECTION_OK != PQstatus(conn))
@@ -68,6 +104,16 @@ postgresql_session_backend::postgresql_session_backend(
                          : "SET extra_float_digits = 2",
         "Cannot set extra_float_digits parameter");
 
+    // This parameter is reported by all servers since 8.0 and is "on" by
+    // default, only servers built with float timestamps (which are not
+    // supported at all since 10) report "off".
+    char const * const integerDatetimes
+        = PQparameterStatus(conn, "integer_datetimes");
+    if (integerDatetimes != NULL && std::strcmp(integerDatetimes, "off") == 0)
+    {
+        integerDatetimes_ = false;
+    }
+
     conn_ = conn;
 }
 
@@ -108,6 +154,28 @@ bool postgresql_session_backend::get_next_sequence_value(
     return true;
 }
 
+int postgresql_session_backend::get_socket()
+{
+    return PQsocket(conn_);
+}
+
+bool postgresql_session_backend::is_connected()
+{
+    // the status only reflects the result of the last operation, so send an
+    // empty query, which doesn't do anything on the server, to check it
+    if (PQstatus(conn_) != CONNECTION_OK)
+    {
+        return false;
+    }
+
+    PGresult * const result = PQexec(conn_, "");
+    bool const ok = result != NULL &&
+        PQresultStatus(result) == PGRES_EMPTY_QUERY;
+    PQclear(result);
+
+    return ok && PQstatus(conn_) == CONNECTION_OK;
+}
+
 void postgresql_session_backend::clean_up()
 {
     if (0 != conn_)
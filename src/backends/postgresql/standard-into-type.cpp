@@ -82,36 +82,74 @@ void postgresql_standard_into_type_backend::post_fetch(
             }
         }
 
-        // raw data, in text format
+        // raw data, in text or binary format
         char const * buf = PQgetvalue(statement_.result_,
             statement_.currentRow_, pos);
 
+        // the length and the type are only needed for the binary format
+        bool const binary = PQfformat(statement_.result_, pos) != 0;
+        int const len = PQgetlength(statement_.result_,
+            statement_.currentRow_, pos);
+        unsigned long const typeOid = PQftype(statement_.result_, pos);
+
         switch (type_)
         {
         case x_char:
-            exchange_type_cast<x_char>(data_) = *buf;
+            exchange_type_cast<x_char>(data_) = binary
+                ? binary_to_char(buf, len, typeOid,
+                    statement_.session_.integerDatetimes_)
+                : *buf;
             break;
         case x_stdstring:
-            exchange_type_cast<x_stdstring>(data_) = buf;
+            if (binary)
+            {
+                binary_to_string(buf, len, typeOid,
+                    statement_.session_.integerDatetimes_,
+                    exchange_type_cast<x_stdstring>(data_));
+            }
+            else
+            {
+                exchange_type_cast<x_stdstring>(data_) = buf;
+            }
             break;
         case x_short:
-            exchange_type_cast<x_short>(data_) = string_to_integer<short>(buf);
+            exchange_type_cast<x_short>(data_) = binary
+                ? binary_to_integer<short>(buf, len, typeOid)
+                : string_to_integer<short>(buf);
             break;
         case x_integer:
-            exchange_type_cast<x_integer>(data_) = string_to_integer<int>(buf);
+            exchange_type_cast<x_integer>(data_) = binary
+                ? binary_to_integer<int>(buf, len, typeOid)
+                : string_to_integer<int>(buf);
             break;
         case x_long_long:
-            exchange_type_cast<x_long_long>(data_) = string_to_integer<long long>(buf);
+            exchange_type_cast<x_long_long>(data_) = binary
+                ? binary_to_integer<long long>(buf, len, typeOid)
+                : string_to_integer<long long>(buf);
             break;
         case x_unsigned_long_long:
-            exchange_type_cast<x_unsigned_long_long>(data_) = string_to_unsigned_integer<unsigned long long>(buf);
+            exchange_type_cast<x_unsigned_long_long>(data_) = binary
+                ? binary_to_unsigned_integer<unsigned long long>(
+                    buf, len, typeOid)
+                : string_to_unsigned_integer<unsigned long long>(buf);
             break;
         case x_double:
-            exchange_type_cast<x_double>(data_) = cstring_to_double(buf);
+            exchange_type_cast<x_double>(data_) = binary
+                ? binary_to_double(buf, len, typeOid)
+                : cstring_to_double(buf);
             break;
         case x_stdtm:
-            // attempt to parse the string and convert to std::tm
-            parse_std_tm(buf, exchange_type_cast<x_stdtm>(data_));
+            if (binary)
+            {
+                binary_to_std_tm(buf, len, typeOid,
+                    statement_.session_.integerDatetimes_,
+                    exchange_type_cast<x_stdtm>(data_));
+            }
+            else
+            {
+                // attempt to parse the string and convert to std::tm
+                parse_std_tm(buf, exchange_type_cast<x_stdtm>(data_));
+            }
             break;
         case x_rowid:
             {
@@ -122,13 +160,18 @@ void postgresql_standard_into_type_backend::post_fetch(
                     = static_cast<postgresql_rowid_backend *>(
                         rid->get_backend());
 
-                rbe->value_ = string_to_unsigned_integer<unsigned long>(buf);
+                rbe->value_ = binary
+                    ? binary_to_unsigned_integer<unsigned long>(
+                        buf, len, typeOid)
+                    : string_to_unsigned_integer<unsigned long>(buf);
             }
             break;
         case x_blob:
             {
-                unsigned long oid =
-                    string_to_unsigned_integer<unsigned long>(buf);
+                unsigned long oid = binary
+                    ? binary_to_unsigned_integer<unsigned long>(
+                        buf, len, typeOid)
+                    : string_to_unsigned_integer<unsigned long>(buf);
 
                 int fd = lo_open(statement_.session_.conn_, oid,
                     INV_READ | INV_WRITE);
@@ -8,7 +8,9 @@
 #define SOCI_POSTGRESQL_SOURCE
 #include "soci/postgresql/soci-postgresql.h"
 #include "soci/soci-platform.h"
+#include "soci/statement.h"
 #include <libpq/libpq-fs.h> // libpq
+#include "common.h"
 #include <cassert>
 #include <cctype>
 #include <cstdio>
@@ -21,8 +23,18 @@
 #ifndef SOCI_POSTGRESQL_NOBINDBYNAME
 #define SOCI_POSTGRESQL_NOBINDBYNAME
 #endif // SOCI_POSTGRESQL_NOBINDBYNAME
+#ifndef SOCI_POSTGRESQL_NOSINGLEROWMODE
+#define SOCI_POSTGRESQL_NOSINGLEROWMODE
+#endif // SOCI_POSTGRESQL_NOSINGLEROWMODE
 #endif // SOCI_POSTGRESQL_NOPARAMS
 
+// pipeline mode is only available since libpq 14
+#ifdef LIBPQ_HAS_PIPELINING
+#ifndef SOCI_POSTGRESQL_NOPARAMS
+#define SOCI_POSTGRESQL_PIPELINE
+#endif // SOCI_POSTGRESQL_NOPARAMS
+#endif // LIBPQ_HAS_PIPELINING
+
 #ifdef _MSC_VER
 #pragma warning(disable:4355)
 #endif
@@ -30,10 +42,303 @@
 using namespace soci;
 using namespace soci::details;
 
+namespace // anonymous
+{
+
+#ifndef SOCI_POSTGRESQL_NOPARAMS
+
+// The size of the data accumulated before sending it to the server when
+// copying the rows, this is arbitrary but big enough to minimize the
+// overhead of sending the data while keeping memory consumption reasonable.
+std::size_t const copy_buffer_size = 64 * 1024;
+
+// get the number of rows affected by the command which produced the result,
+// PQcmdTuples() returns an empty string for the commands not affecting any
+long long get_command_rows(PGresult * result)
+{
+    char const * const rows = PQcmdTuples(result);
+    if (rows[0] == '\0')
+    {
+        return 0;
+    }
+
+    return postgresql::string_to_integer<long long>(rows);
+}
+
+#ifdef SOCI_POSTGRESQL_PIPELINE
+
+// The number of statements sent in pipeline mode before reading their
+// results, this is needed to prevent the server from blocking when its
+// output buffer becomes full while we're still sending.
+int const pipeline_batch_size = 256;
+
+// discard the results of all the statements already sent in pipeline mode
+// and leave it, returns false if the connection couldn't be restored to
+// its normal state
+bool abort_pipeline(PGconn * conn)
+{
+    if (PQpipelineSync(conn) == 1)
+    {
+        // the results of each statement are terminated by NULL, so two NULLs
+        // in a row mean that nothing else is going to be received
+        int nulls = 0;
+        while (nulls != 2)
+        {
+            PGresult * const result = PQgetResult(conn);
+            if (result == NULL)
+            {
+                ++nulls;
+                continue;
+            }
+
+            nulls = 0;
+
+            bool const synced = PQresultStatus(result) == PGRES_PIPELINE_SYNC;
+            PQclear(result);
+            if (synced)
+            {
+                break;
+            }
+        }
+    }
+
+    return PQexitPipelineMode(conn) == 1;
+}
+
+#endif // SOCI_POSTGRESQL_PIPELINE
+
+// helpers for parsing the query in make_copy_query()
+void skip_spaces(std::string const & query, std::size_t & pos)
+{
+    while (pos < query.size() &&
+        std::isspace(static_cast<unsigned char>(query[pos])))
+    {
+        ++pos;
+    }
+}
+
+bool skip_keyword(std::string const & query, std::size_t & pos,
+    char const * keyword)
+{
+    std::size_t const len = std::strlen(keyword);
+    if (query.size() - pos < len)
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i != len; ++i)
+    {
+        if (std::tolower(static_cast<unsigned char>(query[pos + i]))
+            != keyword[i])
+        {
+            return false;
+        }
+    }
+
+    // the keyword must not be a prefix of a longer word
+    if (pos + len < query.size() &&
+        (std::isalnum(static_cast<unsigned char>(query[pos + len])) ||
+            query[pos + len] == '_'))
+    {
+        return false;
+    }
+
+    pos += len;
+    skip_spaces(query, pos);
+    return true;
+}
+
+bool skip_char(std::string const & query, std::size_t & pos, char c)
+{
+    if (pos == query.size() || query[pos] != c)
+    {
+        return false;
+    }
+
+    ++pos;
+    skip_spaces(query, pos);
+    return true;
+}
+
+// Return the COPY statement which can be used instead of the given one if
+// it is a simple "INSERT INTO table(columns) VALUES($1, ..., $N)" or an empty
+// string otherwise.
+std::string make_copy_query(std::string const & query)
+{
+    std::size_t pos = 0;
+    skip_spaces(query, pos);
+
+    if (skip_keyword(query, pos, "insert") == false ||
+        skip_keyword(query, pos, "into") == false)
+    {
+        return std::string();
+    }
+
+    // the table name, possibly schema-qualified and quoted
+    std::size_t const tableStart = pos;
+    bool inQuotes = false;
+    for (; pos != query.size(); ++pos)
+    {
+        char const c = query[pos];
+        if (c == '"')
+        {
+            inQuotes = !inQuotes;
+        }
+        else if (inQuotes == false &&
+            (c == '(' || std::isspace(static_cast<unsigned char>(c))))
+        {
+            break;
+        }
+    }
+
+    std::string const table = query.substr(tableStart, pos - tableStart);
+    skip_spaces(query, pos);
+
+    // the columns must be given explicitly as COPY, unlike INSERT, requires
+    // the values for all the columns otherwise
+    if (table.empty() || inQuotes || pos == query.size() || query[pos] != '(')
+    {
+        return std::string();
+    }
+
+    std::size_t const columnsStart = pos;
+    for (; pos != query.size(); ++pos)
+    {
+        char const c = query[pos];
+        if (c == '"')
+        {
+            inQuotes = !inQuotes;
+        }
+        else if (inQuotes == false && c == ')')
+        {
+            break;
+        }
+    }
+
+    if (pos == query.size())
+    {
+        return std::string();
+    }
+
+    std::string const columns
+        = query.substr(columnsStart, pos - columnsStart + 1);
+    ++pos;
+    skip_spaces(query, pos);
+
+    if (skip_keyword(query, pos, "values") == false ||
+        skip_char(query, pos, '(') == false)
+    {
+        return std::string();
+    }
+
+    // only the parameters, in their natural order, can be used as values
+    for (int param = 1; ; ++param)
+    {
+        std::ostringstream ss;
+        ss << '$' << param;
+        std::string const placeholder = ss.str();
+        if (query.compare(pos, placeholder.size(), placeholder) != 0)
+        {
+            return std::string();
+        }
+
+        pos += placeholder.size();
+        if (pos < query.size() &&
+            std::isdigit(static_cast<unsigned char>(query[pos])))
+        {
+            return std::string();
+        }
+
+        skip_spaces(query, pos);
+
+        if (skip_char(query, pos, ')'))
+        {
+            break;
+        }
+
+        if (skip_char(query, pos, ',') == false)
+        {
+            return std::string();
+        }
+    }
+
+    // nothing (except for the optional semicolon) may follow
+    skip_char(query, pos, ';');
+    if (pos != query.size())
+    {
+        return std::string();
+    }
+
+    return "COPY " + table + " " + columns + " FROM STDIN";
+}
+
+// append the value in the format used by COPY in text mode
+void append_copy_value(std::string & data, char const * value)
+{
+    if (value == NULL)
+    {
+        data += "\\N";
+        return;
+    }
+
+    for (char const * p = value; *p != '\0'; ++p)
+    {
+        switch (*p)
+        {
+        case '\\':
+            data += "\\\\";
+            break;
+        case '\n':
+            data += "\\n";
+            break;
+        case '\r':
+            data += "\\r";
+            break;
+        case '\t':
+            data += "\\t";
+            break;
+        default:
+            data += *p;
+        }
+    }
+}
+
+#endif // SOCI_POSTGRESQL_NOPARAMS
+
+#ifndef SOCI_POSTGRESQL_NOSINGLEROWMODE
+
+// helper function for collecting the rows received in single row mode
+void append_row(PGresult * dest, int destRow, PGresult const * src, int srcRow)
+{
+    int const numberOfFields = PQnfields(src);
+    for (int field = 0; field != numberOfFields; ++field)
+    {
+        // PQsetvalue() copies the value, so it's safe to cast away const
+        char * const value = PQgetisnull(src, srcRow, field) != 0
+            ? NULL
+            : PQgetvalue(src, srcRow, field);
+
+        if (PQsetvalue(dest, destRow, field, value,
+                PQgetlength(src, srcRow, field)) == 0)
+        {
+            throw soci_error("Cannot store the received row.");
+        }
+    }
+}
+
+#endif // SOCI_POSTGRESQL_NOSINGLEROWMODE
+
+} // namespace anonymous
+
 postgresql_statement_backend::postgresql_statement_backend(
     postgresql_session_backend &session)
      : session_(session)
      , rowsAffectedBulk_(-1LL), justDescribed_(false)
+     , binaryResults_(session.binaryResults_), binaryResultFormat_(-1)
+     , streamResults_(session.streamResults_), streaming_(false)
+     , nonBlocking_(false), sending_(false)
+     , copyBulkInserts_(session.copyBulkInserts_)
+     , pipelineBulkOperations_(session.pipelineBulkOperations_)
      , hasIntoElements_(false), hasVectorIntoElements_(false)
      , hasUseElements_(false), hasVectorUseElements_(false)
 {
@@ -45,6 +350,11 @@ postgresql_statement_backend::~postgresql_statement_backend()
     {
         try
         {
+            // the statement can't be deallocated while its results are
+            // still being received
+            finish_streaming();
+            finish_nonblocking();
+
             session_.deallocate_prepared_statement(statementName_);
         }
         catch (...)
@@ -68,12 +378,16 @@ void postgresql_statement_backend::clean_up()
     // potential new execution.
     rowsAffectedBulk_ = -1;
 
-    // nothing to do here
+    finish_streaming();
+    finish_nonblocking();
 }
 
 void postgresql_statement_backend::prepare(std::string const & query,
     statement_type stType)
 {
+    // the types of the result columns will need to be checked again
+    binaryResultFormat_ = -1;
+
 #ifdef SOCI_POSTGRESQL_NOBINDBYNAME
     query_ = query;
 #else
@@ -177,6 +491,10 @@ void postgresql_statement_backend::prepare(std::string const & query,
 
 #endif // SOCI_POSTGRESQL_NOBINDBYNAME
 
+#ifndef SOCI_POSTGRESQL_NOPARAMS
+    copyQuery_ = make_copy_query(query_);
+#endif // SOCI_POSTGRESQL_NOPARAMS
+
 #ifndef SOCI_POSTGRESQL_NOPREPARE
 
     if (stType == st_repeatable_query)
@@ -201,6 +519,48 @@ void postgresql_statement_backend::prepare(std::string const & query,
 #endif // SOCI_POSTGRESQL_NOPREPARE
 }
 
+void postgresql_statement_backend::get_param_values(int row,
+    std::vector<char *> & paramValues)
+{
+    if (useByPosBuffers_.empty() == false)
+    {
+        // use elements bind by position
+        // the map of use buffers can be traversed
+        // in its natural order
+
+        for (UseByPosBuffersMap::iterator
+                 it = useByPosBuffers_.begin(),
+                 end = useByPosBuffers_.end();
+             it != end; ++it)
+        {
+            char ** buffers = it->second;
+            paramValues.push_back(buffers[row]);
+        }
+    }
+    else
+    {
+        // use elements bind by name
+
+        for (std::vector<std::string>::iterator
+                 it = names_.begin(), end = names_.end();
+             it != end; ++it)
+        {
+            UseByNameBuffersMap::iterator b
+                = useByNameBuffers_.find(*it);
+            if (b == useByNameBuffers_.end())
+            {
+                std::string msg(
+                    "Missing use element for bind by name (");
+                msg += *it;
+                msg += ").";
+                throw soci_error(msg);
+            }
+            char ** buffers = b->second;
+            paramValues.push_back(buffers[row]);
+        }
+    }
+}
+
 statement_backend::exec_fetch_result
 postgresql_statement_backend::execute(int number)
 {
@@ -230,6 +590,8 @@ postgresql_statement_backend::execute(int number)
         // specifies the size of vectors (into/use), but 'numberOfExecutions'
         // specifies the number of loops that need to be performed.
 
+        int const resultFormat = get_result_format();
+
         int numberOfExecutions = 1;
         if (number > 0)
         {
@@ -246,48 +608,32 @@ postgresql_statement_backend::execute(int number)
                     "Binding for use elements must be either by position "
                     "or by name.");
             }
+
+#ifndef SOCI_POSTGRESQL_NOPARAMS
+            if (numberOfExecutions > 1 && copyBulkInserts_ &&
+                copyQuery_.empty() == false)
+            {
+                // send all the rows at once instead of executing the
+                // statement once for each of them
+                copy_rows(numberOfExecutions);
+                return ef_no_data;
+            }
+
+#ifdef SOCI_POSTGRESQL_PIPELINE
+            if (numberOfExecutions > 1 && pipelineBulkOperations_)
+            {
+                // send all the rows before waiting for the results
+                pipeline_rows(numberOfExecutions, resultFormat);
+                return ef_no_data;
+            }
+#endif // SOCI_POSTGRESQL_PIPELINE
+#endif // SOCI_POSTGRESQL_NOPARAMS
+
             long long rowsAffectedBulkTemp = 0;
             for (int i = 0; i != numberOfExecutions; ++i)
             {
                 std::vector<char *> paramValues;
-
-                if (useByPosBuffers_.empty() == false)
-                {
-                    // use elements bind by position
-                    // the map of use buffers can be traversed
-                    // in its natural order
-
-                    for (UseByPosBuffersMap::iterator
-                             it = useByPosBuffers_.begin(),
-                             end = useByPosBuffers_.end();
-                         it != end; ++it)
-                    {
-                        char ** buffers = it->second;
-                        paramValues.push_back(buffers[i]);
-                    }
-                }
-                else
-                {
-                    // use elements bind by name
-
-                    for (std::vector<std::string>::iterator
-                             it = names_.begin(), end = names_.end();
-                         it != end; ++it)
-                    {
-                        UseByNameBuffersMap::iterator b
-                            = useByNameBuffers_.find(*it);
-                        if (b == useByNameBuffers_.end())
-                        {
-                            std::string msg(
-                                "Missing use element for bind by name (");
-                            msg += *it;
-                            msg += ").";
-                            throw soci_error(msg);
-                        }
-                        char ** buffers = b->second;
-                        paramValues.push_back(buffers[i]);
-                    }
-                }
+                get_param_values(i, paramValues);
 
 #ifdef SOCI_POSTGRESQL_NOPARAMS
 
@@ -295,32 +641,42 @@ postgresql_statement_backend::execute(int number)
 
 #else
 
-#ifdef SOCI_POSTGRESQL_NOPREPARE
-
-                result_.reset(PQexecParams(session_.conn_, query_.c_str(),
-                    static_cast<int>(paramValues.size()),
-                    NULL, &paramValues[0], NULL, NULL, 0));
-#else
-                if (stType_ == st_repeatable_query)
+#ifndef SOCI_POSTGRESQL_NOSINGLEROWMODE
+                if (streamResults_ && numberOfExecutions == 1)
                 {
-                    // this query was separately prepared
-
-                    result_.reset(PQexecPrepared(session_.conn_,
-                        statementName_.c_str(),
-                        static_cast<int>(paramValues.size()),
-                        &paramValues[0], NULL, NULL, 0));
+                    send_query(static_cast<int>(paramValues.size()),
+                        &paramValues[0], resultFormat);
                 }
-                else // stType_ == st_one_time_query
+                else
+#endif // SOCI_POSTGRESQL_NOSINGLEROWMODE
                 {
-                    // this query was not separately prepared and should
-                    // be executed as a one-time query
+#ifdef SOCI_POSTGRESQL_NOPREPARE
 
                     result_.reset(PQexecParams(session_.conn_, query_.c_str(),
                         static_cast<int>(paramValues.size()),
-                        NULL, &paramValues[0], NULL, NULL, 0));
-                }
+                        NULL, &paramValues[0], NULL, NULL, resultFormat));
+#else
+                    if (stType_ == st_repeatable_query)
+                    {
+                        // this query was separately prepared
+
+                        result_.reset(PQexecPrepared(session_.conn_,
+                            statementName_.c_str(),
+                            static_cast<int>(paramValues.size()),
+                            &paramValues[0], NULL, NULL, resultFormat));
+                    }
+                    else // stType_ == st_one_time_query
+                    {
+                        // this query was not separately prepared and should
+                        // be executed as a one-time query
+
+                        result_.reset(PQexecParams(session_.conn_, query_.c_str(),
+                            static_cast<int>(paramValues.size()),
+                            NULL, &paramValues[0], NULL, NULL, resultFormat));
+                    }
 
 #endif // SOCI_POSTGRESQL_NOPREPARE
+                }
 
 #endif // SOCI_POSTGRESQL_NOPARAMS
 
@@ -352,23 +708,39 @@ postgresql_statement_backend::execute(int number)
             // there are no use elements
             // - execute the query without parameter information
 
-#ifdef SOCI_POSTGRESQL_NOPREPARE
-
-            result_.reset(PQexec(session_.conn_, query_.c_str()));
-#else
+#ifndef SOCI_POSTGRESQL_NOSINGLEROWMODE
+            if (streamResults_)
+            {
+                send_query(0, NULL, resultFormat);
+            }
+            else
+#endif // SOCI_POSTGRESQL_NOSINGLEROWMODE
+#ifndef SOCI_POSTGRESQL_NOPREPARE
             if (stType_ == st_repeatable_query)
             {
                 // this query was separately prepared
 
                 result_.reset(PQexecPrepared(session_.conn_,
-                    statementName_.c_str(), 0, NULL, NULL, NULL, 0));
+                    statementName_.c_str(), 0, NULL, NULL, NULL,
+                    resultFormat));
             }
             else // stType_ == st_one_time_query
+#endif // SOCI_POSTGRESQL_NOPREPARE
             {
-                result_.reset(PQexec(session_.conn_, query_.c_str()));
+#ifndef SOCI_POSTGRESQL_NOPARAMS
+                // PQexec() can only return the results in text format
+                if (resultFormat != 0)
+                {
+                    result_.reset(PQexecParams(session_.conn_,
+                        query_.c_str(), 0, NULL, NULL, NULL, NULL,
+                        resultFormat));
+                }
+                else
+#endif // SOCI_POSTGRESQL_NOPARAMS
+                {
+                    result_.reset(PQexec(session_.conn_, query_.c_str()));
+                }
             }
-
-#endif // SOCI_POSTGRESQL_NOPREPARE
         }
     }
     else
@@ -381,6 +753,12 @@ postgresql_statement_backend::execute(int number)
         justDescribed_ = false;
     }
 
+    return process_result(number);
+}
+
+statement_backend::exec_fetch_result
+postgresql_statement_backend::process_result(int number)
+{
     if (result_.check_for_data("Cannot execute query."))
     {
         currentRow_ = 0;
@@ -423,6 +801,15 @@ postgresql_statement_backend::fetch(int number)
     // forward the "cursor" from the last fetch
     currentRow_ += rowsToConsume_;
 
+    if (streaming_ && currentRow_ + number > numberOfRows_)
+    {
+        // In streaming mode, not all rows were received from the server yet,
+        // so do it now (this resets the "cursor" to the start of a new
+        // result containing the rows remaining in the old one followed by
+        // the newly received ones).
+        receive_rows(number);
+    }
+
     if (currentRow_ >= numberOfRows_)
     {
         // all rows were already consumed
@@ -447,6 +834,626 @@ postgresql_statement_backend::fetch(int number)
     }
 }
 
+void postgresql_statement_backend::reset()
+{
+    // the connection can't be used for anything else until all the results
+    // are received
+    finish_streaming();
+    finish_nonblocking();
+
+    // free the memory used by the last result, it won't be used any more
+    result_.reset();
+
+    numberOfRows_ = 0;
+    currentRow_ = 0;
+    rowsToConsume_ = 0;
+    justDescribed_ = false;
+    rowsAffectedBulk_ = -1LL;
+}
+
+void postgresql_statement_backend::copy_rows(int numberOfRows)
+{
+#ifndef SOCI_POSTGRESQL_NOPARAMS
+    // nothing is inserted if copying fails
+    rowsAffectedBulk_ = 0;
+
+    std::vector<char *> paramValues;
+
+    // check that all the values are available before starting to copy as
+    // it's not possible to execute any other queries until it is finished
+    get_param_values(0, paramValues);
+
+    postgresql_result result(PQexec(session_.conn_, copyQuery_.c_str()));
+    if (PQresultStatus(result) != PGRES_COPY_IN)
+    {
+        result.check_for_errors("Cannot start copying data.");
+        throw soci_error("Cannot start copying data.");
+    }
+
+    std::string data;
+    char const * errMsg = NULL;
+    try
+    {
+        for (int i = 0; i != numberOfRows; ++i)
+        {
+            if (i != 0)
+            {
+                paramValues.clear();
+                get_param_values(i, paramValues);
+            }
+
+            for (std::size_t n = 0; n != paramValues.size(); ++n)
+            {
+                if (n != 0)
+                {
+                    data += '\t';
+                }
+
+                append_copy_value(data, paramValues[n]);
+            }
+
+            data += '\n';
+
+            if (data.size() >= copy_buffer_size || i == numberOfRows - 1)
+            {
+                if (PQputCopyData(session_.conn_, data.c_str(),
+                        static_cast<int>(data.size())) != 1)
+                {
+                    errMsg = "Cannot copy data.";
+                    break;
+                }
+
+                data.clear();
+            }
+        }
+    }
+    catch (...)
+    {
+        // abort copying to leave the COPY_IN state, otherwise the connection
+        // couldn't be used for anything else
+        PQputCopyEnd(session_.conn_, "Cannot copy data.");
+        while (PGresult * extra = PQgetResult(session_.conn_))
+        {
+            // this is returned indefinitely if ending the copy failed
+            bool const stillCopying = PQresultStatus(extra) == PGRES_COPY_IN;
+            PQclear(extra);
+            if (stillCopying)
+            {
+                break;
+            }
+        }
+
+        throw;
+    }
+
+    if (PQputCopyEnd(session_.conn_, errMsg) != 1 && errMsg == NULL)
+    {
+        errMsg = "Cannot finish copying data.";
+    }
+
+    // the final result must be received (and all the others, if any,
+    // discarded) before the connection can be used again
+    result.reset(PQgetResult(session_.conn_));
+    while (PGresult * extra = PQgetResult(session_.conn_))
+    {
+        PQclear(extra);
+    }
+
+    if (errMsg != NULL)
+    {
+        std::string msg = errMsg;
+        msg += ' ';
+        msg += PQerrorMessage(session_.conn_);
+        throw soci_error(msg);
+    }
+
+    result.check_for_errors("Cannot copy data.");
+
+    rowsAffectedBulk_ = get_command_rows(result.get_result());
+#else
+    static_cast<void>(numberOfRows);
+#endif // SOCI_POSTGRESQL_NOPARAMS
+}
+
+void postgresql_statement_backend::pipeline_rows(int numberOfRows,
+    int resultFormat)
+{
+#ifdef SOCI_POSTGRESQL_PIPELINE
+    rowsAffectedBulk_ = 0;
+
+    std::vector<char *> paramValues;
+
+    // check that all the values are available before entering pipeline mode
+    // to avoid having to exit it in case of an error
+    get_param_values(0, paramValues);
+
+    if (PQenterPipelineMode(session_.conn_) != 1)
+    {
+        throw soci_error("Cannot enter pipeline mode.");
+    }
+
+    postgresql_result error;
+    bool sendFailed = false;
+    int sent = 0;
+    try
+    {
+        while (sent != numberOfRows && error.get_result() == NULL)
+        {
+            int const batchEnd = numberOfRows - sent > pipeline_batch_size
+                ? sent + pipeline_batch_size
+                : numberOfRows;
+
+            int const batchStart = sent;
+            for (; sent != batchEnd; ++sent)
+            {
+                paramValues.clear();
+                get_param_values(sent, paramValues);
+
+                int res;
+#ifndef SOCI_POSTGRESQL_NOPREPARE
+                if (stType_ == st_repeatable_query)
+                {
+                    res = PQsendQueryPrepared(session_.conn_,
+                        statementName_.c_str(),
+                        static_cast<int>(paramValues.size()),
+                        &paramValues[0], NULL, NULL, resultFormat);
+                }
+                else
+#endif // SOCI_POSTGRESQL_NOPREPARE
+                {
+                    res = PQsendQueryParams(session_.conn_, query_.c_str(),
+                        static_cast<int>(paramValues.size()),
+                        NULL, &paramValues[0], NULL, NULL, resultFormat);
+                }
+
+                if (res == 0)
+                {
+                    sendFailed = true;
+                    break;
+                }
+            }
+
+            // ask the server to send the results of the statements in this
+            // batch without waiting for the end of the pipeline
+            if (sendFailed || PQsendFlushRequest(session_.conn_) == 0 ||
+                PQflush(session_.conn_) != 0)
+            {
+                sendFailed = true;
+                break;
+            }
+
+            for (int row = batchStart; row != sent; ++row)
+            {
+                postgresql_result result(PQgetResult(session_.conn_));
+
+                // the results of each statement are terminated by NULL
+                PQclear(PQgetResult(session_.conn_));
+
+                switch (PQresultStatus(result))
+                {
+                case PGRES_COMMAND_OK:
+                case PGRES_TUPLES_OK:
+                    if (error.get_result() == NULL)
+                    {
+                        rowsAffectedBulk_ +=
+                            get_command_rows(result.get_result());
+                    }
+                    break;
+
+                case PGRES_PIPELINE_ABORTED:
+                    // the statement was skipped because of an earlier error
+                    break;
+
+                default:
+                    if (error.get_result() == NULL)
+                    {
+                        error.reset(result.release());
+                    }
+                }
+            }
+        }
+    }
+    catch (...)
+    {
+        abort_pipeline(session_.conn_);
+        throw;
+    }
+
+    if (sendFailed == false)
+    {
+        // end the pipeline and wait until the server processes it
+        if (PQpipelineSync(session_.conn_) == 1)
+        {
+            postgresql_result sync(PQgetResult(session_.conn_));
+            sendFailed = PQresultStatus(sync) != PGRES_PIPELINE_SYNC;
+        }
+        else
+        {
+            sendFailed = true;
+        }
+    }
+
+    if (sendFailed)
+    {
+        std::string msg = "Cannot execute query in pipeline mode. ";
+        msg += PQerrorMessage(session_.conn_);
+        if (abort_pipeline(session_.conn_) == false)
+        {
+            msg += " Cannot exit pipeline mode.";
+        }
+
+        throw soci_error(msg);
+    }
+
+    if (PQexitPipelineMode(session_.conn_) != 1)
+    {
+        std::string msg = "Cannot exit pipeline mode. ";
+        msg += PQerrorMessage(session_.conn_);
+        throw soci_error(msg);
+    }
+
+    if (error.get_result() != NULL)
+    {
+        // this throws with the error of the first failed statement
+        error.check_for_errors("Cannot execute query.");
+    }
+#else
+    static_cast<void>(numberOfRows);
+    static_cast<void>(resultFormat);
+#endif // SOCI_POSTGRESQL_PIPELINE
+}
+
+bool postgresql_statement_backend::result_format_needed() const
+{
+#if !defined(SOCI_POSTGRESQL_NOPREPARE) && !defined(SOCI_POSTGRESQL_NOPARAMS)
+    // there is no need for binary format without into elements and checking
+    // the column types requires an additional round trip to the server,
+    // which is only worth it for the statements executed repeatedly (which
+    // include the one-time queries kept in the session statement cache)
+    return binaryResults_ && stType_ == st_repeatable_query &&
+        (hasIntoElements_ || hasVectorIntoElements_);
+#else
+    // the results can only be requested in text format without parameters
+    // support and the column types can't be checked without prepared
+    // statements
+    return false;
+#endif // !SOCI_POSTGRESQL_NOPREPARE && !SOCI_POSTGRESQL_NOPARAMS
+}
+
+int postgresql_statement_backend::get_result_format()
+{
+    if (result_format_needed() == false)
+    {
+        return 0;
+    }
+
+    if (binaryResultFormat_ == -1)
+    {
+        // libpq doesn't allow choosing the format of each column separately,
+        // so binary format can only be used if all of them can be decoded
+        postgresql_result description(PQdescribePrepared(session_.conn_,
+            statementName_.c_str()));
+        description.check_for_errors("Cannot describe statement.");
+
+        binaryResultFormat_ = 1;
+
+        int const columns = PQnfields(description);
+        for (int i = 0; i != columns; ++i)
+        {
+            if (postgresql::is_binary_type_supported(
+                    PQftype(description, i)) == false)
+            {
+                binaryResultFormat_ = 0;
+                break;
+            }
+        }
+    }
+
+    return binaryResultFormat_;
+}
+
+void postgresql_statement_backend::send_statement(int nParams,
+    char const * const * paramValues, int resultFormat)
+{
+    int sent;
+
+#ifndef SOCI_POSTGRESQL_NOPREPARE
+    if (stType_ == st_repeatable_query)
+    {
+        sent = PQsendQueryPrepared(session_.conn_, statementName_.c_str(),
+            nParams, paramValues, NULL, NULL, resultFormat);
+    }
+    else
+#endif // SOCI_POSTGRESQL_NOPREPARE
+#ifndef SOCI_POSTGRESQL_NOPARAMS
+    if (nParams == 0 && resultFormat == 0)
+    {
+        // as with PQexec(), allow multiple commands in this case
+        sent = PQsendQuery(session_.conn_, query_.c_str());
+    }
+    else
+    {
+        sent = PQsendQueryParams(session_.conn_, query_.c_str(),
+            nParams, NULL, paramValues, NULL, NULL, resultFormat);
+    }
+#else
+    sent = PQsendQuery(session_.conn_, query_.c_str());
+#endif // SOCI_POSTGRESQL_NOPARAMS
+
+    if (sent == 0)
+    {
+        std::string msg = "Cannot execute query. ";
+        msg += PQerrorMessage(session_.conn_);
+        throw soci_error(msg);
+    }
+}
+
+void postgresql_statement_backend::send_query(int nParams,
+    char const * const * paramValues, int resultFormat)
+{
+#ifndef SOCI_POSTGRESQL_NOSINGLEROWMODE
+    send_statement(nParams, paramValues, resultFormat);
+
+    streaming_ = true;
+
+    if (PQsetSingleRowMode(session_.conn_) == 0)
+    {
+        finish_streaming();
+        throw soci_error("Cannot switch to single row mode.");
+    }
+
+    // receive the first row to know whether the query returns data at all
+    result_.reset();
+    currentRow_ = 0;
+    numberOfRows_ = 0;
+    receive_rows(1);
+#else
+    static_cast<void>(nParams);
+    static_cast<void>(paramValues);
+    static_cast<void>(resultFormat);
+#endif // SOCI_POSTGRESQL_NOSINGLEROWMODE
+}
+
+void postgresql_statement_backend::receive_rows(int number)
+{
+#ifndef SOCI_POSTGRESQL_NOSINGLEROWMODE
+    // In single row mode each row comes in its own PGresult, so, unless just
+    // one row is needed, they are copied into a single result to allow the
+    // into elements to process them in the same way as in normal mode.
+    postgresql_result rows;
+    int rowsCount = 0;
+
+    // start with the rows of the current result which were not consumed yet
+    for (int row = currentRow_; row < numberOfRows_; ++row)
+    {
+        if (rows.get_result() == NULL)
+        {
+            rows.reset(PQcopyResult(result_, PG_COPYRES_ATTRS));
+        }
+
+        append_row(rows.get_result(), rowsCount++, result_, row);
+    }
+
+    while (streaming_ && rowsCount < number)
+    {
+        postgresql_result result(PQgetResult(session_.conn_));
+        if (PQresultStatus(result) != PGRES_SINGLE_TUPLE)
+        {
+            // this is the final result, indicating either the end of the
+            // rows, the completion of a command not returning any or an error
+            finish_streaming();
+
+            if (result.check_for_data("Cannot execute query.") == false ||
+                rows.get_result() == NULL)
+            {
+                // keep the final result if there are no rows to return, it
+                // contains the command status
+                rows.reset(result.release());
+            }
+
+            break;
+        }
+
+        if (rows.get_result() == NULL)
+        {
+            if (number == 1)
+            {
+                // no need to copy anything
+                rows.reset(result.release());
+                ++rowsCount;
+                break;
+            }
+
+            rows.reset(PQcopyResult(result, PG_COPYRES_ATTRS));
+        }
+
+        append_row(rows.get_result(), rowsCount++, result, 0);
+    }
+
+    result_.reset(rows.release());
+    currentRow_ = 0;
+    rowsToConsume_ = 0;
+    numberOfRows_ = rowsCount;
+#else
+    static_cast<void>(number);
+#endif // SOCI_POSTGRESQL_NOSINGLEROWMODE
+}
+
+void postgresql_statement_backend::finish_streaming()
+{
+    if (streaming_ == false)
+    {
+        return;
+    }
+
+    streaming_ = false;
+
+    // All the results must be received before the connection can be used for
+    // anything else. Cancelling the query would be faster but could abort the
+    // current transaction, so just discard them.
+    while (PGresult * result = PQgetResult(session_.conn_))
+    {
+        PQclear(result);
+    }
+}
+
+bool postgresql_statement_backend::start_execute(int number)
+{
+    if (requires_synchronous_execution())
+    {
+        return false;
+    }
+
+    clean_up();
+
+    if (number > 1 && hasIntoElements_)
+    {
+         throw soci_error(
+              "Bulk use with single into elements is not supported.");
+    }
+
+    if ((useByPosBuffers_.empty() == false) &&
+        (useByNameBuffers_.empty() == false))
+    {
+        throw soci_error(
+            "Binding for use elements must be either by position "
+            "or by name.");
+    }
+
+    std::vector<char *> paramValues;
+    get_param_values(0, paramValues);
+
+#ifdef SOCI_POSTGRESQL_NOPARAMS
+    if (paramValues.empty() == false)
+    {
+        throw soci_error("Queries with parameters are not supported.");
+    }
+#endif // SOCI_POSTGRESQL_NOPARAMS
+
+    // the format is already known here, so this doesn't block
+    int const resultFormat = get_result_format();
+
+    if (PQsetnonblocking(session_.conn_, 1) != 0)
+    {
+        throw soci_error("Cannot switch to non-blocking mode.");
+    }
+
+    nonBlocking_ = true;
+    sending_ = true;
+
+    try
+    {
+        send_statement(static_cast<int>(paramValues.size()),
+            paramValues.empty() ? NULL : &paramValues[0],
+            resultFormat);
+    }
+    catch (...)
+    {
+        finish_nonblocking();
+        throw;
+    }
+
+    result_.reset();
+
+    return true;
+}
+
+step_status postgresql_statement_backend::step_execute()
+{
+    if (nonBlocking_ == false)
+    {
+        return step_done;
+    }
+
+    if (sending_)
+    {
+        int const res = PQflush(session_.conn_);
+        if (res == 1)
+        {
+            return step_wait_write;
+        }
+
+        if (res != 0)
+        {
+            std::string msg = "Cannot execute query. ";
+            msg += PQerrorMessage(session_.conn_);
+            finish_nonblocking();
+            throw soci_error(msg);
+        }
+
+        sending_ = false;
+    }
+
+    if (PQconsumeInput(session_.conn_) == 0)
+    {
+        std::string msg = "Cannot execute query. ";
+        msg += PQerrorMessage(session_.conn_);
+        finish_nonblocking();
+        throw soci_error(msg);
+    }
+
+    while (PQisBusy(session_.conn_) == 0)
+    {
+        PGresult * const result = PQgetResult(session_.conn_);
+        if (result == NULL)
+        {
+            // all results received, keep the last one, as PQexec() does
+            finish_nonblocking();
+            return step_done;
+        }
+
+        result_.reset(result);
+    }
+
+    return step_wait_read;
+}
+
+statement_backend::exec_fetch_result
+postgresql_statement_backend::finish_execute(int number)
+{
+    return process_result(number);
+}
+
+bool postgresql_statement_backend::can_start_execute()
+{
+    return requires_synchronous_execution() == false;
+}
+
+bool postgresql_statement_backend::can_fetch_without_blocking()
+{
+    // all the rows are already received unless they are streamed
+    return streaming_ == false;
+}
+
+bool postgresql_statement_backend::requires_synchronous_execution() const
+{
+    // the results of the row description are already available, the bulk
+    // operations and streaming execute several queries and choosing the
+    // format of the results for the first time needs to describe the
+    // statement, so let all them be done synchronously
+    return justDescribed_ || streamResults_ || hasVectorUseElements_ ||
+        (binaryResultFormat_ == -1 && result_format_needed());
+}
+
+void postgresql_statement_backend::finish_nonblocking()
+{
+    if (nonBlocking_ == false)
+    {
+        return;
+    }
+
+    nonBlocking_ = false;
+    sending_ = false;
+
+    // discard the results of an interrupted execution (this does block)
+    // before switching the connection back to the usual blocking mode
+    PQsetnonblocking(session_.conn_, 0);
+    while (PGresult * result = PQgetResult(session_.conn_))
+    {
+        PQclear(result);
+    }
+}
+
 long long postgresql_statement_backend::get_affected_rows()
 {
     // PQcmdTuples() doesn't really modify the result but it takes a non-const
@@ -511,7 +1518,10 @@ void postgresql_statement_backend::describe_column(int colNum, data_type & type,
     case 1042: // bpchar
     case 142: // xml
     case 114:  // json
+    case 3802: // jsonb
     case 17: // bytea
+    case 2950: // uuid
+    case 1186: // interval
         type = dt_string;
         break;
 
@@ -589,3 +1599,15 @@ postgresql_statement_backend::make_vector_use_type_backend()
     hasVectorUseElements_ = true;
     return new postgresql_vector_use_type_backend(*this);
 }
+
+void soci::postgresql_set_binary_results(statement & st, bool binary)
+{
+    postgresql_statement_backend * const backend
+        = dynamic_cast<postgresql_statement_backend *>(st.get_backend());
+    if (backend == NULL)
+    {
+        throw soci_error("Binary results can only be used with PostgreSQL.");
+    }
+
+    backend->binaryResults_ = binary;
+}
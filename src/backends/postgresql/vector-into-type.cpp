@@ -69,6 +69,10 @@ void postgresql_vector_into_type_backend::post_fetch(bool gotData, indicator * i
 
         int const endRow = statement_.currentRow_ + statement_.rowsToConsume_;
 
+        // the type is only needed for the binary format
+        bool const binary = PQfformat(statement_.result_, pos) != 0;
+        unsigned long const typeOid = PQftype(statement_.result_, pos);
+
         for (int curRow = statement_.currentRow_, i = 0;
              curRow != endRow; ++curRow, ++i)
         {
@@ -94,53 +98,89 @@ void postgresql_vector_into_type_backend::post_fetch(bool gotData, indicator * i
                 }
             }
 
-            // buffer with data retrieved from server, in text format
+            // buffer with data retrieved from server, in text or binary
+            // format
             char * buf = PQgetvalue(statement_.result_, curRow, pos);
+            int const len = PQgetlength(statement_.result_, curRow, pos);
 
             switch (type_)
             {
             case x_char:
-                set_invector_(data_, i, *buf);
+                {
+                    char const val = binary
+                        ? binary_to_char(buf, len, typeOid,
+                            statement_.session_.integerDatetimes_)
+                        : *buf;
+                    set_invector_(data_, i, val);
+                }
                 break;
             case x_stdstring:
-                set_invector_<std::string>(data_, i, buf);
+                if (binary)
+                {
+                    std::vector<std::string> & v
+                        = *static_cast<std::vector<std::string> *>(data_);
+                    binary_to_string(buf, len, typeOid,
+                        statement_.session_.integerDatetimes_, v[i]);
+                }
+                else
+                {
+                    set_invector_<std::string>(data_, i, buf);
+                }
                 break;
             case x_short:
                 {
-                    short const val = string_to_integer<short>(buf);
+                    short const val = binary
+                        ? binary_to_integer<short>(buf, len, typeOid)
+                        : string_to_integer<short>(buf);
                     set_invector_(data_, i, val);
                 }
                 break;
             case x_integer:
                 {
-                    int const val = string_to_integer<int>(buf);
+                    int const val = binary
+                        ? binary_to_integer<int>(buf, len, typeOid)
+                        : string_to_integer<int>(buf);
                     set_invector_(data_, i, val);
                 }
                 break;
             case x_long_long:
                 {
-                    long long const val = string_to_integer<long long>(buf);
+                    long long const val = binary
+                        ? binary_to_integer<long long>(buf, len, typeOid)
+                        : string_to_integer<long long>(buf);
                     set_invector_(data_, i, val);
                 }
                 break;
             case x_unsigned_long_long:
                 {
-                    unsigned long long const val =
-                        string_to_unsigned_integer<unsigned long long>(buf);
+                    unsigned long long const val = binary
+                        ? binary_to_unsigned_integer<unsigned long long>(
+                            buf, len, typeOid)
+                        : string_to_unsigned_integer<unsigned long long>(buf);
                     set_invector_(data_, i, val);
                 }
                 break;
             case x_double:
                 {
-                    double const val = cstring_to_double(buf);
+                    double const val = binary
+                        ? binary_to_double(buf, len, typeOid)
+                        : cstring_to_double(buf);
                     set_invector_(data_, i, val);
                 }
                 break;
             case x_stdtm:
                 {
-                    // attempt to parse the string and convert to std::tm
                     std::tm t;
-                    parse_std_tm(buf, t);
+                    if (binary)
+                    {
+                        binary_to_std_tm(buf, len, typeOid,
+                            statement_.session_.integerDatetimes_, t);
+                    }
+                    else
+                    {
+                        // attempt to parse the string and convert to std::tm
+                        parse_std_tm(buf, t);
+                    }
 
                     set_invector_(data_, i, t);
                 }
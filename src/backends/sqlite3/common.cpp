@@ -9,10 +9,11 @@
 #include "common.h"
 #include "soci/soci-backend.h"
 // std
+#include <algorithm>
+#include <cstdio>
 #include <cstdlib>
 #include <ctime>
 
-
 namespace // anonymous
 {
 
@@ -65,3 +66,19 @@ void soci::details::sqlite3::parse_std_tm(char const *buf, std::tm &t)
     std::mktime(&t);
 }
 
+
+std::size_t soci::details::sqlite3::format_std_tm(std::tm const &t,
+    char *buf, std::size_t size)
+{
+    int const len = snprintf(buf, size, "%d-%02d-%02d %02d:%02d:%02d",
+        t.tm_year + 1900, t.tm_mon + 1, t.tm_mday,
+        t.tm_hour, t.tm_min, t.tm_sec);
+
+    // the output could have been truncated for (invalid) huge field values
+    if (len < 0)
+    {
+        return 0;
+    }
+
+    return (std::min)(static_cast<std::size_t>(len), size - 1);
+}
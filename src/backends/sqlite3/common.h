@@ -21,6 +21,10 @@ namespace soci { namespace details { namespace sqlite3 {
 // helper function for parsing datetime values
 void parse_std_tm(char const *buf, std::tm &t);
 
+// helper function for formatting datetime values into the given buffer,
+// returns the length of the resulting string
+std::size_t format_std_tm(std::tm const &t, char *buf, std::size_t size);
+
 // helper for vector operations
 template <typename T>
 std::size_t get_vector_size(void *p)
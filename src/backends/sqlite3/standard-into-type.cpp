@@ -20,6 +20,33 @@
 using namespace soci;
 using namespace soci::details;
 using namespace soci::details::sqlite3;
+using namespace sqlite_api;
+
+namespace // anonymous
+{
+
+char const* get_text_column(sqlite3_stmt* stmt, int pos)
+{
+    char const* buf =
+        reinterpret_cast<char const*>(sqlite3_column_text(stmt, pos));
+
+    // set buf to a null string if a null pointer is returned
+    return buf != NULL ? buf : "";
+}
+
+// Values stored as integers are read directly, anything else is parsed
+// from its text representation.
+long long get_integer_column(sqlite3_stmt* stmt, int pos, int colType)
+{
+    if (colType == SQLITE_INTEGER)
+    {
+        return sqlite3_column_int64(stmt, pos);
+    }
+
+    return std::strtoll(get_text_column(stmt, pos), NULL, 10);
+}
+
+} // namespace anonymous
 
 void sqlite3_standard_into_type_backend::define_by_pos(int & position, void * data,
                                                        exchange_type type)
@@ -50,8 +77,11 @@ void sqlite3_standard_into_type_backend::post_fetch(bool gotData,
 
     if (gotData)
     {
+        sqlite3_stmt* const stmt = statement_.stmt_;
+
         // first, deal with indicators
-        if (sqlite3_column_type(statement_.stmt_, pos) == SQLITE_NULL)
+        int const colType = sqlite3_column_type(stmt, pos);
+        if (colType == SQLITE_NULL)
         {
             if (ind == NULL)
             {
@@ -70,46 +100,61 @@ void sqlite3_standard_into_type_backend::post_fetch(bool gotData,
             }
         }
 
-        const char *buf = reinterpret_cast<const char*>(
-            sqlite3_column_text(statement_.stmt_,pos));
-
-        if (buf == NULL)
-        {
-            buf = "";
-        }
-
         switch (type_)
         {
         case x_char:
-            exchange_type_cast<x_char>(data_) = *buf;
+            exchange_type_cast<x_char>(data_) = *get_text_column(stmt, pos);
             break;
         case x_stdstring:
-            exchange_type_cast<x_stdstring>(data_) = buf;
-            break;
-        case x_short:
             {
-                long val = std::strtol(buf, NULL, 10);
-                exchange_type_cast<x_short>(data_) = static_cast<short>(val);
+                char const* const buf = get_text_column(stmt, pos);
+                exchange_type_cast<x_stdstring>(data_).assign(buf,
+                    sqlite3_column_bytes(stmt, pos));
             }
             break;
+        case x_short:
+            exchange_type_cast<x_short>(data_) = static_cast<short>(
+                get_integer_column(stmt, pos, colType));
+            break;
         case x_integer:
-            {
-                long val = std::strtol(buf, NULL, 10);
-                exchange_type_cast<x_integer>(data_) = static_cast<int>(val);
-            }
+            exchange_type_cast<x_integer>(data_) = static_cast<int>(
+                get_integer_column(stmt, pos, colType));
             break;
         case x_long_long:
-            exchange_type_cast<x_long_long>(data_) = std::strtoll(buf, NULL, 10);
+            exchange_type_cast<x_long_long>(data_) =
+                get_integer_column(stmt, pos, colType);
             break;
         case x_unsigned_long_long:
-            exchange_type_cast<x_unsigned_long_long>(data_) = string_to_unsigned_integer<unsigned long long>(buf);
+            if (colType == SQLITE_INTEGER &&
+                    sqlite3_column_int64(stmt, pos) >= 0)
+            {
+                exchange_type_cast<x_unsigned_long_long>(data_) =
+                    static_cast<unsigned long long>(
+                        sqlite3_column_int64(stmt, pos));
+            }
+            else
+            {
+                exchange_type_cast<x_unsigned_long_long>(data_) =
+                    string_to_unsigned_integer<unsigned long long>(
+                        get_text_column(stmt, pos));
+            }
             break;
         case x_double:
-            exchange_type_cast<x_double>(data_) = cstring_to_double(buf);
+            if (colType == SQLITE_INTEGER || colType == SQLITE_FLOAT)
+            {
+                exchange_type_cast<x_double>(data_) =
+                    sqlite3_column_double(stmt, pos);
+            }
+            else
+            {
+                exchange_type_cast<x_double>(data_) =
+                    cstring_to_double(get_text_column(stmt, pos));
+            }
             break;
         case x_stdtm:
             // attempt to parse the string and convert to std::tm
-            parse_std_tm(buf, exchange_type_cast<x_stdtm>(data_));
+            parse_std_tm(get_text_column(stmt, pos),
+                exchange_type_cast<x_stdtm>(data_));
             break;
         case x_rowid:
             {
@@ -117,7 +162,7 @@ void sqlite3_standard_into_type_backend::post_fetch(bool gotData,
 
                 rowid *rid = static_cast<rowid *>(data_);
                 sqlite3_rowid_backend *rbe = static_cast<sqlite3_rowid_backend *>(rid->get_backend());
-                long long val = std::strtoll(buf, NULL, 10);
+                long long val = get_integer_column(stmt, pos, colType);
                 rbe->value_ = static_cast<unsigned long>(val);
             }
             break;
@@ -127,11 +172,10 @@ void sqlite3_standard_into_type_backend::post_fetch(bool gotData,
                 sqlite3_blob_backend *bbe =
                     static_cast<sqlite3_blob_backend *>(b->get_backend());
 
-                buf = reinterpret_cast<const char*>(sqlite3_column_blob(
-                    statement_.stmt_,
-                    pos));
+                const char *buf = reinterpret_cast<const char*>(
+                    sqlite3_column_blob(stmt, pos));
 
-                int len = sqlite3_column_bytes(statement_.stmt_, pos);
+                int len = sqlite3_column_bytes(stmt, pos);
                 bbe->set_data(buf, len);
             }
             break;
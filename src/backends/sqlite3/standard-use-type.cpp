@@ -9,12 +9,10 @@
 #include "soci/soci-platform.h"
 #include "soci/rowid.h"
 #include "soci/blob.h"
-#include "soci-dtocstr.h"
 #include "soci-exchange-cast.h"
+#include "common.h"
 // std
 #include <cstdio>
-#include <cstdlib>
-#include <cstring>
 #include <ctime>
 #include <limits>
 #include <sstream>
@@ -27,6 +25,8 @@
 
 using namespace soci;
 using namespace soci::details;
+using namespace soci::details::sqlite3;
+using namespace sqlite_api;
 
 void sqlite3_standard_use_type_backend::bind_by_pos(int& position, void* data,
     exchange_type type, bool /*readOnly*/)
@@ -79,85 +79,75 @@ void sqlite3_standard_use_type_backend::pre_use(indicator const * ind)
         statement_.useData_[0].resize(position_);
     }
 
+    sqlite3_column& col = statement_.useData_[0][pos];
+
     if (ind != NULL && *ind == i_null)
     {
-        statement_.useData_[0][pos].isNull_ = true;
-        statement_.useData_[0][pos].data_ = "";
-        statement_.useData_[0][pos].blobBuf_ = 0;
-        statement_.useData_[0][pos].blobSize_ = 0;
+        col.type_ = bt_null;
     }
     else
     {
-        // allocate and fill the buffer with text-formatted client data
+        // bind the numbers natively and the strings without copying them
         switch (type_)
         {
         case x_char:
             {
-                buf_ = new char[2];
-                buf_[0] = exchange_type_cast<x_char>(data_);
-                buf_[1] = '\0';
+                char const& c = exchange_type_cast<x_char>(data_);
+                col.type_ = bt_text;
+                col.data_ = &c;
+                col.size_ = c != '\0' ? 1 : 0;
             }
             break;
         case x_stdstring:
             {
                 std::string const& s = exchange_type_cast<x_stdstring>(data_);
-                buf_ = new char[s.size() + 1];
-                std::strcpy(buf_, s.c_str());
+                col.type_ = bt_text;
+                col.data_ = s.c_str();
+                col.size_ = s.size();
             }
             break;
         case x_short:
-            {
-                std::size_t const bufSize
-                    = std::numeric_limits<short>::digits10 + 3;
-                buf_ = new char[bufSize];
-                snprintf(buf_, bufSize, "%d",
-                    static_cast<int>(exchange_type_cast<x_short>(data_)));
-            }
+            col.type_ = bt_int64;
+            col.int64_ = exchange_type_cast<x_short>(data_);
             break;
         case x_integer:
-            {
-                std::size_t const bufSize
-                    = std::numeric_limits<int>::digits10 + 3;
-                buf_ = new char[bufSize];
-                snprintf(buf_, bufSize, "%d",
-                    exchange_type_cast<x_integer>(data_));
-            }
+            col.type_ = bt_int64;
+            col.int64_ = exchange_type_cast<x_integer>(data_);
             break;
         case x_long_long:
-            {
-                std::size_t const bufSize
-                    = std::numeric_limits<long long>::digits10 + 3;
-                buf_ = new char[bufSize];
-                snprintf(buf_, bufSize, "%" LL_FMT_FLAGS "d",
-                    exchange_type_cast<x_long_long>(data_));
-            }
+            col.type_ = bt_int64;
+            col.int64_ = exchange_type_cast<x_long_long>(data_);
             break;
         case x_unsigned_long_long:
             {
-                std::size_t const bufSize
-                    = std::numeric_limits<unsigned long long>::digits10 + 2;
-                buf_ = new char[bufSize];
-                snprintf(buf_, bufSize, "%" LL_FMT_FLAGS "u",
-                    exchange_type_cast<x_unsigned_long_long>(data_));
+                unsigned long long const val =
+                    exchange_type_cast<x_unsigned_long_long>(data_);
+                if (val <= static_cast<unsigned long long>(
+                        (std::numeric_limits<sqlite3_int64>::max)()))
+                {
+                    col.type_ = bt_int64;
+                    col.int64_ = static_cast<sqlite3_int64>(val);
+                }
+                else
+                {
+                    // too big for SQLite integers, keep it as text
+                    col.type_ = bt_text;
+                    col.data_ = NULL;
+                    col.size_ = snprintf(col.buf_, sizeof(col.buf_),
+                        "%" LL_FMT_FLAGS "u", val);
+                }
             }
             break;
         case x_double:
-            {
-                std::string const s = double_to_cstring(exchange_type_cast<x_double>(data_));
-
-                buf_ = new char[s.size() + 1];
-                std::strcpy(buf_, s.c_str());
-            }
+            col.type_ = bt_double;
+            col.double_ = exchange_type_cast<x_double>(data_);
             break;
         case x_stdtm:
             {
-                std::size_t const bufSize = 20;
-                buf_ = new char[bufSize];
-
-                std::tm& t = exchange_type_cast<x_stdtm>(data_);
-                snprintf(buf_, bufSize, "%d-%02d-%02d %02d:%02d:%02d",
-                    t.tm_year + 1900, t.tm_mon + 1, t.tm_mday,
-                    t.tm_hour, t.tm_min, t.tm_sec);
+                std::tm const& t = exchange_type_cast<x_stdtm>(data_);
+                col.type_ = bt_text;
+                col.data_ = NULL;
+                col.size_ = format_std_tm(t, col.buf_, sizeof(col.buf_));
             }
             break;
         case x_rowid:
@@ -168,11 +158,8 @@ void sqlite3_standard_use_type_backend::pre_use(indicator const * ind)
                 sqlite3_rowid_backend *rbe =
 static_cast<sqlite3_rowid_backend *>(rid->get_backend());
 
-                std::size_t const bufSize
-                    = std::numeric_limits<unsigned long>::digits10 + 2;
-                buf_ = new char[bufSize];
-
-                snprintf(buf_, bufSize, "%lu", rbe->value_);
+                col.type_ = bt_int64;
+                col.int64_ = rbe->value_;
             }
             break;
         case x_blob:
@@ -181,24 +168,16 @@ static_cast<sqlite3_rowid_backend *>(rid->get_backend());
                 sqlite3_blob_backend *bbe =
                     static_cast<sqlite3_blob_backend *>(b->get_backend());
 
-                std::size_t len = bbe->get_len();
-                buf_ = new char[len];
-                bbe->read(0, buf_, len);
-                statement_.useData_[0][pos].blobBuf_ = buf_;
-                statement_.useData_[0][pos].blobSize_ = len;
+                // an empty blob must still be bound as a non-null value
+                std::size_t const len = bbe->get_len();
+                col.type_ = bt_blob;
+                col.data_ = len != 0 ? bbe->get_buffer() : "";
+                col.size_ = len;
             }
             break;
         default:
             throw soci_error("Use element used with non-supported type.");
         }
-
-        statement_.useData_[0][pos].isNull_ = false;
-        if (type_ != x_blob)
-        {
-            statement_.useData_[0][pos].blobBuf_ = 0;
-            statement_.useData_[0][pos].blobSize_ = 0;
-            statement_.useData_[0][pos].data_ = buf_;
-        }
     }
 }
 
@@ -216,17 +195,9 @@ void sqlite3_standard_use_type_backend::post_use(
     //          and executed a query that attempted to modified it)
     // - false: the modification should be propagated to the given object.
     // ...
-
-    // clean up the working buffer, it might be allocated anew in
-    // the next run of preUse
-    clean_up();
 }
 
 void sqlite3_standard_use_type_backend::clean_up()
 {
-    if (buf_ != NULL)
-    {
-        delete [] buf_;
-        buf_ = NULL;
-    }
+    // ...
 }
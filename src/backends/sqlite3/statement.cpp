@@ -22,8 +22,8 @@ sqlite3_statement_backend::sqlite3_statement_backend(
     sqlite3_session_backend &session)
     : session_(session)
     , stmt_(0)
-    , dataCache_()
     , useData_(0)
+    , numberOfRows_(0)
     , databaseReady_(false)
     , boundByName_(false)
     , boundByPos_(false)
@@ -90,7 +90,6 @@ statement_backend::exec_fetch_result
 sqlite3_statement_backend::load_rowset(int totalRows)
 {
     statement_backend::exec_fetch_result retVal = ef_success;
-    int numCols = -1;
     int i = 0;
 
     if (!databaseReady_)
@@ -99,8 +98,16 @@ sqlite3_statement_backend::load_rowset(int totalRows)
     }
     else
     {
-        // make the vector big enough to hold the data we need
-        dataCache_.resize(totalRows);
+        // make sure the into vectors are big enough to hold the data we
+        // need, they are shrunk to the number of rows actually read later
+        std::size_t const intosCount = vectorIntos_.size();
+        for (std::size_t n = 0; n != intosCount; ++n)
+        {
+            if (vectorIntos_[n]->size() < static_cast<std::size_t>(totalRows))
+            {
+                vectorIntos_[n]->resize(totalRows);
+            }
+        }
 
         for (i = 0; i < totalRows && databaseReady_; ++i)
         {
@@ -114,32 +121,14 @@ sqlite3_statement_backend::load_rowset(int totalRows)
             }
             else if (SQLITE_ROW == res)
             {
-                // only need to set the number of columns once
-                if (-1 == numCols)
+                for (std::size_t n = 0; n != intosCount; ++n)
                 {
-                    numCols = sqlite3_column_count(stmt_);
-                    for (sqlite3_recordset::iterator it = dataCache_.begin(),
-                         end = dataCache_.end(); it != end; ++it)
-                    {
-                        (*it).resize(numCols);
-                    }
-                }
-                for (int c = 0; c < numCols; ++c)
-                {
-                    char const* buf =
-                        reinterpret_cast<char const*>(sqlite3_column_text(stmt_, c));
-                    bool isNull = false;
-                    if (0 == buf)
-                    {
-                        isNull = true;
-                        buf = "";
-                    }
-                    dataCache_[i][c].data_ = buf;
-                    dataCache_[i][c].isNull_ = isNull;
+                    vectorIntos_[n]->fetch_row(i);
                 }
             }
             else
             {
+                numberOfRows_ = 0;
                 clean_up();
                 char const* zErrMsg = sqlite3_errmsg(session_.conn_);
                 std::ostringstream ss;
@@ -149,8 +138,8 @@ sqlite3_statement_backend::load_rowset(int totalRows)
             }
         }
     }
-    // if we read less than requested then shrink the vector
-    dataCache_.resize(i);
+
+    numberOfRows_ = i;
 
     return retVal;
 }
@@ -161,6 +150,8 @@ sqlite3_statement_backend::load_one()
 {
     statement_backend::exec_fetch_result retVal = ef_success;
 
+    numberOfRows_ = 0;
+
     int const res = sqlite3_step(stmt_);
 
     if (SQLITE_DONE == res)
@@ -170,6 +161,19 @@ sqlite3_statement_backend::load_one()
     }
     else if (SQLITE_ROW == res)
     {
+        numberOfRows_ = 1;
+
+        // into vectors of size 1 still need to be filled, while the
+        // standard into elements read the current row directly
+        std::size_t const intosCount = vectorIntos_.size();
+        for (std::size_t n = 0; n != intosCount; ++n)
+        {
+            if (vectorIntos_[n]->size() == 0)
+            {
+                vectorIntos_[n]->resize(1);
+            }
+            vectorIntos_[n]->fetch_row(0);
+        }
     }
     else
     {
@@ -204,23 +208,30 @@ sqlite3_statement_backend::bind_and_execute(int number)
         {
             int bindRes = SQLITE_OK;
             const sqlite3_column& curCol = useData_[row][pos-1];
-            if (curCol.isNull_)
+            switch (curCol.type_)
             {
+            case bt_null:
                 bindRes = sqlite3_bind_null(stmt_, pos);
-            }
-            else if (curCol.blobBuf_)
-            {
-                bindRes = sqlite3_bind_blob(stmt_, pos,
-                                            curCol.blobBuf_,
-                                            static_cast<int>(curCol.blobSize_),
-                                            SQLITE_STATIC);
-            }
-            else
-            {
+                break;
+            case bt_int64:
+                bindRes = sqlite3_bind_int64(stmt_, pos, curCol.int64_);
+                break;
+            case bt_double:
+                bindRes = sqlite3_bind_double(stmt_, pos, curCol.double_);
+                break;
+            case bt_text:
                 bindRes = sqlite3_bind_text(stmt_, pos,
-                                            curCol.data_.c_str(),
-                                            static_cast<int>(curCol.data_.length()),
+                                            curCol.data_ ? curCol.data_
+                                                         : curCol.buf_,
+                                            static_cast<int>(curCol.size_),
                                             SQLITE_STATIC);
+                break;
+            case bt_blob:
+                bindRes = sqlite3_bind_blob(stmt_, pos,
+                                            curCol.data_,
+                                            static_cast<int>(curCol.size_),
+                                            SQLITE_STATIC);
+                break;
             }
 
             if (SQLITE_OK != bindRes)
@@ -283,6 +294,20 @@ sqlite3_statement_backend::fetch(int number)
     return load_rowset(number);
 }
 
+void sqlite3_statement_backend::reset()
+{
+    // an active statement would keep the database locked, so make sure we
+    // don't leave it in this state
+    if (stmt_)
+    {
+        sqlite3_reset(stmt_);
+        databaseReady_ = true;
+    }
+
+    numberOfRows_ = 0;
+    rowsAffectedBulk_ = -1LL;
+}
+
 long long sqlite3_statement_backend::get_affected_rows()
 {
     if (rowsAffectedBulk_ >= 0)
@@ -294,7 +319,7 @@ long long sqlite3_statement_backend::get_affected_rows()
 
 int sqlite3_statement_backend::get_number_of_rows()
 {
-    return static_cast<int>(dataCache_.size());
+    return numberOfRows_;
 }
 
 std::string sqlite3_statement_backend::rewrite_for_procedure_call(
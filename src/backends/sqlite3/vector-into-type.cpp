@@ -10,16 +10,19 @@
 #include "soci-cstrtod.h"
 #include "common.h"
 // std
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdlib>
 #include <ctime>
+#include <limits>
 #include <string>
 #include <vector>
 
 using namespace soci;
 using namespace soci::details;
 using namespace soci::details::sqlite3;
+using namespace sqlite_api;
 
 void sqlite3_vector_into_type_backend::define_by_pos(
     int& position, void* data, exchange_type type)
@@ -27,6 +30,14 @@ void sqlite3_vector_into_type_backend::define_by_pos(
     data_ = data;
     type_ = type;
     position_ = position++;
+
+    // register with the statement to be filled directly as rows are read
+    std::vector<sqlite3_vector_into_type_backend*>& intos =
+        statement_.vectorIntos_;
+    if (std::find(intos.begin(), intos.end(), this) == intos.end())
+    {
+        intos.push_back(this);
+    }
 }
 
 void sqlite3_vector_into_type_backend::pre_fetch()
@@ -47,100 +58,158 @@ void set_in_vector(void* p, int indx, T const& val)
     v[indx] = val;
 }
 
-} // namespace anonymous
+char const* get_text_column(sqlite3_stmt* stmt, int pos)
+{
+    char const* buf =
+        reinterpret_cast<char const*>(sqlite3_column_text(stmt, pos));
 
-void sqlite3_vector_into_type_backend::post_fetch(bool gotData, indicator * ind)
+    // set buf to a null string if a null pointer is returned
+    return buf != NULL ? buf : "";
+}
+
+// Values stored as integers are read directly, anything else is parsed
+// from its text representation.
+template <typename T>
+T get_integer_column(sqlite3_stmt* stmt, int pos, int colType)
 {
-    if (!gotData)
+    if (colType == SQLITE_INTEGER)
     {
-        // no data retrieved
-        return;
+        sqlite3_int64 const val = sqlite3_column_int64(stmt, pos);
+
+        T const max = (std::numeric_limits<T>::max)();
+        T const min = (std::numeric_limits<T>::min)();
+        if (val > static_cast<sqlite3_int64>(max) ||
+            val < static_cast<sqlite3_int64>(min))
+        {
+            throw soci_error("Cannot convert data.");
+        }
+
+        return static_cast<T>(val);
     }
 
-    int const endRow = static_cast<int>(statement_.dataCache_.size());
-    for (int i = 0; i < endRow; ++i)
-    {
-        sqlite3_column const& curCol =
-            statement_.dataCache_[i][position_-1];
+    return string_to_integer<T>(get_text_column(stmt, pos));
+}
 
-        if (curCol.isNull_)
-        {
-            if (ind == NULL)
-            {
-                throw soci_error(
-                    "Null value fetched and no indicator defined.");
-            }
-            ind[i] = i_null;
+} // namespace anonymous
 
-            // no need to convert data if it is null, go to next row
-            continue;
-        }
-        else
-        {
-            if (ind != NULL)
-            {
-                ind[i] = i_ok;
-            }
-        }
+void sqlite3_vector_into_type_backend::fetch_row(int row)
+{
+    sqlite3_stmt* const stmt = statement_.stmt_;
 
-        const char * buf = curCol.data_.c_str();
+    // sqlite columns start at 0
+    int const pos = position_ - 1;
 
-        // set buf to a null string if a null pointer is returned
-        if (buf == NULL)
+    if (indicators_.size() <= static_cast<std::size_t>(row))
+    {
+        indicators_.resize(row + 1);
+    }
+
+    int const colType = sqlite3_column_type(stmt, pos);
+    if (colType == SQLITE_NULL)
+    {
+        // the error, if any, is reported by post_fetch() which knows
+        // whether an indicator was provided
+        indicators_[row] = i_null;
+        return;
+    }
+
+    indicators_[row] = i_ok;
+
+    switch (type_)
+    {
+    case x_char:
+        set_in_vector(data_, row, *get_text_column(stmt, pos));
+        break;
+    case x_stdstring:
         {
-            buf = "";
+            char const* const buf = get_text_column(stmt, pos);
+            std::vector<std::string>& v =
+                *static_cast<std::vector<std::string>*>(data_);
+            v[row].assign(buf, sqlite3_column_bytes(stmt, pos));
         }
-
-        switch (type_)
+        break;
+    case x_short:
+        set_in_vector(data_, row,
+            get_integer_column<short>(stmt, pos, colType));
+        break;
+    case x_integer:
+        set_in_vector(data_, row,
+            get_integer_column<int>(stmt, pos, colType));
+        break;
+    case x_long_long:
+        set_in_vector(data_, row,
+            get_integer_column<long long>(stmt, pos, colType));
+        break;
+    case x_unsigned_long_long:
         {
-        case x_char:
-            set_in_vector(data_, i, *buf);
-            break;
-        case x_stdstring:
-            set_in_vector<std::string>(data_, i, buf);
-            break;
-        case x_short:
+            unsigned long long val;
+            if (colType == SQLITE_INTEGER &&
+                    sqlite3_column_int64(stmt, pos) >= 0)
             {
-                short const val = string_to_integer<short>(buf);
-                set_in_vector(data_, i, val);
+                val = static_cast<unsigned long long>(
+                    sqlite3_column_int64(stmt, pos));
             }
-            break;
-        case x_integer:
+            else
             {
-                int const val = string_to_integer<int>(buf);
-                set_in_vector(data_, i, val);
+                val = string_to_unsigned_integer<unsigned long long>(
+                    get_text_column(stmt, pos));
             }
-            break;
-        case x_long_long:
-            {
-                long long const val = string_to_integer<long long>(buf);
-                set_in_vector(data_, i, val);
-            }
-            break;
-        case x_unsigned_long_long:
+            set_in_vector(data_, row, val);
+        }
+        break;
+    case x_double:
+        {
+            double val;
+            if (colType == SQLITE_INTEGER || colType == SQLITE_FLOAT)
             {
-                unsigned long long const val
-                    = string_to_unsigned_integer<unsigned long long>(buf);
-                set_in_vector(data_, i, val);
+                val = sqlite3_column_double(stmt, pos);
             }
-            break;
-        case x_double:
+            else
             {
-                double const val = cstring_to_double(buf);
-                set_in_vector(data_, i, val);
+                val = cstring_to_double(get_text_column(stmt, pos));
             }
-            break;
-        case x_stdtm:
-            {
-                // attempt to parse the string and convert to std::tm
-                std::tm t;
-                parse_std_tm(buf, t);
+            set_in_vector(data_, row, val);
+        }
+        break;
+    case x_stdtm:
+        {
+            // attempt to parse the string and convert to std::tm
+            std::tm t;
+            parse_std_tm(get_text_column(stmt, pos), t);
 
-                set_in_vector(data_, i, t);
+            set_in_vector(data_, row, t);
+        }
+        break;
+    default:
+        throw soci_error("Into element used with non-supported type.");
+    }
+}
+
+void sqlite3_vector_into_type_backend::post_fetch(bool gotData, indicator * ind)
+{
+    if (!gotData)
+    {
+        // no data retrieved
+        return;
+    }
+
+    // the values themselves were already stored by fetch_row(), only the
+    // indicators remain to be dealt with
+    int const endRow = statement_.numberOfRows_;
+    for (int i = 0; i < endRow; ++i)
+    {
+        if (indicators_[i] == i_null)
+        {
+            if (ind == NULL)
+            {
+                throw soci_error(
+                    "Null value fetched and no indicator defined.");
             }
-            break;
-        default:
-            throw soci_error("Into element used with non-supported type.");
+            ind[i] = i_null;
+        }
+        else if (ind != NULL)
+        {
+            ind[i] = i_ok;
         }
     }
 }
@@ -218,5 +287,7 @@ std::size_t sqlite3_vector_into_type_backend::size()
 
 void sqlite3_vector_into_type_backend::clean_up()
 {
-    // ...
+    std::vector<sqlite3_vector_into_type_backend*>& intos =
+        statement_.vectorIntos_;
+    intos.erase(std::remove(intos.begin(), intos.end(), this), intos.end());
 }
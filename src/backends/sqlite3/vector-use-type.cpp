@@ -7,14 +7,14 @@
 
 #include "soci/sqlite3/soci-sqlite3.h"
 #include "soci/soci-platform.h"
-#include "soci-dtocstr.h"
 #include "common.h"
 // std
 #include <cstdio>
-#include <cstdlib>
-#include <cstring>
+#include <ctime>
 #include <limits>
 #include <sstream>
+#include <string>
+#include <vector>
 
 #ifdef _MSC_VER
 #pragma warning(disable:4355 4996)
@@ -24,6 +24,7 @@
 using namespace soci;
 using namespace soci::details;
 using namespace soci::details::sqlite3;
+using namespace sqlite_api;
 
 void sqlite3_vector_use_type_backend::bind_by_pos(int & position,
                                             void * data,
@@ -68,6 +69,18 @@ void sqlite3_vector_use_type_backend::bind_by_name(std::string const & name,
     statement_.boundByName_ = true;
 }
 
+namespace // anonymous
+{
+
+template <typename T>
+T const& get_in_vector(void* p, std::size_t indx)
+{
+    std::vector<T> const& v = *static_cast<std::vector<T>*>(p);
+    return v[indx];
+}
+
+} // namespace anonymous
+
 void sqlite3_vector_use_type_backend::pre_use(indicator const * ind)
 {
     std::size_t const vsize = size();
@@ -82,138 +95,85 @@ void sqlite3_vector_use_type_backend::pre_use(indicator const * ind)
 
     for (size_t i = 0; i != vsize; ++i)
     {
-        char *buf = 0;
-
         // make sure that each row can accomodate the number of columns
         if (statement_.useData_[i].size() < static_cast<std::size_t>(position_))
         {
             statement_.useData_[i].resize(position_);
         }
 
+        sqlite3_column& col = statement_.useData_[i][pos];
+
         // the data in vector can be either i_ok or i_null
         if (ind != NULL && ind[i] == i_null)
         {
-            statement_.useData_[i][pos].isNull_ = true;
-            statement_.useData_[i][pos].data_ = "";
-            statement_.useData_[i][pos].blobBuf_ = 0;
-            statement_.useData_[i][pos].blobSize_ = 0;
+            col.type_ = bt_null;
+            continue;
         }
-        else
+
+        // bind the numbers natively and the strings without copying them
+        switch (type_)
         {
-            // allocate and fill the buffer with text-formatted client data
-            switch (type_)
+        case x_char:
             {
-            case x_char:
-                {
-                    std::vector<char> *pv
-                        = static_cast<std::vector<char> *>(data_);
-                    std::vector<char> &v = *pv;
-
-                    buf = new char[2];
-                    buf[0] = v[i];
-                    buf[1] = '\0';
-                }
-                break;
-            case x_stdstring:
-                {
-                    std::vector<std::string> *pv
-                        = static_cast<std::vector<std::string> *>(data_);
-                    std::vector<std::string> &v = *pv;
-
-                    buf = new char[v[i].size() + 1];
-                    std::strcpy(buf, v[i].c_str());
-                }
-                break;
-            case x_short:
-                {
-                    std::vector<short> *pv
-                        = static_cast<std::vector<short> *>(data_);
-                    std::vector<short> &v = *pv;
-
-                    std::size_t const bufSize
-                        = std::numeric_limits<short>::digits10 + 3;
-                    buf = new char[bufSize];
-                    snprintf(buf, bufSize, "%d", static_cast<int>(v[i]));
-                }
-                break;
-            case x_integer:
-                {
-                    std::vector<int> *pv
-                        = static_cast<std::vector<int> *>(data_);
-                    std::vector<int> &v = *pv;
-
-                    std::size_t const bufSize
-                        = std::numeric_limits<int>::digits10 + 3;
-                    buf = new char[bufSize];
-                    snprintf(buf, bufSize, "%d", v[i]);
-                }
-                break;
-            case x_long_long:
-                {
-                    std::vector<long long> *pv
-                        = static_cast<std::vector<long long> *>(data_);
-                    std::vector<long long> &v = *pv;
-
-                    std::size_t const bufSize
-                        = std::numeric_limits<long long>::digits10 + 3;
-                    buf = new char[bufSize];
-                    snprintf(buf, bufSize, "%" LL_FMT_FLAGS "d", v[i]);
-                }
-                break;
-            case x_unsigned_long_long:
-                {
-                    std::vector<unsigned long long>* pv
-                        = static_cast<std::vector<unsigned long long>*>(data_);
-                    std::vector<unsigned long long>& v = *pv;
-
-                    std::size_t const bufSize
-                        = std::numeric_limits<unsigned long long>::digits10 + 2;
-                    buf = new char[bufSize];
-                    snprintf(buf, bufSize, "%" LL_FMT_FLAGS "u", v[i]);
-                }
-                break;
-            case x_double:
+                char const& c = get_in_vector<char>(data_, i);
+                col.type_ = bt_text;
+                col.data_ = &c;
+                col.size_ = c != '\0' ? 1 : 0;
+            }
+            break;
+        case x_stdstring:
+            {
+                std::string const& s = get_in_vector<std::string>(data_, i);
+                col.type_ = bt_text;
+                col.data_ = s.c_str();
+                col.size_ = s.size();
+            }
+            break;
+        case x_short:
+            col.type_ = bt_int64;
+            col.int64_ = get_in_vector<short>(data_, i);
+            break;
+        case x_integer:
+            col.type_ = bt_int64;
+            col.int64_ = get_in_vector<int>(data_, i);
+            break;
+        case x_long_long:
+            col.type_ = bt_int64;
+            col.int64_ = get_in_vector<long long>(data_, i);
+            break;
+        case x_unsigned_long_long:
+            {
+                unsigned long long const val =
+                    get_in_vector<unsigned long long>(data_, i);
+                if (val <= static_cast<unsigned long long>(
+                        (std::numeric_limits<sqlite3_int64>::max)()))
                 {
-                    // no need to overengineer it (KISS)...
-
-                    std::vector<double> *pv
-                        = static_cast<std::vector<double> *>(data_);
-                    std::vector<double> &v = *pv;
-
-                    std::string const s = double_to_cstring(v[i]);
-
-                    buf = new char[s.size() + 1];
-                    std::strcpy(buf, s.c_str());
+                    col.type_ = bt_int64;
+                    col.int64_ = static_cast<sqlite3_int64>(val);
                 }
-                break;
-            case x_stdtm:
+                else
                 {
-                    std::vector<std::tm> *pv
-                        = static_cast<std::vector<std::tm> *>(data_);
-                    std::vector<std::tm> &v = *pv;
-
-                    std::size_t const bufSize = 20;
-                    buf = new char[bufSize];
-
-                    snprintf(buf, bufSize, "%d-%02d-%02d %02d:%02d:%02d",
-                        v[i].tm_year + 1900, v[i].tm_mon + 1, v[i].tm_mday,
-                        v[i].tm_hour, v[i].tm_min, v[i].tm_sec);
+                    // too big for SQLite integers, keep it as text
+                    col.type_ = bt_text;
+                    col.data_ = NULL;
+                    col.size_ = snprintf(col.buf_, sizeof(col.buf_),
+                        "%" LL_FMT_FLAGS "u", val);
                 }
-                break;
-            default:
-                throw soci_error(
-                    "Use vector element used with non-supported type.");
             }
-
-            statement_.useData_[i][pos].isNull_ = false;
-            statement_.useData_[i][pos].data_ = buf;
-            statement_.useData_[i][pos].blobBuf_ = 0;
-            statement_.useData_[i][pos].blobSize_ = 0;
-        }
-
-        if (buf)
-        {
-            delete [] buf;
+            break;
+        case x_double:
+            col.type_ = bt_double;
+            col.double_ = get_in_vector<double>(data_, i);
+            break;
+        case x_stdtm:
+            col.type_ = bt_text;
+            col.data_ = NULL;
+            col.size_ = format_std_tm(get_in_vector<std::tm>(data_, i),
+                col.buf_, sizeof(col.buf_));
+            break;
+        default:
+            throw soci_error(
+                "Use vector element used with non-supported type.");
         }
     }
 }
@@ -0,0 +1,589 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_SOURCE
+#include "soci/async.h"
+#include "soci/error.h"
+#include "soci/session.h"
+
+#ifndef _WIN32
+#include <poll.h>
+#else
+// this must be included before windows.h included by threading.h
+#include <winsock2.h>
+#endif
+
+#include "threading.h"
+#include <deque>
+#include <exception>
+#include <string>
+
+using namespace soci;
+using namespace soci::details;
+using namespace soci::details::threading;
+
+namespace // anonymous
+{
+
+// the opposite of scoped_lock, releasing the mutex temporarily
+class scoped_unlock
+{
+public:
+    explicit scoped_unlock(mutex & m) : m_(m) { m_.unlock(); }
+    ~scoped_unlock() { m_.lock(); }
+
+private:
+    mutex & m_;
+
+    scoped_unlock(scoped_unlock const &);
+    scoped_unlock & operator=(scoped_unlock const &);
+};
+
+// copy of the exception being handled, preserving the type of soci_error and
+// the classes deriving from it, or NULL if it can't be copied, this must be
+// called from a catch block
+soci_error * capture_error()
+{
+    try
+    {
+        try
+        {
+            throw;
+        }
+        catch (soci_error const & e)
+        {
+            return e.clone();
+        }
+        catch (std::exception const & e)
+        {
+            return new soci_error(e.what());
+        }
+        catch (...)
+        {
+            return new soci_error("Unknown error in asynchronous operation");
+        }
+    }
+    catch (...)
+    {
+        return NULL;
+    }
+}
+
+// wait until the socket becomes readable or writable, depending on status,
+// during at most the given number of milliseconds or indefinitely if it is
+// negative, the errors are reported by the next step of the operation
+void wait_for_socket(int socket, step_status status, int timeout)
+{
+    if (socket < 0)
+    {
+        // there is nothing to watch, just advance the operation periodically
+        if (timeout < 0 || timeout > 10)
+        {
+            timeout = 10;
+        }
+    }
+
+#ifndef _WIN32
+    struct pollfd fd;
+    fd.fd = socket;
+    fd.events = status == step_wait_write ? POLLOUT : POLLIN;
+    fd.revents = 0;
+
+    poll(&fd, socket < 0 ? 0 : 1, timeout);
+#else
+    if (socket < 0)
+    {
+        Sleep(static_cast<DWORD>(timeout));
+        return;
+    }
+
+    fd_set fds;
+    FD_ZERO(&fds);
+    FD_SET(static_cast<SOCKET>(socket), &fds);
+
+    struct timeval tv;
+    tv.tv_sec = timeout / 1000;
+    tv.tv_usec = (timeout % 1000) * 1000;
+
+    select(0, status == step_wait_write ? NULL : &fds,
+        status == step_wait_write ? &fds : NULL, NULL,
+        timeout < 0 ? NULL : &tv);
+#endif // _WIN32
+}
+
+extern "C" SOCI_THREAD_ENTRY(worker_thread_entry, arg);
+
+} // namespace anonymous
+
+namespace soci
+{
+namespace details
+{
+
+class async_state
+{
+public:
+    // the state is created with a reference for the worker and another one
+    // for the async_result returned to the caller
+    explicit async_state(async_worker::async_worker_impl & worker)
+        : worker_(worker), refCount_(2), done_(false), failed_(false),
+          result_(false), error_(NULL) {}
+
+    ~async_state() { delete error_; }
+
+    void inc_ref()
+    {
+        scoped_lock lock(mtx_);
+        ++refCount_;
+    }
+
+    void dec_ref()
+    {
+        bool last;
+        {
+            scoped_lock lock(mtx_);
+            last = --refCount_ == 0;
+        }
+
+        if (last)
+        {
+            delete this;
+        }
+    }
+
+    void set_result(bool result)
+    {
+        scoped_lock lock(mtx_);
+        result_ = result;
+        done_ = true;
+    }
+
+    // takes ownership of the error, which may be NULL if it couldn't be
+    // copied
+    void set_error(soci_error * error)
+    {
+        scoped_lock lock(mtx_);
+        error_ = error;
+        failed_ = true;
+        done_ = true;
+    }
+
+    bool is_done()
+    {
+        scoped_lock lock(mtx_);
+        return done_;
+    }
+
+    // these functions advance the operations of the worker if needed
+    bool is_ready();
+    bool wait(int timeout);
+    bool get();
+
+private:
+    // only used until the operation is done, the worker can be destroyed
+    // after this
+    async_worker::async_worker_impl & worker_;
+
+    mutex mtx_;
+
+    int refCount_;
+    bool done_;
+    bool failed_;
+    bool result_;
+    soci_error * error_;
+};
+
+struct async_operation
+{
+    async_operation(async_task * task, async_state * state)
+        : task_(task), state_(state), started_(false), threaded_(false),
+          status_(step_done) {}
+
+    async_task * task_;
+    async_state * state_;
+
+    // true if the task was started without blocking, in which case status_
+    // indicates what to wait for before its next step, or if it is executed
+    // by the background thread
+    bool started_;
+    bool threaded_;
+    step_status status_;
+};
+
+struct async_worker::async_worker_impl
+{
+    explicit async_worker_impl(session & s)
+        : session_(s), stop_(false), threadStarted_(false) {}
+
+    // Advance the operations at the front of the queue as far as possible
+    // without blocking: complete the ones executed without blocking which
+    // are ready and start the next one or pass it to the background thread.
+    // The mutex must be locked.
+    void advance()
+    {
+        while (queue_.empty() == false)
+        {
+            async_operation & op = queue_.front();
+            if (op.threaded_)
+            {
+                // the background thread will continue when it completes
+                return;
+            }
+
+            try
+            {
+                if (op.started_)
+                {
+                    op.status_ = op.task_->step();
+                }
+                else if (op.task_->start(op.status_))
+                {
+                    op.started_ = true;
+                }
+                else
+                {
+                    if (threadStarted_ == false)
+                    {
+                        thread_ = start_thread(worker_thread_entry, this);
+                        threadStarted_ = true;
+                    }
+
+                    op.threaded_ = true;
+                    cond_.notify_all();
+                    return;
+                }
+
+                if (op.status_ != step_done)
+                {
+                    return;
+                }
+
+                op.state_->set_result(op.task_->result());
+            }
+            catch (...)
+            {
+                op.state_->set_error(capture_error());
+            }
+
+            pop_front();
+        }
+    }
+
+    // remove the completed operation at the front of the queue, the mutex
+    // must be locked
+    void pop_front()
+    {
+        async_operation const op = queue_.front();
+        queue_.pop_front();
+
+        delete op.task_;
+        op.state_->dec_ref();
+
+        cond_.notify_all();
+    }
+
+    // Wait until the given operation, or all of them if it's NULL, completes
+    // or the deadline passes, if it's not negative, and return true in the
+    // former case. The deadline is in the units of get_ticks().
+    bool wait_for(async_state * state, long long deadline)
+    {
+        scoped_lock lock(mtx_);
+        for (;;)
+        {
+            advance();
+
+            if (state != NULL ? state->is_done() : queue_.empty())
+            {
+                return true;
+            }
+
+            int timeout = -1;
+            if (deadline >= 0)
+            {
+                long long const now = get_ticks();
+                if (now >= deadline)
+                {
+                    return false;
+                }
+
+                timeout = static_cast<int>(deadline - now);
+            }
+
+            // the operation waited for is still in the queue, so it's not
+            // empty and its front was started by advance() or passed to the
+            // background thread
+            async_operation const & op = queue_.front();
+            if (op.threaded_)
+            {
+                if (timeout < 0)
+                {
+                    cond_.wait(mtx_);
+                }
+                else
+                {
+                    cond_.wait(mtx_, timeout);
+                }
+            }
+            else
+            {
+                int const socket = get_socket();
+                step_status const status = op.status_;
+
+                scoped_unlock unlock(mtx_);
+                wait_for_socket(socket, status, timeout);
+            }
+        }
+    }
+
+    int get_socket()
+    {
+        try
+        {
+            return session_.get_socket();
+        }
+        catch (...)
+        {
+            return -1;
+        }
+    }
+
+    // body of the background thread executing the operations which can't be
+    // executed without blocking
+    void run()
+    {
+        scoped_lock lock(mtx_);
+        for (;;)
+        {
+            while (stop_ == false &&
+                (queue_.empty() || queue_.front().threaded_ == false))
+            {
+                cond_.wait(mtx_);
+            }
+
+            if (stop_)
+            {
+                // all the operations have been completed
+                return;
+            }
+
+            // nothing else removes this operation from the queue
+            async_operation & op = queue_.front();
+            {
+                scoped_unlock unlock(mtx_);
+                try
+                {
+                    op.state_->set_result(op.task_->run());
+                }
+                catch (...)
+                {
+                    op.state_->set_error(capture_error());
+                }
+            }
+
+            pop_front();
+            advance();
+        }
+    }
+
+    session & session_;
+
+    std::deque<async_operation> queue_;
+    mutex mtx_;
+    condition cond_;
+    bool stop_;
+
+    bool threadStarted_;
+    thread_handle thread_;
+};
+
+bool async_state::is_ready()
+{
+    if (is_done() == false)
+    {
+        scoped_lock lock(worker_.mtx_);
+        worker_.advance();
+    }
+
+    return is_done();
+}
+
+bool async_state::wait(int timeout)
+{
+    if (is_done())
+    {
+        return true;
+    }
+
+    // the deadline is computed only once as waiting for the events of the
+    // operation may need to be repeated several times
+    return worker_.wait_for(this, timeout < 0 ? -1 : get_ticks() + timeout);
+}
+
+bool async_state::get()
+{
+    wait(-1);
+
+    scoped_lock lock(mtx_);
+    if (failed_)
+    {
+        if (error_ == NULL)
+        {
+            throw soci_error("Unknown error in asynchronous operation");
+        }
+
+        error_->rethrow();
+    }
+
+    return result_;
+}
+
+} // namespace details
+} // namespace soci
+
+namespace // anonymous
+{
+
+extern "C" SOCI_THREAD_ENTRY(worker_thread_entry, arg)
+{
+    static_cast<async_worker::async_worker_impl *>(arg)->run();
+    SOCI_THREAD_RETURN;
+}
+
+} // namespace anonymous
+
+async_worker::async_worker(session & s)
+    : pimpl_(new async_worker_impl(s))
+{
+}
+
+async_worker::~async_worker()
+{
+    pimpl_->wait_for(NULL, -1);
+
+    if (pimpl_->threadStarted_)
+    {
+        {
+            scoped_lock lock(pimpl_->mtx_);
+            pimpl_->stop_ = true;
+            pimpl_->cond_.notify_all();
+        }
+
+        join_thread(pimpl_->thread_);
+    }
+
+    delete pimpl_;
+}
+
+async_state * async_worker::submit(async_task * task)
+{
+    async_state * state;
+    try
+    {
+        state = new async_state(*pimpl_);
+    }
+    catch (...)
+    {
+        delete task;
+        throw;
+    }
+
+    scoped_lock lock(pimpl_->mtx_);
+    try
+    {
+        pimpl_->queue_.push_back(async_operation(task, state));
+    }
+    catch (...)
+    {
+        delete task;
+        delete state;
+        throw;
+    }
+
+    // start executing it right now if possible
+    pimpl_->advance();
+
+    return state;
+}
+
+void async_worker::wait_all()
+{
+    pimpl_->wait_for(NULL, -1);
+}
+
+async_result::async_result()
+    : state_(NULL)
+{
+}
+
+async_result::async_result(async_state * state)
+    : state_(state)
+{
+}
+
+async_result::async_result(async_result const & other)
+    : state_(other.state_)
+{
+    if (state_ != NULL)
+    {
+        state_->inc_ref();
+    }
+}
+
+async_result & async_result::operator=(async_result const & other)
+{
+    if (other.state_ != NULL)
+    {
+        other.state_->inc_ref();
+    }
+
+    if (state_ != NULL)
+    {
+        state_->dec_ref();
+    }
+
+    state_ = other.state_;
+
+    return *this;
+}
+
+async_result::~async_result()
+{
+    if (state_ != NULL)
+    {
+        state_->dec_ref();
+    }
+}
+
+bool async_result::is_ready() const
+{
+    if (state_ == NULL)
+    {
+        throw soci_error("No asynchronous operation");
+    }
+
+    return state_->is_ready();
+}
+
+bool async_result::wait(int timeout) const
+{
+    if (state_ == NULL)
+    {
+        throw soci_error("No asynchronous operation");
+    }
+
+    return state_->wait(timeout);
+}
+
+bool async_result::get() const
+{
+    if (state_ == NULL)
+    {
+        throw soci_error("No asynchronous operation");
+    }
+
+    return state_->get();
+}
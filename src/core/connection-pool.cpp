@@ -9,213 +9,826 @@
 #include "soci/connection-pool.h"
 #include "soci/error.h"
 #include "soci/session.h"
-#include <vector>
+#include "threading.h"
+#include <algorithm>
+#include <cassert>
+#include <deque>
+#include <exception>
+#include <string>
 #include <utility>
+#include <vector>
 
-#ifndef _WIN32
-// POSIX implementation
+using namespace soci;
+using namespace soci::details::threading;
 
-#include <pthread.h>
-#include <sys/time.h>
-#include <errno.h>
+namespace // anonymous
+{
 
-using namespace soci;
+// marks the end of the free and closed lists
+std::size_t const no_entry = static_cast<std::size_t>(-1);
 
-struct connection_pool::connection_pool_impl
+// Opens a session of an elastic pool in a separate thread.
+struct session_opener
 {
-    bool find_free(std::size_t & pos)
+    session_opener(session & s, connection_parameters const & parameters)
+        : session_(s), parameters_(parameters), failed_(false), duration_(0) {}
+
+    void run()
     {
-        for (std::size_t i = 0; i != sessions_.size(); ++i)
+        long long const start = get_microseconds();
+        try
         {
-            if (sessions_[i].first)
-            {
-                pos = i;
-                return true;
-            }
+            session_.open(parameters_);
+            duration_ = get_microseconds() - start;
+        }
+        catch (std::exception const & e)
+        {
+            error_ = e.what();
+            failed_ = true;
+        }
+        catch (...)
+        {
+            error_ = "Unknown error while opening pool session";
+            failed_ = true;
         }
-
-        return false;
     }
 
-    // by convention, first == true means the entry is free (not used)
-    std::vector<std::pair<bool, session *> > sessions_;
-    pthread_mutex_t mtx_;
-    pthread_cond_t cond_;
+    session & session_;
+    connection_parameters const & parameters_;
+    bool failed_;
+    std::string error_;
+    long long duration_;
 };
 
-connection_pool::connection_pool(std::size_t size)
+extern "C" SOCI_THREAD_ENTRY(session_opener_entry, arg)
 {
-    if (size == 0)
+    static_cast<session_opener *>(arg)->run();
+    SOCI_THREAD_RETURN;
+}
+
+extern "C" SOCI_THREAD_ENTRY(pool_maintenance_entry, arg);
+
+// the sessions checked less than this number of milliseconds ago are not
+// checked again when they are leased
+long long const validation_bypass_time = 500;
+
+// the maximal interval between the attempts to reconnect a broken session
+int const reconnect_retry_interval = 1000;
+
+// check whether the session, if it's open at all, is usable
+bool is_session_valid(session & s, std::string const & query)
+{
+    if (s.get_backend() == NULL)
     {
-        throw soci_error("Invalid pool size");
+        return true;
     }
 
-    pimpl_ = new connection_pool_impl();
-    pimpl_->sessions_.resize(size);
-    for (std::size_t i = 0; i != size; ++i)
+    if (query.empty())
     {
-        pimpl_->sessions_[i] = std::make_pair(true, new session());
+        return s.is_connected();
     }
 
-    int cc = pthread_mutex_init(&(pimpl_->mtx_), NULL);
-    if (cc != 0)
+    try
     {
-        throw soci_error("Synchronization error");
+        s << query;
     }
-
-    cc = pthread_cond_init(&(pimpl_->cond_), NULL);
-    if (cc != 0)
+    catch (...)
     {
-        throw soci_error("Synchronization error");
+        return false;
     }
+
+    return true;
 }
 
-connection_pool::~connection_pool()
+// reconnect the session and check that it's usable now
+bool reconnect_session(session & s, std::string const & query)
 {
-    for (std::size_t i = 0; i != pimpl_->sessions_.size(); ++i)
+    try
     {
-        delete pimpl_->sessions_[i].second;
+        s.reconnect();
+    }
+    catch (...)
+    {
+        return false;
     }
 
-    pthread_mutex_destroy(&(pimpl_->mtx_));
-    pthread_cond_destroy(&(pimpl_->cond_));
-
-    delete pimpl_;
+    return is_session_valid(s, query);
 }
 
-session & connection_pool::at(std::size_t pos)
+} // namespace anonymous
+
+struct connection_pool::connection_pool_impl
 {
-    if (pos >= pimpl_->sessions_.size())
+    // The free entries are kept in a doubly linked list threaded through the
+    // entries themselves, so that any of them can be taken in constant time.
+    // The entries are given back to the head of the list and leased from it
+    // as well, so that the most recently used, and hence "warmest",
+    // connections are reused first, while the tail of the list contains the
+    // entry unused for the longest time.
+    //
+    // The entries of the elastic pools whose sessions are not open are kept
+    // in a separate singly linked list using the same next_ field.
+    //
+    // A free entry whose session is being checked by the maintenance thread
+    // remains in the free list, but can't be leased. As there is only one
+    // such entry at any time, it can be skipped in constant time too.
+    struct entry
     {
-        throw soci_error("Invalid pool position");
+        enum entry_state
+        {
+            es_free,   // in the free list
+            es_leased, // leased by some thread, which may be opening it
+            es_closed, // in the closed list or being closed
+            es_broken  // waiting to be reconnected or being reconnected
+        };
+
+        entry()
+            : session_(NULL), state_(es_free), checking_(false),
+              prev_(no_entry), next_(no_entry), lastUsed_(0), lastChecked_(0),
+              leasedAt_(0) {}
+
+        session * session_;
+        entry_state state_;
+        bool checking_;
+        std::size_t prev_;
+        std::size_t next_;
+
+        // when the entry was given back for the last time
+        long long lastUsed_;
+
+        // when the session was last known to work
+        long long lastChecked_;
+
+        // when the entry was leased, in microseconds
+        long long leasedAt_;
+    };
+
+    // A thread waiting for a free entry. The entries given back while there
+    // are waiting threads are handed directly to the one waiting for the
+    // longest time, so that the newly arriving threads can't take them
+    // first and the waiting ones are served in FIFO order.
+    struct waiter
+    {
+        waiter() : pos_(no_entry) {}
+
+        condition cond_;
+        std::size_t pos_; // the entry handed to this thread
+    };
+
+    connection_pool_impl()
+        : freeHead_(no_entry), freeTail_(no_entry), freeCount_(0),
+          closedHead_(no_entry), closedCount_(0),
+          threadAffinity_(false),
+          elastic_(false), minSize_(0), idleTimeout_(0),
+          validateOnLease_(false), validationInterval_(0),
+          nextValidation_(0), slowQueryLogSet_(false), slowQuerySink_(NULL),
+          slowQueryThreshold_(0), slowQueryMaxValueLength_(0),
+          brokenCount_(0), nextReconnect_(0),
+          maintenanceStarted_(false), stop_(false) {}
+
+    void push_free(std::size_t pos)
+    {
+        entry & e = entries_[pos];
+        e.state_ = entry::es_free;
+        e.prev_ = no_entry;
+        e.next_ = freeHead_;
+        if (freeHead_ != no_entry)
+        {
+            entries_[freeHead_].prev_ = pos;
+        }
+        else
+        {
+            freeTail_ = pos;
+        }
+
+        freeHead_ = pos;
+        ++freeCount_;
     }
 
-    return *(pimpl_->sessions_[pos].second);
-}
+    void take_free(std::size_t pos)
+    {
+        entry & e = entries_[pos];
+        if (e.prev_ != no_entry)
+        {
+            entries_[e.prev_].next_ = e.next_;
+        }
+        else
+        {
+            freeHead_ = e.next_;
+        }
 
-std::size_t connection_pool::lease()
-{
-    std::size_t pos;
+        if (e.next_ != no_entry)
+        {
+            entries_[e.next_].prev_ = e.prev_;
+        }
+        else
+        {
+            freeTail_ = e.prev_;
+        }
 
-    // no timeout
-    bool const success = try_lease(pos, -1);
-    assert(success);
+        e.state_ = entry::es_leased;
+        e.prev_ = no_entry;
+        e.next_ = no_entry;
+        --freeCount_;
+    }
 
-    return pos;
-}
+    void push_closed(std::size_t pos)
+    {
+        entries_[pos].state_ = entry::es_closed;
+        entries_[pos].next_ = closedHead_;
+        closedHead_ = pos;
+        ++closedCount_;
+    }
 
-bool connection_pool::try_lease(std::size_t & pos, int timeout)
-{
-    struct timespec tm;
-    if (timeout >= 0)
+    std::size_t take_closed()
     {
-        // timeout is relative in milliseconds
+        std::size_t const pos = closedHead_;
+        closedHead_ = entries_[pos].next_;
+        entries_[pos].state_ = entry::es_leased;
+        entries_[pos].next_ = no_entry;
+        --closedCount_;
+
+        return pos;
+    }
+
+    // find the entry to be leased by the current thread, if any is free
+    bool find_free(std::size_t & pos)
+    {
+        if (freeHead_ == no_entry)
+        {
+            return false;
+        }
+
+        pos = freeHead_;
+        if (entries_[pos].checking_)
+        {
+            pos = entries_[pos].next_;
+            if (pos == no_entry)
+            {
+                return false;
+            }
+        }
+
+        if (threadAffinity_)
+        {
+            // the value stored is the position of the entry plus one, so
+            // that it's null if this thread hasn't leased anything yet
+            std::size_t const last =
+                reinterpret_cast<std::size_t>(lastLeased_.get());
+            if (last != 0 && last <= entries_.size() &&
+                entries_[last - 1].state_ == entry::es_free &&
+                entries_[last - 1].checking_ == false)
+            {
+                pos = last - 1;
+            }
+        }
+
+        return true;
+    }
+
+    // Get a free or closed entry, waiting for one until the deadline if the
+    // timeout is positive, and return true and whether its session needs to
+    // be checked before using it, or false if the timeout expired.
+    //
+    // The lease is accounted for in the statistics unless the session needs
+    // to be checked, the time spent waiting for it is returned in this case.
+    bool acquire(std::size_t & pos, int timeout, long long start,
+        long long deadline, bool & validate, long long & waited)
+    {
+        scoped_lock lock(mtx_);
+
+        // sessions opened for this lease don't need to be checked
+        bool opening = false;
+
+        // if there are any free entries, nobody can be waiting for them
+        if (find_free(pos))
+        {
+            take_free(pos);
+        }
+        else if (closedHead_ != no_entry)
+        {
+            // the new session of the elastic pool is opened by the caller
+            pos = take_closed();
+            opening = true;
+        }
+        else if (timeout == 0 || (timeout > 0 && deadline <= get_ticks()))
+        {
+            ++stats_.timeouts;
+            return false;
+        }
+        else
+        {
+            waiter w;
+            waiters_.push_back(&w);
 
-        struct timeval tmv;
-        gettimeofday(&tmv, NULL);
+            ++stats_.waits;
+            if (waiters_.size() > stats_.max_waiters)
+            {
+                stats_.max_waiters = waiters_.size();
+            }
+
+            while (w.pos_ == no_entry)
+            {
+                if (timeout < 0)
+                {
+                    // no timeout, allow unlimited blocking
+                    w.cond_.wait(mtx_);
+                    continue;
+                }
+
+                long long const remaining = deadline - get_ticks();
+                if (remaining <= 0 ||
+                    (w.cond_.wait(mtx_, static_cast<int>(remaining)) == false &&
+                        w.pos_ == no_entry))
+                {
+                    // timed out without getting an entry
+                    waiters_.erase(std::find(waiters_.begin(),
+                        waiters_.end(), &w));
+                    ++stats_.timeouts;
+                    return false;
+                }
+            }
 
-        tm.tv_sec = tmv.tv_sec + timeout / 1000;
-        tm.tv_nsec = tmv.tv_usec * 1000 + (timeout % 1000) * 1000 * 1000;
+            pos = w.pos_;
+            opening = entries_[pos].session_->get_backend() == NULL;
+        }
+
+        leased(pos);
+
+        if (slowQueryLogSet_)
+        {
+            // the session is not used by anybody else now
+            entries_[pos].session_->set_slow_query_log(slowQuerySink_,
+                slowQueryThreshold_, slowQueryMaxValueLength_);
+        }
+
+        long long const now = get_microseconds();
+        entries_[pos].leasedAt_ = now;
+        waited = now - start;
+
+        validate = opening == false && validateOnLease_ &&
+            get_ticks() - entries_[pos].lastChecked_ >= validation_bypass_time;
+
+        if (validate == false)
+        {
+            add_lease(waited);
+        }
+
+        return true;
+    }
 
-        if (tm.tv_nsec >= 1000 * 1000 * 1000)
+    // called by the thread which has just leased the entry
+    void leased(std::size_t pos)
+    {
+        if (threadAffinity_)
         {
-            ++tm.tv_sec;
-            tm.tv_nsec -= 1000 * 1000 * 1000;
+            lastLeased_.set(reinterpret_cast<void *>(pos + 1));
         }
     }
 
-    int cc = pthread_mutex_lock(&(pimpl_->mtx_));
-    if (cc != 0)
+    void add_lease(long long waited)
     {
-        throw soci_error("Synchronization error");
+        ++stats_.leases;
+        stats_.lease_wait.add(static_cast<unsigned long long>(waited));
     }
 
-    while (pimpl_->find_free(pos) == false)
+    // pass the entry, which must not be free, to the first waiting thread or
+    // put it into the list of free or closed entries if there are none
+    void release(std::size_t pos, bool closed)
     {
-        if (timeout < 0)
+        if (closed == false)
         {
-            // no timeout, allow unlimited blocking
-            cc = pthread_cond_wait(&(pimpl_->cond_), &(pimpl_->mtx_));
+            // but not necessarily working, the connection could have been
+            // lost while it was used, so lastChecked_ is not updated
+            entries_[pos].lastUsed_ = get_ticks();
         }
-        else
+
+        if (waiters_.empty())
         {
-            // wait with timeout
-            cc = pthread_cond_timedwait(
-                &(pimpl_->cond_), &(pimpl_->mtx_), &tm);
+            if (closed)
+            {
+                push_closed(pos);
+            }
+            else
+            {
+                push_free(pos);
+            }
+
+            return;
         }
 
-        if (cc == ETIMEDOUT)
+        // the entry remains in use, by the thread waiting for the longest
+        // time, which opens it if necessary
+        entries_[pos].state_ = entry::es_leased;
+        waiter * const w = waiters_.front();
+        waiters_.pop_front();
+        w->pos_ = pos;
+        w->cond_.notify_one();
+    }
+
+    // ensure that the session of the entry leased by the current thread is
+    // open and return true if it had to be opened, this is called without
+    // holding the lock
+    bool open_if_needed(std::size_t pos)
+    {
+        session & s = *entries_[pos].session_;
+        if (elastic_ == false || s.get_backend() != NULL)
         {
-            break;
+            return false;
         }
+
+        long long const start = get_microseconds();
+        try
+        {
+            s.open(parameters_);
+        }
+        catch (...)
+        {
+            scoped_lock lock(mtx_);
+            ++stats_.open_failures;
+            release(pos, true);
+            throw;
+        }
+
+        scoped_lock lock(mtx_);
+        add_open(get_microseconds() - start);
+        entries_[pos].lastChecked_ = get_ticks();
+
+        return true;
     }
 
-    if (cc == 0)
+    void add_open(long long duration)
     {
-        pimpl_->sessions_[pos].first = false;
+        ++stats_.opens;
+        stats_.open_time.add(static_cast<unsigned long long>(duration));
     }
 
-    pthread_mutex_unlock(&(pimpl_->mtx_));
+    // check the session of the entry leased by the current thread and, if
+    // it's broken, pass the entry to the maintenance thread to reconnect it
+    // and return false, this is called without holding the lock
+    bool check_leased(std::size_t pos, long long waited)
+    {
+        std::string query;
+        {
+            scoped_lock lock(mtx_);
+            query = validationQuery_;
+        }
 
-    return cc == 0;
-}
+        bool const ok = is_session_valid(*entries_[pos].session_, query);
 
-void connection_pool::give_back(std::size_t pos)
-{
-    if (pos >= pimpl_->sessions_.size())
+        scoped_lock lock(mtx_);
+        if (ok)
+        {
+            entries_[pos].lastChecked_ = get_ticks();
+            add_lease(waited);
+            return true;
+        }
+
+        ++brokenCount_;
+        add_broken(pos);
+
+        return false;
+    }
+
+    // queue the entry, which is not free, for reconnecting
+    void add_broken(std::size_t pos)
     {
-        throw soci_error("Invalid pool position");
+        entries_[pos].state_ = entry::es_broken;
+        broken_.push_back(pos);
+        nextReconnect_ = 0;
+
+        start_maintenance();
+        maintenanceCond_.notify_one();
     }
 
-    int cc = pthread_mutex_lock(&(pimpl_->mtx_));
-    if (cc != 0)
+    void start_maintenance()
     {
-        throw soci_error("Synchronization error");
+        if (maintenanceStarted_ == false)
+        {
+            maintenanceThread_ = start_thread(pool_maintenance_entry, this);
+            maintenanceStarted_ = true;
+        }
     }
 
-    if (pimpl_->sessions_[pos].first)
+    // close the sessions unused for too long and return the number of
+    // milliseconds after which this should be done again or -1 if never,
+    // must be called with the lock held
+    long long close_idle()
     {
-        pthread_mutex_unlock(&(pimpl_->mtx_));
-        throw soci_error("Cannot release pool entry (already free)");
+        if (idleTimeout_ <= 0)
+        {
+            return -1;
+        }
+
+        for (;;)
+        {
+            if (freeTail_ == no_entry ||
+                entries_.size() - closedCount_ <= minSize_)
+            {
+                // nothing can be closed until some entry is given back
+                return idleTimeout_;
+            }
+
+            std::size_t const pos = freeTail_;
+            long long const idle = get_ticks() - entries_[pos].lastUsed_;
+            if (idle < idleTimeout_)
+            {
+                return idleTimeout_ - idle;
+            }
+
+            // the entry is not free while its session is being closed
+            take_free(pos);
+            entries_[pos].state_ = entry::es_closed;
+
+            mtx_.unlock();
+            try
+            {
+                entries_[pos].session_->close();
+            }
+            catch (...)
+            {
+                // the session is unusable anyhow
+            }
+            mtx_.lock();
+
+            ++stats_.idle_closes;
+            release(pos, true);
+        }
     }
 
-    pimpl_->sessions_[pos].first = true;
+    // try to reconnect the broken sessions and return the number of
+    // milliseconds after which this should be done again or -1 if there are
+    // no more of them, must be called with the lock held
+    long long reconnect_broken()
+    {
+        if (broken_.empty())
+        {
+            return -1;
+        }
 
-    pthread_mutex_unlock(&(pimpl_->mtx_));
+        long long const now = get_ticks();
+        if (now < nextReconnect_)
+        {
+            return nextReconnect_ - now;
+        }
 
-    pthread_cond_signal(&(pimpl_->cond_));
-}
+        std::vector<std::size_t> broken;
+        broken.swap(broken_);
+        std::string const query = validationQuery_;
 
-#else
-// Windows implementation
+        for (std::size_t i = 0; i != broken.size(); ++i)
+        {
+            std::size_t const pos = broken[i];
+            if (stop_)
+            {
+                broken_.push_back(pos);
+                continue;
+            }
 
-#include <windows.h>
+            bool const ok = reconnect_unlocked(pos, query);
+            if (ok)
+            {
+                --brokenCount_;
+                release(pos, false);
+            }
+            else
+            {
+                broken_.push_back(pos);
+            }
+        }
 
-using namespace soci;
+        if (broken_.empty())
+        {
+            return -1;
+        }
 
-struct connection_pool::connection_pool_impl
-{
-    bool find_free(std::size_t & pos)
+        nextReconnect_ = get_ticks() + get_retry_interval();
+
+        return get_retry_interval();
+    }
+
+    // reconnect the session of the entry, releasing the lock while doing
+    // it, and return true if it's usable now
+    bool reconnect_unlocked(std::size_t pos, std::string const & query)
     {
-        for (std::size_t i = 0; i != sessions_.size(); ++i)
+        mtx_.unlock();
+        long long const start = get_microseconds();
+        bool const ok = reconnect_session(*entries_[pos].session_, query);
+        long long const duration = get_microseconds() - start;
+        mtx_.lock();
+
+        if (ok)
+        {
+            ++stats_.reconnects;
+            entries_[pos].lastChecked_ = get_ticks();
+        }
+        else
+        {
+            ++stats_.reconnect_failures;
+        }
+
+        stats_.reconnect_time.add(static_cast<unsigned long long>(duration));
+
+        return ok;
+    }
+
+    int get_retry_interval() const
+    {
+        if (validationInterval_ > 0 &&
+            validationInterval_ < reconnect_retry_interval)
+        {
+            return validationInterval_;
+        }
+
+        return reconnect_retry_interval;
+    }
+
+    // check the free sessions which were not used nor checked during the
+    // validation interval and return the number of milliseconds after which
+    // this should be done again or -1 if never, must be called with the lock
+    // held
+    long long validate_free()
+    {
+        if (validationInterval_ <= 0)
+        {
+            return -1;
+        }
+
+        long long const now = get_ticks();
+        if (now < nextValidation_)
+        {
+            return nextValidation_ - now;
+        }
+
+        nextValidation_ = now + validationInterval_;
+
+        // the free list changes while the lock is released, so remember the
+        // entries to check first, starting with the least recently used ones
+        std::vector<std::pair<std::size_t, long long> > toCheck;
+        for (std::size_t pos = freeTail_; pos != no_entry;
+            pos = entries_[pos].prev_)
         {
-            if (sessions_[i].first)
+            entry const & e = entries_[pos];
+            if (now - e.lastChecked_ >= validationInterval_ &&
+                now - e.lastUsed_ >= validationInterval_)
             {
-                pos = i;
-                return true;
+                toCheck.push_back(std::make_pair(pos, e.lastUsed_));
             }
         }
 
-        return false;
+        std::string const query = validationQuery_;
+        for (std::size_t i = 0; i != toCheck.size() && stop_ == false; ++i)
+        {
+            std::size_t const pos = toCheck[i].first;
+            entry & e = entries_[pos];
+            if (e.state_ != entry::es_free ||
+                e.lastUsed_ != toCheck[i].second)
+            {
+                // leased, or even given back, in the meanwhile
+                continue;
+            }
+
+            e.checking_ = true;
+            mtx_.unlock();
+            bool const ok = is_session_valid(*e.session_, query);
+            mtx_.lock();
+            e.checking_ = false;
+
+            if (ok)
+            {
+                e.lastChecked_ = get_ticks();
+                if (waiters_.empty() == false)
+                {
+                    // it couldn't be leased while it was being checked
+                    take_free(pos);
+                    release(pos, false);
+                }
+
+                continue;
+            }
+
+            // reconnect the session right now, it's not on the request path
+            take_free(pos);
+            e.state_ = entry::es_broken;
+
+            if (reconnect_unlocked(pos, query))
+            {
+                release(pos, false);
+            }
+            else
+            {
+                ++brokenCount_;
+                broken_.push_back(pos);
+                nextReconnect_ = get_ticks() + get_retry_interval();
+            }
+        }
+
+        return validationInterval_;
     }
 
-    // by convention, first == true means the entry is free (not used)
-    std::vector<std::pair<bool, session *> > sessions_;
+    void run_maintenance()
+    {
+        scoped_lock lock(mtx_);
+        while (stop_ == false)
+        {
+            long long wait = close_idle();
+
+            long long const reconnectWait = reconnect_broken();
+            if (reconnectWait >= 0 && (wait < 0 || reconnectWait < wait))
+            {
+                wait = reconnectWait;
+            }
 
-    CRITICAL_SECTION mtx_;
-    HANDLE sem_;
+            long long const validationWait = validate_free();
+            if (validationWait >= 0 && (wait < 0 || validationWait < wait))
+            {
+                wait = validationWait;
+            }
+
+            if (broken_.empty() == false && nextReconnect_ == 0)
+            {
+                // more sessions were found to be broken in the meanwhile
+                continue;
+            }
+
+            if (stop_)
+            {
+                break;
+            }
+
+            if (wait < 0)
+            {
+                maintenanceCond_.wait(mtx_);
+            }
+            else
+            {
+                maintenanceCond_.wait(mtx_, static_cast<int>(wait));
+            }
+        }
+    }
+
+    std::vector<entry> entries_;
+    std::size_t freeHead_;
+    std::size_t freeTail_;
+    std::size_t freeCount_;
+    std::size_t closedHead_;
+    std::size_t closedCount_;
+    std::deque<waiter *> waiters_;
+    mutex mtx_;
+
+    // the statistics, without the values describing the current state which
+    // are computed when they're requested
+    connection_pool_stats stats_;
+
+    bool threadAffinity_;
+
+    // the last entry leased by each thread
+    thread_specific lastLeased_;
+
+    // the parameters used for opening the sessions of the elastic pools
+    bool elastic_;
+    connection_parameters parameters_;
+    std::size_t minSize_;
+    int idleTimeout_;
+
+    // health checks of the sessions
+    bool validateOnLease_;
+    int validationInterval_;
+    std::string validationQuery_;
+    long long nextValidation_;
+
+    // the slow query log settings applied to the sessions when they are
+    // leased, if set_slow_query_log() was called
+    bool slowQueryLogSet_;
+    slow_query_sink * slowQuerySink_;
+    int slowQueryThreshold_;
+    std::size_t slowQueryMaxValueLength_;
+
+    // the entries whose sessions need to be reconnected, the count includes
+    // those being reconnected right now
+    std::vector<std::size_t> broken_;
+    std::size_t brokenCount_;
+    long long nextReconnect_;
+
+    // the thread closing the idle sessions and checking and reconnecting
+    // the other ones
+    bool maintenanceStarted_;
+    bool stop_;
+    condition maintenanceCond_;
+    thread_handle maintenanceThread_;
 };
 
+namespace // anonymous
+{
+
+extern "C" SOCI_THREAD_ENTRY(pool_maintenance_entry, arg)
+{
+    static_cast<connection_pool::connection_pool_impl *>(arg)->run_maintenance();
+    SOCI_THREAD_RETURN;
+}
+
+} // namespace anonymous
+
 connection_pool::connection_pool(std::size_t size)
 {
     if (size == 0)
@@ -224,46 +837,135 @@ connection_pool::connection_pool(std::size_t size)
     }
 
     pimpl_ = new connection_pool_impl();
-    pimpl_->sessions_.resize(size);
-    for (std::size_t i = 0; i != size; ++i)
+    pimpl_->entries_.resize(size);
+    for (std::size_t i = size; i != 0; --i)
     {
-        pimpl_->sessions_[i] = std::make_pair(true, new session());
+        // add the entries in reverse order for them to be leased in order
+        pimpl_->entries_[i - 1].session_ = new session();
+        pimpl_->push_free(i - 1);
     }
+}
 
-    InitializeCriticalSection(&(pimpl_->mtx_));
+connection_pool::connection_pool(connection_parameters const & parameters,
+    std::size_t minSize, std::size_t maxSize)
+{
+    if (maxSize == 0 || minSize > maxSize)
+    {
+        throw soci_error("Invalid pool size");
+    }
 
-    // initially all entries are available
-    HANDLE s = CreateSemaphore(NULL,
-        static_cast<LONG>(size), static_cast<LONG>(size), NULL);
-    if (s == NULL)
+    pimpl_ = new connection_pool_impl();
+    pimpl_->elastic_ = true;
+    pimpl_->parameters_ = parameters;
+    pimpl_->minSize_ = minSize;
+    pimpl_->entries_.resize(maxSize);
+
+    std::vector<session_opener *> openers;
+    std::vector<thread_handle> threads;
+    std::string error;
+    try
+    {
+        for (std::size_t i = 0; i != maxSize; ++i)
+        {
+            pimpl_->entries_[i].session_ = new session();
+        }
+
+        // open the initial sessions in parallel, the first one in this thread
+        openers.reserve(minSize);
+        for (std::size_t i = 0; i != minSize; ++i)
+        {
+            openers.push_back(new session_opener(
+                *pimpl_->entries_[i].session_, pimpl_->parameters_));
+        }
+
+        threads.reserve(minSize);
+        for (std::size_t i = 1; i < minSize; ++i)
+        {
+            threads.push_back(start_thread(session_opener_entry, openers[i]));
+        }
+
+        if (minSize != 0)
+        {
+            openers[0]->run();
+        }
+    }
+    catch (std::exception const & e)
+    {
+        error = e.what();
+    }
+
+    for (std::size_t i = 0; i != threads.size(); ++i)
     {
-        throw soci_error("Synchronization error");
+        join_thread(threads[i]);
     }
 
-    pimpl_->sem_ = s;
+    for (std::size_t i = 0; i != openers.size(); ++i)
+    {
+        if (openers[i]->failed_ && error.empty())
+        {
+            error = openers[i]->error_;
+        }
+
+        if (openers[i]->failed_ == false)
+        {
+            pimpl_->add_open(openers[i]->duration_);
+        }
+
+        delete openers[i];
+    }
+
+    if (error.empty() == false)
+    {
+        for (std::size_t i = 0; i != maxSize; ++i)
+        {
+            delete pimpl_->entries_[i].session_;
+        }
+
+        delete pimpl_;
+
+        throw soci_error(error);
+    }
+
+    for (std::size_t i = maxSize; i != minSize; --i)
+    {
+        pimpl_->push_closed(i - 1);
+    }
+
+    for (std::size_t i = minSize; i != 0; --i)
+    {
+        pimpl_->push_free(i - 1);
+    }
 }
 
 connection_pool::~connection_pool()
 {
-    for (std::size_t i = 0; i != pimpl_->sessions_.size(); ++i)
+    if (pimpl_->maintenanceStarted_)
     {
-        delete pimpl_->sessions_[i].second;
+        {
+            scoped_lock lock(pimpl_->mtx_);
+            pimpl_->stop_ = true;
+            pimpl_->maintenanceCond_.notify_one();
+        }
+
+        join_thread(pimpl_->maintenanceThread_);
     }
 
-    DeleteCriticalSection(&(pimpl_->mtx_));
-    CloseHandle(pimpl_->sem_);
+    for (std::size_t i = 0; i != pimpl_->entries_.size(); ++i)
+    {
+        delete pimpl_->entries_[i].session_;
+    }
 
     delete pimpl_;
 }
 
 session & connection_pool::at(std::size_t pos)
 {
-    if (pos >= pimpl_->sessions_.size())
+    if (pos >= pimpl_->entries_.size())
     {
         throw soci_error("Invalid pool position");
     }
 
-    return *(pimpl_->sessions_[pos].second);
+    return *(pimpl_->entries_[pos].session_);
 }
 
 std::size_t connection_pool::lease()
@@ -273,67 +975,192 @@ std::size_t connection_pool::lease()
     // no timeout
     bool const success = try_lease(pos, -1);
     assert(success);
-    if (!success)
-    {
-        // TODO: anything to report? --mloskot
-    }
 
     return pos;
 }
 
 bool connection_pool::try_lease(std::size_t & pos, int timeout)
 {
-    DWORD cc = WaitForSingleObject(pimpl_->sem_,
-        timeout >= 0 ? static_cast<DWORD>(timeout) : INFINITE);
-    if (cc == WAIT_OBJECT_0)
+    long long const start = get_microseconds();
+    long long const deadline = timeout > 0 ? get_ticks() + timeout : 0;
+    for (;;)
     {
-        // semaphore acquired, there is (at least) one free entry
-
-        EnterCriticalSection(&(pimpl_->mtx_));
-
-        bool const success = pimpl_->find_free(pos);
-        assert(success);
-        if (!success)
+        bool validate;
+        long long waited;
+        if (pimpl_->acquire(pos, timeout, start, deadline, validate, waited)
+            == false)
         {
-            // TODO: anything to report? --mloskot
+            return false;
         }
 
-        pimpl_->sessions_[pos].first = false;
-
-        LeaveCriticalSection(&(pimpl_->mtx_));
+        // the entry is ours now, but its session may still need to be opened
+        // or checked, which is done without blocking the other threads
+        if (pimpl_->open_if_needed(pos) || validate == false ||
+            pimpl_->check_leased(pos, waited))
+        {
+            return true;
+        }
 
-        return true;
+        // the broken session is reconnected in the background, try another
     }
-    else if (cc == WAIT_TIMEOUT)
+}
+
+void connection_pool::give_back(std::size_t pos)
+{
+    if (pos >= pimpl_->entries_.size())
     {
-        return false;
+        throw soci_error("Invalid pool position");
     }
-    else
+
+    scoped_lock lock(pimpl_->mtx_);
+
+    switch (pimpl_->entries_[pos].state_)
     {
-        throw soci_error("Synchronization error");
+    case connection_pool_impl::entry::es_leased:
+        break;
+    case connection_pool_impl::entry::es_free:
+        throw soci_error("Cannot release pool entry (already free)");
+    default:
+        throw soci_error("Cannot release pool entry (not leased)");
     }
+
+    pimpl_->stats_.lease_hold.add(static_cast<unsigned long long>(
+        get_microseconds() - pimpl_->entries_[pos].leasedAt_));
+
+    pimpl_->release(pos, false);
 }
 
-void connection_pool::give_back(std::size_t pos)
+void connection_pool::set_slow_query_log(slow_query_sink * sink,
+    int threshold, std::size_t maxValueLength)
+{
+    scoped_lock lock(pimpl_->mtx_);
+
+    pimpl_->slowQueryLogSet_ = true;
+    pimpl_->slowQuerySink_ = sink;
+    pimpl_->slowQueryThreshold_ = threshold;
+    pimpl_->slowQueryMaxValueLength_ = maxValueLength;
+}
+
+void connection_pool::set_thread_affinity(bool enable)
+{
+    scoped_lock lock(pimpl_->mtx_);
+
+    pimpl_->threadAffinity_ = enable;
+}
+
+bool connection_pool::get_thread_affinity() const
+{
+    scoped_lock lock(pimpl_->mtx_);
+
+    return pimpl_->threadAffinity_;
+}
+
+void connection_pool::set_idle_timeout(int timeout)
 {
-    if (pos >= pimpl_->sessions_.size())
+    if (pimpl_->elastic_ == false)
     {
-        throw soci_error("Invalid pool position");
+        throw soci_error("Idle timeout can only be used with elastic pools");
     }
 
-    EnterCriticalSection(&(pimpl_->mtx_));
+    scoped_lock lock(pimpl_->mtx_);
+
+    pimpl_->idleTimeout_ = timeout;
 
-    if (pimpl_->sessions_[pos].first)
+    if (pimpl_->maintenanceStarted_)
     {
-        LeaveCriticalSection(&(pimpl_->mtx_));
-        throw soci_error("Cannot release pool entry (already free)");
+        // recompute the time of the next check
+        pimpl_->maintenanceCond_.notify_one();
+    }
+    else if (timeout > 0)
+    {
+        pimpl_->start_maintenance();
     }
+}
+
+int connection_pool::get_idle_timeout() const
+{
+    scoped_lock lock(pimpl_->mtx_);
 
-    pimpl_->sessions_[pos].first = true;
+    return pimpl_->idleTimeout_;
+}
 
-    LeaveCriticalSection(&(pimpl_->mtx_));
+std::size_t connection_pool::get_open_count() const
+{
+    scoped_lock lock(pimpl_->mtx_);
 
-    ReleaseSemaphore(pimpl_->sem_, 1, NULL);
+    return pimpl_->entries_.size() - pimpl_->closedCount_;
 }
 
-#endif // _WIN32
+void connection_pool::set_validation_query(std::string const & query)
+{
+    scoped_lock lock(pimpl_->mtx_);
+
+    pimpl_->validationQuery_ = query;
+}
+
+std::string connection_pool::get_validation_query() const
+{
+    scoped_lock lock(pimpl_->mtx_);
+
+    return pimpl_->validationQuery_;
+}
+
+void connection_pool::set_validate_on_lease(bool enable)
+{
+    scoped_lock lock(pimpl_->mtx_);
+
+    pimpl_->validateOnLease_ = enable;
+}
+
+bool connection_pool::get_validate_on_lease() const
+{
+    scoped_lock lock(pimpl_->mtx_);
+
+    return pimpl_->validateOnLease_;
+}
+
+void connection_pool::set_validation_interval(int interval)
+{
+    scoped_lock lock(pimpl_->mtx_);
+
+    pimpl_->validationInterval_ = interval;
+    pimpl_->nextValidation_ = 0;
+
+    if (pimpl_->maintenanceStarted_)
+    {
+        pimpl_->maintenanceCond_.notify_one();
+    }
+    else if (interval > 0)
+    {
+        pimpl_->start_maintenance();
+    }
+}
+
+int connection_pool::get_validation_interval() const
+{
+    scoped_lock lock(pimpl_->mtx_);
+
+    return pimpl_->validationInterval_;
+}
+
+connection_pool_stats connection_pool::get_stats() const
+{
+    scoped_lock lock(pimpl_->mtx_);
+
+    connection_pool_stats stats = pimpl_->stats_;
+    stats.waiters = pimpl_->waiters_.size();
+    stats.idle = pimpl_->freeCount_;
+    stats.broken = pimpl_->brokenCount_;
+    stats.in_use = pimpl_->entries_.size() - pimpl_->freeCount_ -
+        pimpl_->closedCount_ - pimpl_->brokenCount_;
+
+    return stats;
+}
+
+void connection_pool::reset_stats()
+{
+    scoped_lock lock(pimpl_->mtx_);
+
+    pimpl_->stats_ = connection_pool_stats();
+    pimpl_->stats_.max_waiters = pimpl_->waiters_.size();
+}
@@ -0,0 +1,69 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_SOURCE
+#include "soci/duration-histogram.h"
+
+using namespace soci;
+
+duration_histogram::duration_histogram()
+    : count(0), total(0), longest(0)
+{
+    for (int i = 0; i != bucket_count; ++i)
+    {
+        buckets[i] = 0;
+    }
+}
+
+void duration_histogram::add(unsigned long long duration)
+{
+    int i = 0;
+    while (duration >> i != 0 && i != bucket_count - 1)
+    {
+        ++i;
+    }
+
+    ++buckets[i];
+    ++count;
+    total += duration;
+    if (duration > longest)
+    {
+        longest = duration;
+    }
+}
+
+unsigned long long duration_histogram::percentile(double fraction) const
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    // number of durations which must not exceed the result
+    unsigned long long const rank =
+        static_cast<unsigned long long>(fraction * count + 0.5);
+
+    unsigned long long seen = 0;
+    for (int i = 0; i != bucket_count - 1; ++i)
+    {
+        seen += buckets[i];
+        if (seen >= rank && seen != 0)
+        {
+            // the upper bound of this bucket, but not more than necessary
+            unsigned long long const bound =
+                static_cast<unsigned long long>(1) << i;
+            return bound < longest ? bound : longest;
+        }
+    }
+
+    return longest;
+}
+
+unsigned long long duration_histogram::mean() const
+{
+    return count != 0 ? total / count : 0;
+}
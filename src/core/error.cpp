@@ -15,3 +15,13 @@ soci_error::soci_error(std::string const & msg)
      : std::runtime_error(msg)
 {
 }
+
+soci_error * soci_error::clone() const
+{
+    return new soci_error(*this);
+}
+
+void soci_error::rethrow() const
+{
+    throw *this;
+}
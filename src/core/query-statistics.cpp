@@ -0,0 +1,299 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_SOURCE
+#include "soci/query-statistics.h"
+#include "threading.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <map>
+
+using namespace soci;
+using namespace soci::details::threading;
+
+namespace // anonymous
+{
+
+typedef std::map<std::string, query_stats> queries_t;
+
+// the state of the registry, protected by the mutex except for the flag
+// which is only changed when the sessions are not used concurrently
+bool enabled_ = false;
+mutex mutex_;
+queries_t queries_;
+std::size_t maxQueries_ = 1000;
+
+char const * const other_query = "<other>";
+
+bool by_total_time(query_stats const & a, query_stats const & b)
+{
+    return a.time.total > b.time.total;
+}
+
+bool is_identifier_char(char c)
+{
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' ||
+        c == '$' || c == ':' || c == '@';
+}
+
+void write_json_string(std::ostream & os, std::string const & s)
+{
+    os << '"';
+    for (std::string::const_iterator it = s.begin(); it != s.end(); ++it)
+    {
+        char const c = *it;
+        switch (c)
+        {
+        case '"':  os << "\\\""; break;
+        case '\\': os << "\\\\"; break;
+        case '\n': os << "\\n"; break;
+        case '\r': os << "\\r"; break;
+        case '\t': os << "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char buf[8];
+                std::sprintf(buf, "\\u%04x", static_cast<unsigned>(c));
+                os << buf;
+            }
+            else
+            {
+                os << c;
+            }
+        }
+    }
+    os << '"';
+}
+
+} // namespace anonymous
+
+void query_statistics::enable(bool enable)
+{
+    enabled_ = enable;
+}
+
+bool query_statistics::is_enabled()
+{
+    return enabled_;
+}
+
+void query_statistics::set_max_queries(std::size_t count)
+{
+    scoped_lock lock(mutex_);
+
+    maxQueries_ = count;
+}
+
+std::size_t query_statistics::get_max_queries()
+{
+    scoped_lock lock(mutex_);
+
+    return maxQueries_;
+}
+
+std::vector<query_stats> query_statistics::get()
+{
+    std::vector<query_stats> result;
+    {
+        scoped_lock lock(mutex_);
+
+        result.reserve(queries_.size());
+        for (queries_t::const_iterator it = queries_.begin();
+            it != queries_.end(); ++it)
+        {
+            result.push_back(it->second);
+        }
+    }
+
+    std::stable_sort(result.begin(), result.end(), by_total_time);
+
+    return result;
+}
+
+void query_statistics::reset()
+{
+    scoped_lock lock(mutex_);
+
+    queries_.clear();
+}
+
+void query_statistics::dump_text(std::ostream & os)
+{
+    std::vector<query_stats> const stats = get();
+    for (std::size_t i = 0; i != stats.size(); ++i)
+    {
+        query_stats const & s = stats[i];
+        os << "calls=" << s.calls
+           << " errors=" << s.errors
+           << " rows=" << s.rows
+           << " total_us=" << s.time.total
+           << " min_us=" << s.shortest
+           << " mean_us=" << s.time.mean()
+           << " p50_us=" << s.time.percentile(0.5)
+           << " p99_us=" << s.time.percentile(0.99)
+           << " max_us=" << s.time.longest
+           << " query=" << s.query << '\n';
+    }
+}
+
+void query_statistics::dump_json(std::ostream & os)
+{
+    std::vector<query_stats> const stats = get();
+
+    os << "{\"queries\":[";
+    for (std::size_t i = 0; i != stats.size(); ++i)
+    {
+        query_stats const & s = stats[i];
+        if (i != 0)
+        {
+            os << ',';
+        }
+
+        os << "\n{\"query\":";
+        write_json_string(os, s.query);
+        os << ",\"calls\":" << s.calls
+           << ",\"errors\":" << s.errors
+           << ",\"rows\":" << s.rows
+           << ",\"total_us\":" << s.time.total
+           << ",\"min_us\":" << s.shortest
+           << ",\"mean_us\":" << s.time.mean()
+           << ",\"p50_us\":" << s.time.percentile(0.5)
+           << ",\"p90_us\":" << s.time.percentile(0.9)
+           << ",\"p99_us\":" << s.time.percentile(0.99)
+           << ",\"max_us\":" << s.time.longest
+           << '}';
+    }
+    os << "\n]}\n";
+}
+
+std::string query_statistics::normalize(std::string const & query)
+{
+    std::string result;
+    result.reserve(query.size());
+
+    std::size_t const size = query.size();
+    std::size_t i = 0;
+    while (i != size)
+    {
+        char const c = query[i];
+
+        if (std::isspace(static_cast<unsigned char>(c)))
+        {
+            while (i != size && std::isspace(static_cast<unsigned char>(query[i])))
+            {
+                ++i;
+            }
+
+            if (result.empty() == false && i != size)
+            {
+                result += ' ';
+            }
+        }
+        else if (c == '\'')
+        {
+            // string literal, with the quotes inside it doubled
+            for (++i; i != size; ++i)
+            {
+                if (query[i] == '\'')
+                {
+                    if (i + 1 != size && query[i + 1] == '\'')
+                    {
+                        ++i;
+                    }
+                    else
+                    {
+                        ++i;
+                        break;
+                    }
+                }
+            }
+
+            result += '?';
+        }
+        else if (c == '"')
+        {
+            // quoted identifier, kept as is
+            std::size_t const end = query.find('"', i + 1);
+            std::size_t const next = end != std::string::npos ? end + 1 : size;
+            result.append(query, i, next - i);
+            i = next;
+        }
+        else if (std::isdigit(static_cast<unsigned char>(c)) ||
+            (c == '.' && i + 1 != size &&
+                std::isdigit(static_cast<unsigned char>(query[i + 1]))))
+        {
+            // numeric literal, including the exponent if any
+            while (i != size &&
+                (std::isalnum(static_cast<unsigned char>(query[i])) ||
+                    query[i] == '.' ||
+                    ((query[i] == '+' || query[i] == '-') &&
+                        (query[i - 1] == 'e' || query[i - 1] == 'E'))))
+            {
+                ++i;
+            }
+
+            result += '?';
+        }
+        else if (is_identifier_char(c))
+        {
+            // identifiers, keywords and placeholders, which may contain
+            // digits that are not literals
+            while (i != size && is_identifier_char(query[i]))
+            {
+                result += query[i++];
+            }
+        }
+        else
+        {
+            result += c;
+            ++i;
+        }
+    }
+
+    return result;
+}
+
+void query_statistics::add(std::string const & normalizedQuery,
+    long long time, long long rows, bool failed)
+{
+    unsigned long long const duration =
+        time > 0 ? static_cast<unsigned long long>(time) : 0;
+
+    scoped_lock lock(mutex_);
+
+    queries_t::iterator it = queries_.find(normalizedQuery);
+    if (it == queries_.end())
+    {
+        std::string const & query = queries_.size() < maxQueries_
+            ? normalizedQuery
+            : other_query;
+
+        it = queries_.insert(
+            std::make_pair(query, query_stats())).first;
+        it->second.query = query;
+    }
+
+    query_stats & s = it->second;
+    if (s.calls == 0 || duration < s.shortest)
+    {
+        s.shortest = duration;
+    }
+
+    ++s.calls;
+    if (failed)
+    {
+        ++s.errors;
+    }
+
+    if (rows > 0)
+    {
+        s.rows += static_cast<unsigned long long>(rows);
+    }
+
+    s.time.add(duration);
+}
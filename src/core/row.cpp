@@ -10,14 +10,155 @@
 
 #include <cstddef>
 #include <cctype>
+#include <cstring>
+#include <ctime>
+#include <new>
 #include <sstream>
 #include <string>
+#include <typeinfo>
 
 using namespace soci;
 using namespace details;
 
+namespace // anonymous
+{
+
+template <typename T>
+struct alignment_of
+{
+    struct test { char c; T t; };
+    enum { value = sizeof(test) - sizeof(T) };
+};
+
+template <typename T>
+void get_layout(std::size_t& size, std::size_t& alignment)
+{
+    size = sizeof(T);
+    alignment = alignment_of<T>::value;
+}
+
+void get_holder_layout(exchange_type type,
+    std::size_t& size, std::size_t& alignment)
+{
+    switch (type)
+    {
+    case x_stdstring:
+        get_layout<std::string>(size, alignment);
+        break;
+    case x_double:
+        get_layout<double>(size, alignment);
+        break;
+    case x_integer:
+        get_layout<int>(size, alignment);
+        break;
+    case x_long_long:
+        get_layout<long long>(size, alignment);
+        break;
+    case x_unsigned_long_long:
+        get_layout<unsigned long long>(size, alignment);
+        break;
+    case x_stdtm:
+        get_layout<std::tm>(size, alignment);
+        break;
+    default:
+        assert(false);
+        size = alignment = 1;
+    }
+}
+
+template <typename T>
+void construct(void* p)
+{
+    new (p) T();
+}
+
+template <typename T>
+void destroy(void* p)
+{
+    static_cast<T*>(p)->~T();
+}
+
+void construct_holder(exchange_type type, void* p)
+{
+    switch (type)
+    {
+    case x_stdstring:
+        construct<std::string>(p);
+        break;
+    case x_double:
+        construct<double>(p);
+        break;
+    case x_integer:
+        construct<int>(p);
+        break;
+    case x_long_long:
+        construct<long long>(p);
+        break;
+    case x_unsigned_long_long:
+        construct<unsigned long long>(p);
+        break;
+    case x_stdtm:
+        construct<std::tm>(p);
+        break;
+    default:
+        assert(false);
+    }
+}
+
+void destroy_holder(exchange_type type, void* p)
+{
+    // only strings are not trivially destructible
+    if (type == x_stdstring)
+    {
+        destroy<std::string>(p);
+    }
+}
+
+// FNV-1a hash of the column name
+std::size_t hash_column_name(char const* name, std::size_t len)
+{
+    std::size_t hash = 2166136261u;
+    for (std::size_t i = 0; i != len; ++i)
+    {
+        hash ^= static_cast<unsigned char>(name[i]);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+bool has_column_name(column_properties const& cp,
+    char const* name, std::size_t len)
+{
+    std::string const& columnName = cp.get_name();
+    return columnName.size() == len &&
+        std::memcmp(columnName.data(), name, len) == 0;
+}
+
+// add the column at the given position to the index, replacing any previous
+// column with the same name
+void add_to_index(std::vector<std::size_t>& index,
+    std::vector<column_properties> const& columns, std::size_t pos)
+{
+    std::string const& name = columns[pos].get_name();
+
+    std::size_t const mask = index.size() - 1;
+    std::size_t slot = hash_column_name(name.data(), name.size()) & mask;
+    while (index[slot] != 0 &&
+        !has_column_name(columns[index[slot] - 1], name.data(), name.size()))
+    {
+        slot = (slot + 1) & mask;
+    }
+
+    index[slot] = pos + 1;
+}
+
+} // namespace anonymous
+
 row::row()
-    : uppercaseColumnNames_(false)
+    : data_(NULL)
+    , dataSize_(0)
+    , uppercaseColumnNames_(false)
     , currentPos_(0)
 {}
 
@@ -33,12 +174,50 @@ void row::uppercase_column_names(bool forceToUpper)
 
 void row::add_properties(column_properties const &cp)
 {
+    assert(data_ == NULL);
+
+    holder h;
+    switch (cp.get_data_type())
+    {
+    case dt_string:
+        h.type_ = x_stdstring;
+        break;
+    case dt_double:
+        h.type_ = x_double;
+        break;
+    case dt_integer:
+        h.type_ = x_integer;
+        break;
+    case dt_long_long:
+        h.type_ = x_long_long;
+        break;
+    case dt_unsigned_long_long:
+        h.type_ = x_unsigned_long_long;
+        break;
+    case dt_date:
+        h.type_ = x_stdtm;
+        break;
+    default:
+        std::ostringstream msg;
+        msg << "db column type " << cp.get_data_type()
+            <<" not supported for dynamic selects"<<std::endl;
+        throw soci_error(msg.str());
+    }
+
+    std::size_t size, alignment;
+    get_holder_layout(h.type_, size, alignment);
+
+    h.ind_ = i_ok;
+    h.offset_ = (dataSize_ + alignment - 1) / alignment * alignment;
+    dataSize_ = h.offset_ + size;
+
+    holders_.push_back(h);
     columns_.push_back(cp);
 
-    std::string columnName;
-    std::string const & originalName = cp.get_name();
     if (uppercaseColumnNames_)
     {
+        std::string columnName;
+        std::string const & originalName = cp.get_name();
         for (std::size_t i = 0; i != originalName.size(); ++i)
         {
             columnName.push_back(static_cast<char>(std::toupper(originalName[i])));
@@ -49,12 +228,26 @@ void row::add_properties(column_properties const &cp)
 
         columns_[columns_.size() - 1].set_name(columnName);
     }
-    else
+
+    // keep the index at most half full to make the lookups fast, its size
+    // must be a power of 2
+    std::size_t const pos = columns_.size() - 1;
+    if (2 * columns_.size() > index_.size())
     {
-        columnName = originalName;
+        std::size_t indexSize = 16;
+        while (indexSize < 4 * columns_.size())
+        {
+            indexSize *= 2;
+        }
+
+        index_.assign(indexSize, 0);
+        for (std::size_t i = 0; i != pos; ++i)
+        {
+            add_to_index(index_, columns_, i);
+        }
     }
 
-    index_[columnName] = columns_.size() - 1;
+    add_to_index(index_, columns_, pos);
 }
 
 std::size_t row::size() const
@@ -64,23 +257,65 @@ std::size_t row::size() const
 
 void row::clean_up()
 {
-    std::size_t const hsize = holders_.size();
-    for (std::size_t i = 0; i != hsize; ++i)
+    if (data_ != NULL)
     {
-        delete holders_[i];
-        delete indicators_[i];
+        std::size_t const hsize = holders_.size();
+        for (std::size_t i = 0; i != hsize; ++i)
+        {
+            destroy_holder(holders_[i].type_, data_ + holders_[i].offset_);
+        }
+
+        ::operator delete(data_);
+        data_ = NULL;
     }
 
+    dataSize_ = 0;
+
     columns_.clear();
     holders_.clear();
-    indicators_.clear();
     index_.clear();
 }
 
+void row::alloc_holders()
+{
+    assert(data_ == NULL);
+
+    // the memory returned by operator new is suitably aligned for any type
+    data_ = static_cast<char*>(::operator new(dataSize_ != 0 ? dataSize_ : 1));
+
+    // none of the constructors can throw, so there is no need to care about
+    // destroying the already constructed values
+    std::size_t const hsize = holders_.size();
+    for (std::size_t i = 0; i != hsize; ++i)
+    {
+        construct_holder(holders_[i].type_, data_ + holders_[i].offset_);
+    }
+}
+
+void* row::get_holder_data(std::size_t pos, int type)
+{
+    return const_cast<void*>(
+        static_cast<row const*>(this)->get_holder_data(pos, type));
+}
+
+void const* row::get_holder_data(std::size_t pos, int type) const
+{
+    assert(holders_.size() >= pos + 1);
+    assert(data_ != NULL);
+
+    holder const& h = holders_[pos];
+    if (h.type_ != type)
+    {
+        throw std::bad_cast();
+    }
+
+    return data_ + h.offset_;
+}
+
 indicator row::get_indicator(std::size_t pos) const
 {
-    assert(indicators_.size() >= static_cast<std::size_t>(pos + 1));
-    return *indicators_[pos];
+    assert(holders_.size() >= static_cast<std::size_t>(pos + 1));
+    return holders_[pos].ind_;
 }
 
 indicator row::get_indicator(std::string const &name) const
@@ -99,15 +334,23 @@ column_properties const & row::get_properties(std::string const &name) const
     return get_properties(find_column(name));
 }
 
-std::size_t row::find_column(std::string const &name) const
+std::size_t row::find_column(char const *name, std::size_t len) const
 {
-    std::map<std::string, std::size_t>::const_iterator it = index_.find(name);
-    if (it == index_.end())
+    if (!index_.empty())
     {
-        std::ostringstream msg;
-        msg << "Column '" << name << "' not found";
-        throw soci_error(msg.str());
+        std::size_t const mask = index_.size() - 1;
+        for (std::size_t slot = hash_column_name(name, len) & mask;
+            index_[slot] != 0; slot = (slot + 1) & mask)
+        {
+            std::size_t const pos = index_[slot] - 1;
+            if (has_column_name(columns_[pos], name, len))
+            {
+                return pos;
+            }
+        }
     }
 
-    return it->second;
+    std::ostringstream msg;
+    msg << "Column '" << std::string(name, len) << "' not found";
+    throw soci_error(msg.str());
 }
@@ -10,6 +10,7 @@
 #include "soci/connection-parameters.h"
 #include "soci/connection-pool.h"
 #include "soci/soci-backend.h"
+#include "soci/statement.h"
 #include "soci/query_transformation.h"
 
 #ifdef _MSC_VER
@@ -30,11 +31,78 @@ void ensureConnected(session_backend * backEnd)
     }
 }
 
+class once_async_task : public async_task
+{
+public:
+    once_async_task(session & s, std::string const & query)
+        : session_(s), query_(query), st_(NULL) {}
+
+    ~once_async_task() { delete st_; }
+
+    virtual bool start(step_status & status)
+    {
+        // the backends without a socket can't execute anything without
+        // blocking, so leave everything to run() for them
+        if (session_.get_socket() < 0)
+        {
+            return false;
+        }
+
+        session_.get_query_stream().str("");
+        session_.get_query_stream() << query_;
+
+        // the statement cache is not used as preparing the statements kept
+        // in it needs a round trip to the server
+        st_ = new statement(session_);
+        st_->alloc();
+        st_->prepare(session_.get_query(), st_one_time_query);
+        st_->define_and_bind();
+
+        if (st_->can_start_execute() == false)
+        {
+            return false;
+        }
+
+        status = st_->start_execute(true);
+        return true;
+    }
+
+    virtual step_status step() { return st_->step(); }
+
+    virtual bool result()
+    {
+        session_.set_got_data(st_->got_data());
+        return st_->got_data();
+    }
+
+    virtual bool run()
+    {
+        if (st_ == NULL)
+        {
+            session_ << query_;
+            return session_.got_data();
+        }
+
+        // the statement was already prepared by start()
+        bool const gotData = st_->execute(true);
+        session_.set_got_data(gotData);
+        return gotData;
+    }
+
+private:
+    session & session_;
+    std::string const query_;
+    statement * st_;
+};
+
 } // namespace anonymous
 
 session::session()
     : once(this), prepare(this), query_transformation_(NULL), logStream_(NULL),
-      uppercaseColumnNames_(false), backEnd_(NULL),
+      uppercaseColumnNames_(false), rowsetPrefetchSize_(1),
+      backEnd_(NULL), statementCache_(NULL), statementEvents_(NULL),
+      slowQuerySink_(NULL), slowQueryThreshold_(0),
+      slowQueryMaxValueLength_(0), asyncWorker_(NULL),
       isFromPool_(false), pool_(NULL)
 {
 }
@@ -42,7 +110,10 @@ session::session()
 session::session(connection_parameters const & parameters)
     : once(this), prepare(this), query_transformation_(NULL), logStream_(NULL),
       lastConnectParameters_(parameters),
-      uppercaseColumnNames_(false), backEnd_(NULL),
+      uppercaseColumnNames_(false), rowsetPrefetchSize_(1),
+      backEnd_(NULL), statementCache_(NULL), statementEvents_(NULL),
+      slowQuerySink_(NULL), slowQueryThreshold_(0),
+      slowQueryMaxValueLength_(0), asyncWorker_(NULL),
       isFromPool_(false), pool_(NULL)
 {
     open(lastConnectParameters_);
@@ -52,7 +123,10 @@ session::session(backend_factory const & factory,
     std::string const & connectString)
     : once(this), prepare(this), query_transformation_(NULL), logStream_(NULL),
       lastConnectParameters_(factory, connectString),
-      uppercaseColumnNames_(false), backEnd_(NULL),
+      uppercaseColumnNames_(false), rowsetPrefetchSize_(1),
+      backEnd_(NULL), statementCache_(NULL), statementEvents_(NULL),
+      slowQuerySink_(NULL), slowQueryThreshold_(0),
+      slowQueryMaxValueLength_(0), asyncWorker_(NULL),
       isFromPool_(false), pool_(NULL)
 {
     open(lastConnectParameters_);
@@ -62,7 +136,10 @@ session::session(std::string const & backendName,
     std::string const & connectString)
     : once(this), prepare(this), query_transformation_(NULL), logStream_(NULL),
       lastConnectParameters_(backendName, connectString),
-      uppercaseColumnNames_(false), backEnd_(NULL),
+      uppercaseColumnNames_(false), rowsetPrefetchSize_(1),
+      backEnd_(NULL), statementCache_(NULL), statementEvents_(NULL),
+      slowQuerySink_(NULL), slowQueryThreshold_(0),
+      slowQueryMaxValueLength_(0), asyncWorker_(NULL),
       isFromPool_(false), pool_(NULL)
 {
     open(lastConnectParameters_);
@@ -71,14 +148,20 @@ session::session(std::string const & backendName,
 session::session(std::string const & connectString)
     : once(this), prepare(this), query_transformation_(NULL), logStream_(NULL),
       lastConnectParameters_(connectString),
-      uppercaseColumnNames_(false), backEnd_(NULL),
+      uppercaseColumnNames_(false), rowsetPrefetchSize_(1),
+      backEnd_(NULL), statementCache_(NULL), statementEvents_(NULL),
+      slowQuerySink_(NULL), slowQueryThreshold_(0),
+      slowQueryMaxValueLength_(0), asyncWorker_(NULL),
       isFromPool_(false), pool_(NULL)
 {
     open(lastConnectParameters_);
 }
 
 session::session(connection_pool & pool)
-    : query_transformation_(NULL), logStream_(NULL), isFromPool_(true), pool_(&pool)
+    : query_transformation_(NULL), logStream_(NULL), statementCache_(NULL),
+      statementEvents_(NULL), slowQuerySink_(NULL), slowQueryThreshold_(0),
+      slowQueryMaxValueLength_(0), asyncWorker_(NULL), isFromPool_(true),
+      pool_(&pool)
 {
     poolPosition_ = pool.lease();
     session & pooledSession = pool.at(poolPosition_);
@@ -92,11 +175,33 @@ session::~session()
 {
     if (isFromPool_)
     {
+        // the pooled session can't be given back while it's still in use
+        pool_->at(poolPosition_).wait_async();
         pool_->give_back(poolPosition_);
     }
     else
     {
+        // the pending operations may use all the objects deleted below
+        delete asyncWorker_;
+
+        if (statementEvents_ != NULL)
+        {
+            try
+            {
+                statementEvents_->flush();
+            }
+            catch (...)
+            {
+                // the observer must not throw, but don't propagate it anyhow
+            }
+
+            delete statementEvents_;
+        }
+
         delete query_transformation_;
+
+        // cached statements must be released before their session
+        delete statementCache_;
         delete backEnd_;
     }
 }
@@ -151,6 +256,13 @@ void session::close()
     }
     else
     {
+        if (statementCache_ != NULL)
+        {
+            statementCache_->clear();
+        }
+
+        flush_statement_events();
+
         delete backEnd_;
         backEnd_ = NULL;
     }
@@ -349,6 +461,257 @@ bool session::get_uppercase_column_names() const
     }
 }
 
+void session::set_rowset_prefetch_size(std::size_t size)
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).set_rowset_prefetch_size(size);
+    }
+    else
+    {
+        rowsetPrefetchSize_ = size != 0 ? size : 1;
+    }
+}
+
+std::size_t session::get_rowset_prefetch_size() const
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_rowset_prefetch_size();
+    }
+    else
+    {
+        return rowsetPrefetchSize_;
+    }
+}
+
+void session::set_statement_cache_size(std::size_t size)
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).set_statement_cache_size(size);
+    }
+    else if (statementCache_ == NULL)
+    {
+        if (size != 0)
+        {
+            statementCache_ = new statement_cache(size);
+        }
+    }
+    else
+    {
+        statementCache_->set_max_size(size);
+    }
+}
+
+std::size_t session::get_statement_cache_size() const
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_statement_cache_size();
+    }
+    else
+    {
+        return statementCache_ != NULL ? statementCache_->get_max_size() : 0;
+    }
+}
+
+statement_cache_stats session::get_statement_cache_stats() const
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_statement_cache_stats();
+    }
+    else
+    {
+        return statementCache_ != NULL
+            ? statementCache_->get_stats()
+            : statement_cache_stats();
+    }
+}
+
+void session::reset_statement_cache_stats()
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).reset_statement_cache_stats();
+    }
+    else if (statementCache_ != NULL)
+    {
+        statementCache_->reset_stats();
+    }
+}
+
+void session::clear_statement_cache()
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).clear_statement_cache();
+    }
+    else if (statementCache_ != NULL)
+    {
+        statementCache_->clear();
+    }
+}
+
+void session::set_statement_observer(statement_observer * observer,
+    std::size_t bufferSize)
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).set_statement_observer(observer, bufferSize);
+        return;
+    }
+
+    if (statementEvents_ != NULL)
+    {
+        statementEvents_->flush();
+        delete statementEvents_;
+        statementEvents_ = NULL;
+    }
+
+    if (observer != NULL)
+    {
+        statementEvents_ =
+            new statement_event_buffer(*this, *observer, bufferSize);
+    }
+}
+
+statement_observer * session::get_statement_observer() const
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_statement_observer();
+    }
+    else
+    {
+        return statementEvents_ != NULL
+            ? &statementEvents_->get_observer()
+            : NULL;
+    }
+}
+
+void session::flush_statement_events()
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).flush_statement_events();
+    }
+    else if (statementEvents_ != NULL)
+    {
+        statementEvents_->flush();
+    }
+}
+
+statement_event_buffer * session::get_statement_events()
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_statement_events();
+    }
+    else
+    {
+        return statementEvents_;
+    }
+}
+
+void session::set_slow_query_log(slow_query_sink * sink, int threshold,
+    std::size_t maxValueLength)
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).set_slow_query_log(sink, threshold,
+            maxValueLength);
+    }
+    else
+    {
+        slowQuerySink_ = sink;
+        slowQueryThreshold_ = threshold;
+        slowQueryMaxValueLength_ = maxValueLength;
+    }
+}
+
+slow_query_sink * session::get_slow_query_sink() const
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_slow_query_sink();
+    }
+    else
+    {
+        return slowQuerySink_;
+    }
+}
+
+int session::get_slow_query_threshold() const
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_slow_query_threshold();
+    }
+    else
+    {
+        return slowQueryThreshold_;
+    }
+}
+
+std::size_t session::get_slow_query_max_value_length() const
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_slow_query_max_value_length();
+    }
+    else
+    {
+        return slowQueryMaxValueLength_;
+    }
+}
+
+async_result session::once_async(std::string const & query)
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).once_async(query);
+    }
+
+    return run_async(new once_async_task(*this, query));
+}
+
+void session::wait_async()
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).wait_async();
+    }
+    else if (asyncWorker_ != NULL)
+    {
+        asyncWorker_->wait_all();
+    }
+}
+
+async_result session::run_async(async_task * task)
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).run_async(task);
+    }
+
+    if (asyncWorker_ == NULL)
+    {
+        try
+        {
+            asyncWorker_ = new async_worker(*this);
+        }
+        catch (...)
+        {
+            delete task;
+            throw;
+        }
+    }
+
+    return async_result(asyncWorker_->submit(task));
+}
+
 bool session::get_next_sequence_value(std::string const & sequence, long & value)
 {
     ensureConnected(backEnd_);
@@ -363,6 +726,30 @@ bool session::get_last_insert_id(std::string const & sequence, long & value)
     return backEnd_->get_last_insert_id(*this, sequence, value);
 }
 
+int session::get_socket()
+{
+    ensureConnected(backEnd_);
+
+    return backEnd_->get_socket();
+}
+
+bool session::is_connected()
+{
+    if (backEnd_ == NULL)
+    {
+        return false;
+    }
+
+    try
+    {
+        return backEnd_->is_connected();
+    }
+    catch (soci_error const &)
+    {
+        return false;
+    }
+}
+
 std::string session::get_backend_name() const
 {
     ensureConnected(backEnd_);
@@ -390,3 +777,18 @@ blob_backend * session::make_blob_backend()
 
     return backEnd_->make_blob_backend();
 }
+
+statement_cache * session::get_statement_cache()
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_statement_cache();
+    }
+    else
+    {
+        // a cache with zero size is disabled but still keeps its statistics
+        return statementCache_ != NULL && statementCache_->get_max_size() != 0
+            ? statementCache_
+            : NULL;
+    }
+}
@@ -0,0 +1,42 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_SOURCE
+#include "soci/slow-query-log.h"
+
+std::ostream & soci::operator<<(std::ostream & os, slow_query const & q)
+{
+    os << "time_us=" << q.prepare_time + q.execute_time + q.fetch_time
+       << " prepare_us=" << q.prepare_time
+       << " execute_us=" << q.execute_time
+       << " fetch_us=" << q.fetch_time
+       << " fetches=" << q.fetches
+       << " rows=" << q.rows;
+
+    if (q.failed)
+    {
+        os << " failed";
+    }
+
+    os << " query=" << q.query;
+
+    if (q.parameters.empty() == false)
+    {
+        os << " parameters=";
+        for (std::size_t i = 0; i != q.parameters.size(); ++i)
+        {
+            if (i != 0)
+            {
+                os << ", ";
+            }
+
+            os << q.parameters[i];
+        }
+    }
+
+    return os;
+}
@@ -0,0 +1,106 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_SOURCE
+#include "soci/statement-cache.h"
+#include "soci/soci-backend.h"
+
+using namespace soci;
+using namespace soci::details;
+
+statement_cache::statement_cache(std::size_t maxSize)
+    : maxSize_(maxSize)
+{
+}
+
+statement_cache::~statement_cache()
+{
+    clear();
+}
+
+void statement_cache::set_max_size(std::size_t maxSize)
+{
+    maxSize_ = maxSize;
+    evict_to(maxSize_);
+}
+
+statement_backend * statement_cache::acquire(std::string const & query)
+{
+    index_t::iterator const it = index_.find(query);
+    if (it == index_.end())
+    {
+        ++stats_.misses;
+        return NULL;
+    }
+
+    statement_backend * const st = it->second->second;
+    entries_.erase(it->second);
+    index_.erase(it);
+
+    ++stats_.hits;
+    return st;
+}
+
+void statement_cache::release(std::string const & query,
+    statement_backend * st)
+{
+    if (maxSize_ == 0 || index_.find(query) != index_.end())
+    {
+        // either the cache was disabled in the meantime or the same query
+        // was executed again while this statement was checked out
+        destroy(st);
+        return;
+    }
+
+    evict_to(maxSize_ - 1);
+
+    entries_.push_front(std::make_pair(query, st));
+    index_[query] = entries_.begin();
+}
+
+void statement_cache::clear()
+{
+    for (entries_t::iterator it = entries_.begin(); it != entries_.end(); ++it)
+    {
+        destroy(it->second);
+    }
+
+    entries_.clear();
+    index_.clear();
+}
+
+statement_cache_stats statement_cache::get_stats() const
+{
+    statement_cache_stats stats = stats_;
+    stats.size = index_.size();
+    return stats;
+}
+
+void statement_cache::reset_stats()
+{
+    stats_ = statement_cache_stats();
+}
+
+void statement_cache::evict_to(std::size_t size)
+{
+    while (index_.size() > size)
+    {
+        std::pair<std::string, statement_backend *> const & lru = entries_.back();
+
+        destroy(lru.second);
+        index_.erase(lru.first);
+        entries_.pop_back();
+
+        ++stats_.evictions;
+    }
+}
+
+void statement_cache::destroy(statement_backend * st)
+{
+    st->clean_up();
+    delete st;
+}
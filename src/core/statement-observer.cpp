@@ -0,0 +1,57 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_SOURCE
+#include "soci/statement-observer.h"
+#include "soci/soci-backend.h"
+
+using namespace soci;
+using namespace soci::details;
+
+statement_event_buffer::statement_event_buffer(session & s,
+    statement_observer & observer, std::size_t capacity)
+    : session_(s), observer_(observer),
+      events_(capacity != 0 ? capacity : 1), count_(0), backEnd_(NULL)
+{
+}
+
+statement_event & statement_event_buffer::add()
+{
+    if (count_ == events_.size())
+    {
+        flush();
+    }
+
+    return events_[count_++];
+}
+
+void statement_event_buffer::flush()
+{
+    if (count_ == 0)
+    {
+        return;
+    }
+
+    // the events are reused later, so forget them even if the observer
+    // throws despite being told not to
+    std::size_t const count = count_;
+    count_ = 0;
+
+    observer_.on_events(session_, &events_[0], count);
+}
+
+std::string const & statement_event_buffer::get_backend_name(
+    session_backend * backEnd)
+{
+    if (backEnd != backEnd_)
+    {
+        backendName_ = backEnd != NULL ? backEnd->get_backend_name() : "";
+        backEnd_ = backEnd;
+    }
+
+    return backendName_;
+}
@@ -11,8 +11,13 @@
 #include "soci/into-type.h"
 #include "soci/use-type.h"
 #include "soci/values.h"
+#include "soci/query-statistics.h"
+#include "threading.h"
+#include <algorithm>
 #include <ctime>
 #include <cctype>
+#include <sstream>
+#include <vector>
 
 #ifdef _MSC_VER
 #pragma warning(disable:4355)
@@ -21,6 +26,191 @@
 using namespace soci;
 using namespace soci::details;
 
+namespace soci
+{
+namespace details
+{
+
+// Buffer for the values of a single column of the prefetched rows.
+class prefetch_buffer_base
+{
+public:
+    virtual ~prefetch_buffer_base() {}
+
+    // copy the value at the given position into the row
+    virtual void copy_row(std::size_t pos) = 0;
+};
+
+template <typename T>
+class prefetch_buffer : public prefetch_buffer_base
+{
+public:
+    prefetch_buffer(T * t, indicator * ind, std::size_t size)
+        : t_(t), ind_(ind), values_(size), inds_(size) {}
+
+    virtual void copy_row(std::size_t pos)
+    {
+        // each prefetched value is used only once, so avoid copying it
+        std::swap(*t_, values_[pos]);
+        *ind_ = inds_[pos];
+    }
+
+    T * t_;
+    indicator * ind_;
+    std::vector<T> values_;
+    std::vector<indicator> inds_;
+};
+
+// Measures a phase of the statement and reports it to the observer of the
+// session, if there is one, and accounts for it in the query statistics, if
+// they are collected, at the end of the scope. The phase is reported as
+// failed unless done() is called before.
+class statement_impl::phase_reporter
+{
+public:
+    phase_reporter(statement_impl & st, statement_phase phase)
+        : st_(st), phase_(phase), events_(st.session_.get_statement_events()),
+          tracked_(st.is_tracked(phase)),
+          start_(events_ != NULL || tracked_
+              ? threading::get_microseconds()
+              : 0),
+          rows_(-1), failed_(true) {}
+
+    // continue measuring the phase which started at the given time
+    phase_reporter(statement_impl & st, statement_phase phase,
+        long long start)
+        : st_(st), phase_(phase), events_(st.session_.get_statement_events()),
+          tracked_(st.is_tracked(phase)),
+          start_(start), rows_(-1), failed_(true) {}
+
+    ~phase_reporter()
+    {
+        if (events_ == NULL && tracked_ == false)
+        {
+            return;
+        }
+
+        try
+        {
+            long long const end = threading::get_microseconds();
+
+            if (events_ != NULL)
+            {
+                st_.report_phase(*events_, phase_, start_, end, rows_,
+                    failed_);
+            }
+
+            if (tracked_)
+            {
+                st_.add_to_cycle(phase_, end - start_, rows_, failed_);
+            }
+        }
+        catch (...)
+        {
+            // the observer must not throw, and this can't either
+        }
+    }
+
+    bool enabled() const { return events_ != NULL || tracked_; }
+    long long get_start() const { return start_; }
+
+    void done(long long rows = -1)
+    {
+        rows_ = rows;
+        failed_ = false;
+    }
+
+    // don't report the phase, it's going to be done later
+    void cancel()
+    {
+        events_ = NULL;
+        tracked_ = false;
+    }
+
+private:
+    statement_impl & st_;
+    statement_phase const phase_;
+    statement_event_buffer * events_;
+    bool tracked_;
+    long long const start_;
+    long long rows_;
+    bool failed_;
+
+    phase_reporter(phase_reporter const &);
+    phase_reporter & operator=(phase_reporter const &);
+};
+
+} // namespace details
+} // namespace soci
+
+namespace // anonymous
+{
+
+class statement_execute_task : public async_task
+{
+public:
+    statement_execute_task(statement & st, bool withDataExchange)
+        : st_(st), withDataExchange_(withDataExchange) {}
+
+    virtual bool start(step_status & status)
+    {
+        if (st_.can_start_execute() == false)
+        {
+            return false;
+        }
+
+        status = st_.start_execute(withDataExchange_);
+        return true;
+    }
+
+    virtual step_status step() { return st_.step(); }
+    virtual bool result() { return st_.got_data(); }
+
+    virtual bool run() { return st_.execute(withDataExchange_); }
+
+private:
+    statement & st_;
+    bool const withDataExchange_;
+};
+
+class statement_fetch_task : public async_task
+{
+public:
+    explicit statement_fetch_task(statement & st) : st_(st) {}
+
+    virtual bool start(step_status & status)
+    {
+        if (st_.can_fetch_without_blocking() == false)
+        {
+            return false;
+        }
+
+        st_.fetch();
+        status = step_done;
+        return true;
+    }
+
+    virtual bool result() { return st_.got_data(); }
+
+    virtual bool run() { return st_.fetch(); }
+
+private:
+    statement & st_;
+};
+
+} // namespace anonymous
+
+async_result statement::execute_async(bool withDataExchange)
+{
+    return impl_->session_.run_async(
+        new statement_execute_task(*this, withDataExchange));
+}
+
+async_result statement::fetch_async()
+{
+    return impl_->session_.run_async(new statement_fetch_task(*this));
+}
+
 void statement::exchange(into_type_ptr const & i)
 {
     impl_->exchange(i);
@@ -33,15 +223,28 @@ void statement::exchange(use_type_ptr const & u)
 
 statement_impl::statement_impl(session & s)
     : session_(s), refCount_(1), row_(0),
-      fetchSize_(1), initialFetchSize_(1),
-      alreadyDescribed_(false)
+      fetchSize_(1), initialFetchSize_(1), placeholdersParsed_(false),
+      rowPrefetchSize_(1), prefetchedRows_(0), prefetchedPos_(0),
+      prefetchExhausted_(false),
+      alreadyDescribed_(false), cache_(NULL), backEndReusable_(false),
+      nonBlockingNum_(-1), nonBlockingStart_(0),
+      cycleActive_(false), cyclePrepareTime_(0), cycleExecuteTime_(0),
+      cycleFetchTime_(0), cycleFetches_(0), cycleRows_(0),
+      cycleFailed_(false), prepareTime_(0)
 {
     backEnd_ = s.make_statement_backend();
 }
 
 statement_impl::statement_impl(prepare_temp_type const & prep)
     : session_(prep.get_prepare_info()->session_),
-      refCount_(1), row_(0), fetchSize_(1), alreadyDescribed_(false)
+      refCount_(1), row_(0), fetchSize_(1), placeholdersParsed_(false),
+      rowPrefetchSize_(1), prefetchedRows_(0), prefetchedPos_(0),
+      prefetchExhausted_(false), alreadyDescribed_(false),
+      cache_(NULL), backEndReusable_(false), nonBlockingNum_(-1),
+      nonBlockingStart_(0),
+      cycleActive_(false), cyclePrepareTime_(0), cycleExecuteTime_(0),
+      cycleFetchTime_(0), cycleFetches_(0), cycleRows_(0),
+      cycleFailed_(false), prepareTime_(0)
 {
     backEnd_ = session_.make_statement_backend();
 
@@ -105,34 +308,14 @@ void statement_impl::bind(values & values)
             else
             {
                 // named use element - check if it is used
-                std::string const placeholder = ":" + useName;
-
-                std::size_t pos = query_.find(placeholder);
-                while (pos != std::string::npos)
+                if (is_placeholder_used(useName))
                 {
-                    // Retrieve next char after placeholder
-                    // make sure we do not go out of range on the string
-                    const char nextChar = (pos + placeholder.size()) < query_.size() ?
-                                          query_[pos + placeholder.size()] : '\0';
-
-                    if (std::isalnum(nextChar))
-                    {
-                        // We got a partial match only,
-                        // keep looking for the placeholder
-                        pos = query_.find(placeholder, pos + placeholder.size());
-                    }
-                    else
-                    {
-                        int position = static_cast<int>(uses_.size());
-                        (*it)->bind(*this, position);
-                        uses_.push_back(*it);
-                        indicators_.push_back(values.indicators_[cnt]);
-                        // Ok we found it, done
-                        break;
-                    }
+                    int position = static_cast<int>(uses_.size());
+                    (*it)->bind(*this, position);
+                    uses_.push_back(*it);
+                    indicators_.push_back(values.indicators_[cnt]);
                 }
-                // In case we couldn't find the placeholder
-                if (pos == std::string::npos)
+                else
                 {
                     values.add_unused(*it, values.indicators_[cnt]);
                 }
@@ -151,6 +334,88 @@ void statement_impl::bind(values & values)
     }
 }
 
+bool statement_impl::is_placeholder_used(std::string const & name)
+{
+    if (!placeholdersParsed_)
+    {
+        // collect the names of all the placeholders, i.e. the alphanumeric
+        // (and underscore) characters following a colon, together with all
+        // their prefixes ending before an underscore, as a placeholder is
+        // considered to be used if its name is followed by a character
+        // which is not alphanumeric
+        placeholders_.clear();
+
+        std::string::size_type const len = query_.size();
+        for (std::string::size_type pos = query_.find(':');
+            pos != std::string::npos; pos = query_.find(':', pos))
+        {
+            std::string::size_type const start = ++pos;
+            for (; pos != len; ++pos)
+            {
+                char const c = query_[pos];
+                if (c == '_')
+                {
+                    if (pos != start)
+                    {
+                        placeholders_.insert(query_.substr(start, pos - start));
+                    }
+                }
+                else if (!std::isalnum(static_cast<unsigned char>(c)))
+                {
+                    break;
+                }
+            }
+
+            if (pos != start)
+            {
+                placeholders_.insert(query_.substr(start, pos - start));
+            }
+        }
+
+        placeholdersParsed_ = true;
+    }
+
+    bool simpleName = true;
+    for (std::string::size_type i = 0; i != name.size(); ++i)
+    {
+        char const c = name[i];
+        if (c != '_' && !std::isalnum(static_cast<unsigned char>(c)))
+        {
+            simpleName = false;
+            break;
+        }
+    }
+
+    if (simpleName)
+    {
+        return placeholders_.find(name) != placeholders_.end();
+    }
+
+    // names containing other characters can't be found in the set, so look
+    // for them in the query itself
+    std::string const placeholder = ":" + name;
+
+    std::size_t pos = query_.find(placeholder);
+    while (pos != std::string::npos)
+    {
+        // Retrieve next char after placeholder
+        // make sure we do not go out of range on the string
+        const char nextChar = (pos + placeholder.size()) < query_.size() ?
+                              query_[pos + placeholder.size()] : '\0';
+
+        if (!std::isalnum(static_cast<unsigned char>(nextChar)))
+        {
+            return true;
+        }
+
+        // We got a partial match only,
+        // keep looking for the placeholder
+        pos = query_.find(placeholder, pos + placeholder.size());
+    }
+
+    return false;
+}
+
 void statement_impl::exchange(into_type_ptr const & i)
 {
     intos_.push_back(i.get());
@@ -174,6 +439,8 @@ void statement_impl::exchange_for_rowset(into_type_ptr const & i)
     intos_.push_back(p);
     i.release();
 
+    rowPrefetchSize_ = session_.get_rowset_prefetch_size();
+
     int definePosition = 1;
     p->define(*this, definePosition);
     definePositionForRow_ = definePosition;
@@ -187,6 +454,8 @@ void statement_impl::exchange(use_type_ptr const & u)
 
 void statement_impl::clean_up()
 {
+    end_cycle();
+
     // deallocate all bind and define objects
     std::size_t const isize = intos_.size();
     for (std::size_t i = isize; i != 0; --i)
@@ -204,6 +473,13 @@ void statement_impl::clean_up()
         intosForRow_.resize(i - 1);
     }
 
+    std::size_t const pbsize = prefetchBuffers_.size();
+    for (std::size_t i = 0; i != pbsize; ++i)
+    {
+        delete prefetchBuffers_[i];
+    }
+    prefetchBuffers_.clear();
+
     std::size_t const usize = uses_.size();
     for (std::size_t i = usize; i != 0; --i)
     {
@@ -221,19 +497,78 @@ void statement_impl::clean_up()
 
     if (backEnd_ != NULL)
     {
-        backEnd_->clean_up();
-        delete backEnd_;
+        phase_reporter reporter(*this, sp_clean_up);
+
+        if (cache_ != NULL && backEndReusable_)
+        {
+            backEnd_->reset();
+            cache_->release(query_, backEnd_);
+        }
+        else
+        {
+            backEnd_->clean_up();
+            delete backEnd_;
+        }
+
         backEnd_ = NULL;
+        cache_ = NULL;
+
+        reporter.done();
     }
 }
 
 void statement_impl::prepare(std::string const & query,
     statement_type eType)
 {
+    end_cycle();
+
     query_ = query;
+    normalizedQuery_.clear();
+    placeholdersParsed_ = false;
     session_.log_query(query);
 
+    phase_reporter reporter(*this, sp_prepare);
     backEnd_->prepare(query, eType);
+    reporter.done();
+}
+
+void statement_impl::prepare_cached(std::string const & query)
+{
+    statement_cache * const cache = session_.get_statement_cache();
+    if (cache == NULL)
+    {
+        alloc();
+        prepare(query, st_one_time_query);
+        return;
+    }
+
+    end_cycle();
+
+    query_ = query;
+    normalizedQuery_.clear();
+    placeholdersParsed_ = false;
+    session_.log_query(query);
+
+    phase_reporter reporter(*this, sp_prepare);
+
+    statement_backend * const cached = cache->acquire(query);
+    if (cached != NULL)
+    {
+        // the backend allocated by the constructor is not needed
+        delete backEnd_;
+        backEnd_ = cached;
+    }
+    else
+    {
+        // the statement is going to be reused, so prepare it as such
+        backEnd_->alloc();
+        backEnd_->prepare(query, st_repeatable_query);
+    }
+
+    cache_ = cache;
+    backEndReusable_ = false;
+
+    reporter.done();
 }
 
 void statement_impl::define_and_bind()
@@ -290,6 +625,112 @@ void statement_impl::undefine_and_bind()
 }
 
 bool statement_impl::execute(bool withDataExchange)
+{
+    end_cycle();
+
+    phase_reporter reporter(*this, sp_execute);
+
+    int const num = begin_execute(withDataExchange);
+
+    bool const gotData = end_execute(backEnd_->execute(num), num);
+
+    if (reporter.enabled())
+    {
+        reporter.done(get_reported_rows(gotData, true));
+    }
+
+    return gotData;
+}
+
+step_status statement_impl::start_execute(bool withDataExchange,
+    bool & gotData)
+{
+    if (nonBlockingNum_ >= 0)
+    {
+        throw soci_error("The statement is already being executed.");
+    }
+
+    end_cycle();
+
+    phase_reporter reporter(*this, sp_execute);
+
+    int const num = begin_execute(withDataExchange);
+
+    if (backEnd_->start_execute(num) == false)
+    {
+        // not supported by the backend, execute synchronously
+        gotData = end_execute(backEnd_->execute(num), num);
+
+        if (reporter.enabled())
+        {
+            reporter.done(get_reported_rows(gotData, true));
+        }
+
+        return step_done;
+    }
+
+    nonBlockingNum_ = num;
+
+    // the execution is reported by step() when it ends
+    nonBlockingStart_ = reporter.get_start();
+    reporter.cancel();
+
+    return step(gotData);
+}
+
+step_status statement_impl::step(bool & gotData)
+{
+    if (nonBlockingNum_ < 0)
+    {
+        throw soci_error("The statement is not being executed.");
+    }
+
+    phase_reporter reporter(*this, sp_execute, nonBlockingStart_);
+
+    int const num = nonBlockingNum_;
+    step_status status;
+    statement_backend::exec_fetch_result res;
+    try
+    {
+        status = backEnd_->step_execute();
+        if (status != step_done)
+        {
+            reporter.cancel();
+            return status;
+        }
+
+        nonBlockingNum_ = -1;
+        res = backEnd_->finish_execute(num);
+    }
+    catch (...)
+    {
+        nonBlockingNum_ = -1;
+        throw;
+    }
+
+    gotData = end_execute(res, num);
+
+    if (reporter.enabled())
+    {
+        reporter.done(get_reported_rows(gotData, true));
+    }
+
+    return status;
+}
+
+bool statement_impl::can_start_execute()
+{
+    // the row description is done synchronously
+    return (row_ == NULL || alreadyDescribed_) &&
+        backEnd_->can_start_execute();
+}
+
+bool statement_impl::can_fetch_without_blocking()
+{
+    return backEnd_->can_fetch_without_blocking();
+}
+
+int statement_impl::begin_execute(bool withDataExchange)
 {
     initialFetchSize_ = intos_size();
 
@@ -307,6 +748,10 @@ bool statement_impl::execute(bool withDataExchange)
 
     pre_use();
 
+    // the values are logged when the execution ends, possibly after fetching
+    // its rows, when the use variables may already have been changed
+    save_cycle_parameters();
+
     std::size_t const bindSize = uses_size();
 
     if (bindSize > 1 && fetchSize_ > 1)
@@ -326,6 +771,31 @@ bool statement_impl::execute(bool withDataExchange)
         define_for_row();
     }
 
+    bool const prefetching = prefetchBuffers_.empty() == false;
+    if (prefetching)
+    {
+        if (bindSize > 1)
+        {
+            throw soci_error(
+                 "Bulk insert/update and bulk select not allowed in same query");
+        }
+
+        // the buffers could have been shrunk by the end of the previous
+        // rowset, make them big enough for the full batch again
+        prefetchedRows_ = 0;
+        prefetchedPos_ = 0;
+        prefetchExhausted_ = false;
+
+        std::size_t const ifrsize = intosForRow_.size();
+        for (std::size_t i = 0; i != ifrsize; ++i)
+        {
+            if (intosForRow_[i]->size() != rowPrefetchSize_)
+            {
+                intosForRow_[i]->resize(rowPrefetchSize_);
+            }
+        }
+    }
+
     int num = 0;
     if (withDataExchange)
     {
@@ -333,6 +803,10 @@ bool statement_impl::execute(bool withDataExchange)
 
         pre_fetch();
 
+        if (prefetching)
+        {
+            num = static_cast<int>(rowPrefetchSize_);
+        }
         if (static_cast<int>(fetchSize_) > num)
         {
             num = static_cast<int>(fetchSize_);
@@ -343,11 +817,30 @@ bool statement_impl::execute(bool withDataExchange)
         }
     }
 
-    statement_backend::exec_fetch_result res = backEnd_->execute(num);
+    return num;
+}
+
+bool statement_impl::end_execute(statement_backend::exec_fetch_result res,
+    int num)
+{
+    bool const prefetching = prefetchBuffers_.empty() == false;
 
     bool gotData = false;
 
-    if (res == statement_backend::ef_success)
+    if (prefetching)
+    {
+        if (num > 0)
+        {
+            gotData = load_prefetched_rows(res, false);
+
+            std::size_t const isize = intos_.size();
+            for (std::size_t i = 0; i != isize; ++i)
+            {
+                intos_[i]->post_fetch(gotData, false);
+            }
+        }
+    }
+    else if (res == statement_backend::ef_success)
     {
         // the "success" means that the statement executed correctly
         // and for select statement this also means that some rows were read
@@ -369,13 +862,16 @@ bool statement_impl::execute(bool withDataExchange)
         gotData = fetchSize_ > 1 ? resize_intos() : false;
     }
 
-    if (num > 0)
+    if (num > 0 && prefetching == false)
     {
         post_fetch(gotData, false);
     }
 
     post_use(gotData);
 
+    // only a statement executed without errors can be safely reused
+    backEndReusable_ = true;
+
     session_.set_got_data(gotData);
     return gotData;
 }
@@ -385,10 +881,208 @@ long long statement_impl::get_affected_rows()
     return backEnd_->get_affected_rows();
 }
 
+long long statement_impl::get_reported_rows(bool gotData, bool executed)
+{
+    if (intos_.empty() && intosForRow_.empty())
+    {
+        if (executed == false)
+        {
+            return -1;
+        }
+
+        try
+        {
+            return backEnd_->get_affected_rows();
+        }
+        catch (soci_error const &)
+        {
+            // not supported by this backend
+            return -1;
+        }
+    }
+
+    if (gotData == false)
+    {
+        return 0;
+    }
+
+    if (prefetchBuffers_.empty() == false)
+    {
+        return static_cast<long long>(prefetchedRows_);
+    }
+
+    return static_cast<long long>(intos_size());
+}
+
+void statement_impl::report_phase(statement_event_buffer & events,
+    statement_phase phase, long long start, long long end, long long rows,
+    bool failed)
+{
+    statement_event & e = events.add();
+    e.phase = phase;
+    e.start = start;
+    e.duration = end - start;
+    e.rows = rows;
+    e.parameters = uses_.size();
+    e.failed = failed;
+    e.query = query_;
+    e.backend = events.get_backend_name(session_.get_backend());
+}
+
+bool statement_impl::is_tracked(statement_phase phase)
+{
+    switch (phase)
+    {
+    case sp_prepare:
+    case sp_execute:
+        return query_statistics::is_enabled() ||
+            session_.get_slow_query_sink() != NULL;
+    case sp_fetch:
+        return cycleActive_;
+    default:
+        return false;
+    }
+}
+
+void statement_impl::add_to_cycle(statement_phase phase, long long duration,
+    long long rows, bool failed)
+{
+    if (phase == sp_prepare && failed == false)
+    {
+        // it's accounted for in the first execution of the statement, the
+        // preparation which failed, and so prevented executing it, is
+        // accounted for as a failed execution
+        prepareTime_ = duration;
+        return;
+    }
+
+    if (phase != sp_fetch)
+    {
+        cycleActive_ = true;
+        cyclePrepareTime_ = prepareTime_;
+        cycleExecuteTime_ = 0;
+        cycleFetchTime_ = 0;
+        cycleFetches_ = 0;
+        cycleRows_ = 0;
+        cycleFailed_ = false;
+        prepareTime_ = 0;
+    }
+
+    switch (phase)
+    {
+    case sp_prepare:
+        // there is no execution to save the values at
+        save_cycle_parameters();
+        cyclePrepareTime_ = duration;
+        break;
+    case sp_execute:
+        cycleExecuteTime_ = duration;
+        break;
+    default:
+        cycleFetchTime_ += duration;
+        ++cycleFetches_;
+        break;
+    }
+
+    if (rows > 0)
+    {
+        cycleRows_ += rows;
+    }
+    cycleFailed_ = cycleFailed_ || failed;
+
+    // there is nothing more to fetch after the last batch of rows or if the
+    // statement doesn't return any
+    if (failed || (phase == sp_fetch && rows <= 0) ||
+        (intos_.empty() && intosForRow_.empty()))
+    {
+        end_cycle();
+    }
+}
+
+void statement_impl::end_cycle()
+{
+    if (cycleActive_ == false)
+    {
+        return;
+    }
+
+    cycleActive_ = false;
+
+    long long const time =
+        cyclePrepareTime_ + cycleExecuteTime_ + cycleFetchTime_;
+
+    try
+    {
+        if (query_statistics::is_enabled())
+        {
+            if (normalizedQuery_.empty())
+            {
+                normalizedQuery_ = query_statistics::normalize(query_);
+            }
+
+            query_statistics::add(normalizedQuery_, time, cycleRows_,
+                cycleFailed_);
+        }
+
+        slow_query_sink * const sink = session_.get_slow_query_sink();
+        if (sink != NULL && time >=
+            static_cast<long long>(session_.get_slow_query_threshold()) * 1000)
+        {
+            log_slow_query(*sink);
+        }
+    }
+    catch (...)
+    {
+        // this is called from the destructor and must not throw
+    }
+}
+
+void statement_impl::save_cycle_parameters()
+{
+    cycleParameters_.clear();
+    if (session_.get_slow_query_sink() == NULL)
+    {
+        return;
+    }
+
+    std::size_t const maxLength = session_.get_slow_query_max_value_length();
+    std::size_t const usize = uses_.size();
+    for (std::size_t i = 0; i != usize; ++i)
+    {
+        std::ostringstream os;
+        uses_[i]->dump_value(os, maxLength);
+        if (os.str().empty() == false)
+        {
+            cycleParameters_.push_back(os.str());
+        }
+    }
+}
+
+void statement_impl::log_slow_query(slow_query_sink & sink)
+{
+    slow_query q;
+    q.query = query_;
+    q.rows = cycleRows_;
+    q.fetches = cycleFetches_;
+    q.prepare_time = cyclePrepareTime_;
+    q.execute_time = cycleExecuteTime_;
+    q.fetch_time = cycleFetchTime_;
+    q.failed = cycleFailed_;
+    q.parameters = cycleParameters_;
+
+    sink.on_slow_query(session_, q);
+}
+
 bool statement_impl::fetch()
 {
+    if (prefetchBuffers_.empty() == false)
+    {
+        return fetch_prefetched_row();
+    }
+
     if (fetchSize_ == 0)
     {
+        end_cycle();
         truncate_intos();
         session_.set_got_data(false);
         return false;
@@ -417,6 +1111,8 @@ bool statement_impl::fetch()
         fetchSize_ = newFetchSize;
     }
 
+    phase_reporter reporter(*this, sp_fetch);
+
     statement_backend::exec_fetch_result const res = backEnd_->fetch(static_cast<int>(fetchSize_));
     if (res == statement_backend::ef_success)
     {
@@ -447,9 +1143,121 @@ bool statement_impl::fetch()
 
     post_fetch(gotData, true);
     session_.set_got_data(gotData);
+
+    if (reporter.enabled())
+    {
+        reporter.done(get_reported_rows(gotData, false));
+    }
+
+    return gotData;
+}
+
+bool statement_impl::load_prefetched_rows(
+    statement_backend::exec_fetch_result res, bool calledFromFetch)
+{
+    // this mirrors what is done for the into vectors in execute() and
+    // fetch(), except that the vectors are our own prefetch buffers
+
+    int rows = backEnd_->get_number_of_rows();
+    if (rows < 0)
+    {
+        rows = 0;
+    }
+    if (static_cast<std::size_t>(rows) > rowPrefetchSize_)
+    {
+        rows = static_cast<int>(rowPrefetchSize_);
+    }
+
+    if (res != statement_backend::ef_success)
+    {
+        // the last bunch of rows, if any, was read
+        prefetchExhausted_ = true;
+
+        std::size_t const ifrsize = intosForRow_.size();
+        for (std::size_t i = 0; i != ifrsize; ++i)
+        {
+            intosForRow_[i]->resize(static_cast<std::size_t>(rows));
+        }
+    }
+
+    prefetchedRows_ = static_cast<std::size_t>(rows);
+    prefetchedPos_ = 0;
+
+    bool const gotData = rows > 0;
+
+    std::size_t const ifrsize = intosForRow_.size();
+    for (std::size_t i = 0; i != ifrsize; ++i)
+    {
+        intosForRow_[i]->post_fetch(gotData, calledFromFetch);
+    }
+
+    if (gotData)
+    {
+        copy_prefetched_row();
+    }
+
     return gotData;
 }
 
+bool statement_impl::fetch_prefetched_row()
+{
+    bool gotData = false;
+
+    if (prefetchedPos_ + 1 < prefetchedRows_)
+    {
+        ++prefetchedPos_;
+        copy_prefetched_row();
+        gotData = true;
+    }
+    else if (prefetchExhausted_ == false)
+    {
+        phase_reporter reporter(*this, sp_fetch);
+
+        statement_backend::exec_fetch_result const res =
+            backEnd_->fetch(static_cast<int>(rowPrefetchSize_));
+
+        gotData = load_prefetched_rows(res, true);
+
+        if (reporter.enabled())
+        {
+            reporter.done(get_reported_rows(gotData, false));
+        }
+    }
+    else
+    {
+        end_cycle();
+    }
+
+    std::size_t const isize = intos_.size();
+    for (std::size_t i = 0; i != isize; ++i)
+    {
+        intos_[i]->post_fetch(gotData, true);
+    }
+
+    session_.set_got_data(gotData);
+    return gotData;
+}
+
+void statement_impl::copy_prefetched_row()
+{
+    std::size_t const pbsize = prefetchBuffers_.size();
+    for (std::size_t i = 0; i != pbsize; ++i)
+    {
+        prefetchBuffers_[i]->copy_row(prefetchedPos_);
+    }
+}
+
+void statement_impl::set_row_prefetch_size(std::size_t size)
+{
+    if (alreadyDescribed_)
+    {
+        throw soci_error(
+            "Row prefetch size must be set before executing the statement.");
+    }
+
+    rowPrefetchSize_ = size != 0 ? size : 1;
+}
+
 std::size_t statement_impl::intos_size()
 {
     // this function does not need to take into account intosForRow_ elements,
@@ -598,48 +1406,78 @@ namespace soci
 namespace details
 {
 
+template<typename T>
+void statement_impl::into_row(std::size_t pos)
+{
+    T & t = row_->holder_value<T>(pos);
+    indicator & ind = row_->holder_indicator(pos);
+
+    // rows can be fetched in batches only if nothing else is fetched
+    // together with them
+    if (rowPrefetchSize_ > 1 && intos_.size() == 1)
+    {
+        prefetch_buffer<T> * buf =
+            new prefetch_buffer<T>(&t, &ind, rowPrefetchSize_);
+        prefetchBuffers_.push_back(buf);
+        exchange_for_row(into(buf->values_, buf->inds_));
+    }
+    else
+    {
+        exchange_for_row(into(t, ind));
+    }
+}
+
 // Map data_types to stock types for dynamic result set support
 
 template<>
-void statement_impl::bind_into<dt_string>()
+void statement_impl::bind_into<dt_string>(std::size_t pos)
 {
-    into_row<std::string>();
+    into_row<std::string>(pos);
 }
 
 template<>
-void statement_impl::bind_into<dt_double>()
+void statement_impl::bind_into<dt_double>(std::size_t pos)
 {
-    into_row<double>();
+    into_row<double>(pos);
 }
 
 template<>
-void statement_impl::bind_into<dt_integer>()
+void statement_impl::bind_into<dt_integer>(std::size_t pos)
 {
-    into_row<int>();
+    into_row<int>(pos);
 }
 
 template<>
-void statement_impl::bind_into<dt_long_long>()
+void statement_impl::bind_into<dt_long_long>(std::size_t pos)
 {
-    into_row<long long>();
+    into_row<long long>(pos);
 }
 
 template<>
-void statement_impl::bind_into<dt_unsigned_long_long>()
+void statement_impl::bind_into<dt_unsigned_long_long>(std::size_t pos)
 {
-    into_row<unsigned long long>();
+    into_row<unsigned long long>(pos);
 }
 
 template<>
-void statement_impl::bind_into<dt_date>()
+void statement_impl::bind_into<dt_date>(std::size_t pos)
 {
-    into_row<std::tm>();
+    into_row<std::tm>(pos);
 }
 
 void statement_impl::describe()
 {
     row_->clean_up();
 
+    std::size_t const pbsize = prefetchBuffers_.size();
+    for (std::size_t i = 0; i != pbsize; ++i)
+    {
+        delete prefetchBuffers_[i];
+    }
+    prefetchBuffers_.clear();
+
+    // describe all the columns first, so that the storage for all the
+    // values can be allocated at once before binding them
     int const numcols = backEnd_->prepare_for_describe();
     for (int i = 1; i <= numcols; ++i)
     {
@@ -652,33 +1490,34 @@ void statement_impl::describe()
         props.set_name(columnName);
         props.set_data_type(dtype);
 
-        switch (dtype)
+        row_->add_properties(props);
+    }
+
+    row_->alloc_holders();
+
+    for (std::size_t pos = 0; pos != static_cast<std::size_t>(numcols); ++pos)
+    {
+        switch (row_->get_properties(pos).get_data_type())
         {
         case dt_string:
-            bind_into<dt_string>();
+            bind_into<dt_string>(pos);
             break;
         case dt_double:
-            bind_into<dt_double>();
+            bind_into<dt_double>(pos);
             break;
         case dt_integer:
-            bind_into<dt_integer>();
+            bind_into<dt_integer>(pos);
             break;
         case dt_long_long:
-            bind_into<dt_long_long>();
+            bind_into<dt_long_long>(pos);
             break;
         case dt_unsigned_long_long:
-            bind_into<dt_unsigned_long_long>();
+            bind_into<dt_unsigned_long_long>(pos);
             break;
         case dt_date:
-            bind_into<dt_date>();
+            bind_into<dt_date>(pos);
             break;
-        default:
-            std::ostringstream msg;
-            msg << "db column type " << dtype
-                <<" not supported for dynamic selects"<<std::endl;
-            throw soci_error(msg.str());
         }
-        row_->add_properties(props);
     }
 
     alreadyDescribed_ = true;
@@ -0,0 +1,302 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_CORE_THREADING_H_INCLUDED
+#define SOCI_CORE_THREADING_H_INCLUDED
+
+// Minimal wrappers for the threading primitives of the platform used
+// internally by the core library.
+
+#include "soci/error.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <sys/time.h>
+#include <time.h>
+#include <errno.h>
+#else
+#include <windows.h>
+#include <process.h>
+#endif
+
+namespace soci
+{
+
+namespace details
+{
+
+namespace threading
+{
+
+#ifndef _WIN32
+// POSIX implementation
+
+class mutex
+{
+public:
+    mutex()
+    {
+        if (pthread_mutex_init(&mtx_, NULL) != 0)
+        {
+            throw soci_error("Synchronization error");
+        }
+    }
+
+    ~mutex() { pthread_mutex_destroy(&mtx_); }
+
+    void lock() { pthread_mutex_lock(&mtx_); }
+    void unlock() { pthread_mutex_unlock(&mtx_); }
+
+    pthread_mutex_t mtx_;
+
+private:
+    mutex(mutex const &);
+    mutex & operator=(mutex const &);
+};
+
+class condition
+{
+public:
+    condition()
+    {
+        if (pthread_cond_init(&cond_, NULL) != 0)
+        {
+            throw soci_error("Synchronization error");
+        }
+    }
+
+    ~condition() { pthread_cond_destroy(&cond_); }
+
+    void wait(mutex & m) { pthread_cond_wait(&cond_, &m.mtx_); }
+
+    // timeout is relative in milliseconds, return false if it expired
+    bool wait(mutex & m, int timeout)
+    {
+        struct timeval tmv;
+        gettimeofday(&tmv, NULL);
+
+        struct timespec tm;
+        tm.tv_sec = tmv.tv_sec + timeout / 1000;
+        tm.tv_nsec = tmv.tv_usec * 1000 + (timeout % 1000) * 1000 * 1000;
+
+        if (tm.tv_nsec >= 1000 * 1000 * 1000)
+        {
+            ++tm.tv_sec;
+            tm.tv_nsec -= 1000 * 1000 * 1000;
+        }
+
+        return pthread_cond_timedwait(&cond_, &m.mtx_, &tm) != ETIMEDOUT;
+    }
+
+    void notify_one() { pthread_cond_signal(&cond_); }
+    void notify_all() { pthread_cond_broadcast(&cond_); }
+
+private:
+    pthread_cond_t cond_;
+
+    condition(condition const &);
+    condition & operator=(condition const &);
+};
+
+// Pointer value stored separately for each thread.
+class thread_specific
+{
+public:
+    thread_specific()
+    {
+        if (pthread_key_create(&key_, NULL) != 0)
+        {
+            throw soci_error("Synchronization error");
+        }
+    }
+
+    ~thread_specific() { pthread_key_delete(key_); }
+
+    void * get() const { return pthread_getspecific(key_); }
+    void set(void * value) { pthread_setspecific(key_, value); }
+
+private:
+    pthread_key_t key_;
+
+    thread_specific(thread_specific const &);
+    thread_specific & operator=(thread_specific const &);
+};
+
+typedef pthread_t thread_handle;
+
+extern "C" typedef void * (*thread_entry)(void *);
+
+inline thread_handle start_thread(thread_entry entry, void * arg)
+{
+    pthread_t th;
+    if (pthread_create(&th, NULL, entry, arg) != 0)
+    {
+        throw soci_error("Cannot create thread");
+    }
+
+    return th;
+}
+
+inline void join_thread(thread_handle th)
+{
+    pthread_join(th, NULL);
+}
+
+// milliseconds elapsed since some unspecified point, not affected by the
+// changes of the system clock
+inline long long get_ticks()
+{
+    struct timespec tm;
+    clock_gettime(CLOCK_MONOTONIC, &tm);
+
+    return static_cast<long long>(tm.tv_sec) * 1000 + tm.tv_nsec / 1000000;
+}
+
+// the same in microseconds, for measuring the durations of the operations
+inline long long get_microseconds()
+{
+    struct timespec tm;
+    clock_gettime(CLOCK_MONOTONIC, &tm);
+
+    return static_cast<long long>(tm.tv_sec) * 1000000 + tm.tv_nsec / 1000;
+}
+
+#define SOCI_THREAD_ENTRY(name, arg) void * name(void * arg)
+#define SOCI_THREAD_RETURN return NULL
+
+#else
+// Windows implementation
+
+class mutex
+{
+public:
+    mutex() { InitializeCriticalSection(&mtx_); }
+    ~mutex() { DeleteCriticalSection(&mtx_); }
+
+    void lock() { EnterCriticalSection(&mtx_); }
+    void unlock() { LeaveCriticalSection(&mtx_); }
+
+    CRITICAL_SECTION mtx_;
+
+private:
+    mutex(mutex const &);
+    mutex & operator=(mutex const &);
+};
+
+class condition
+{
+public:
+    condition() { InitializeConditionVariable(&cond_); }
+
+    void wait(mutex & m)
+    {
+        SleepConditionVariableCS(&cond_, &m.mtx_, INFINITE);
+    }
+
+    bool wait(mutex & m, int timeout)
+    {
+        return SleepConditionVariableCS(&cond_, &m.mtx_,
+            static_cast<DWORD>(timeout)) != 0;
+    }
+
+    void notify_one() { WakeConditionVariable(&cond_); }
+    void notify_all() { WakeAllConditionVariable(&cond_); }
+
+private:
+    CONDITION_VARIABLE cond_;
+
+    condition(condition const &);
+    condition & operator=(condition const &);
+};
+
+class thread_specific
+{
+public:
+    thread_specific()
+    {
+        key_ = TlsAlloc();
+        if (key_ == TLS_OUT_OF_INDEXES)
+        {
+            throw soci_error("Synchronization error");
+        }
+    }
+
+    ~thread_specific() { TlsFree(key_); }
+
+    void * get() const { return TlsGetValue(key_); }
+    void set(void * value) { TlsSetValue(key_, value); }
+
+private:
+    DWORD key_;
+
+    thread_specific(thread_specific const &);
+    thread_specific & operator=(thread_specific const &);
+};
+
+typedef HANDLE thread_handle;
+
+typedef unsigned (__stdcall * thread_entry)(void *);
+
+inline thread_handle start_thread(thread_entry entry, void * arg)
+{
+    uintptr_t const th = _beginthreadex(NULL, 0, entry, arg, 0, NULL);
+    if (th == 0)
+    {
+        throw soci_error("Cannot create thread");
+    }
+
+    return reinterpret_cast<HANDLE>(th);
+}
+
+inline void join_thread(thread_handle th)
+{
+    WaitForSingleObject(th, INFINITE);
+    CloseHandle(th);
+}
+
+inline long long get_ticks()
+{
+    return static_cast<long long>(GetTickCount64());
+}
+
+inline long long get_microseconds()
+{
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+
+    return static_cast<long long>(counter.QuadPart / frequency.QuadPart) *
+        1000000 + (counter.QuadPart % frequency.QuadPart) * 1000000 /
+        frequency.QuadPart;
+}
+
+#define SOCI_THREAD_ENTRY(name, arg) unsigned __stdcall name(void * arg)
+#define SOCI_THREAD_RETURN return 0
+
+#endif // _WIN32
+
+class scoped_lock
+{
+public:
+    explicit scoped_lock(mutex & m) : m_(m) { m_.lock(); }
+    ~scoped_lock() { m_.unlock(); }
+
+private:
+    mutex & m_;
+
+    scoped_lock(scoped_lock const &);
+    scoped_lock & operator=(scoped_lock const &);
+};
+
+} // namespace threading
+
+} // namespace details
+
+} // namespace soci
+
+#endif // SOCI_CORE_THREADING_H_INCLUDED
@@ -8,10 +8,119 @@
 #define SOCI_SOURCE
 #include "soci/use-type.h"
 #include "soci/statement.h"
+#include <cstdio>
+#include <ctime>
+#include <ostream>
 
 using namespace soci;
 using namespace soci::details;
 
+namespace // anonymous
+{
+
+void dump_string(std::ostream & os, std::string const & s,
+    std::size_t maxLength)
+{
+    os << '\'';
+    if (s.size() > maxLength)
+    {
+        os << s.substr(0, maxLength) << "...";
+    }
+    else
+    {
+        os << s;
+    }
+    os << '\'';
+}
+
+void dump_tm(std::ostream & os, std::tm const & t)
+{
+    char buf[80];
+    std::sprintf(buf, "%04d-%02d-%02d %02d:%02d:%02d",
+        t.tm_year + 1900, t.tm_mon + 1, t.tm_mday,
+        t.tm_hour, t.tm_min, t.tm_sec);
+    os << '\'' << buf << '\'';
+}
+
+// write a single value of the given type, using the same representation of
+// the data as the backends
+void dump_data(std::ostream & os, void const * data, exchange_type type,
+    std::size_t maxLength)
+{
+    switch (type)
+    {
+    case x_char:
+        dump_string(os, std::string(1, *static_cast<char const *>(data)),
+            maxLength);
+        break;
+    case x_stdstring:
+        dump_string(os, *static_cast<std::string const *>(data), maxLength);
+        break;
+    case x_short:
+        os << *static_cast<short const *>(data);
+        break;
+    case x_integer:
+        os << *static_cast<int const *>(data);
+        break;
+    case x_long_long:
+        os << *static_cast<long long const *>(data);
+        break;
+    case x_unsigned_long_long:
+        os << *static_cast<unsigned long long const *>(data);
+        break;
+    case x_double:
+        os << *static_cast<double const *>(data);
+        break;
+    case x_stdtm:
+        dump_tm(os, *static_cast<std::tm const *>(data));
+        break;
+    case x_statement:
+        os << "<statement>";
+        break;
+    case x_rowid:
+        os << "<rowid>";
+        break;
+    case x_blob:
+        os << "<blob>";
+        break;
+    }
+}
+
+template <typename T>
+void dump_vector(std::ostream & os, void const * data, exchange_type type,
+    std::vector<indicator> const * ind, std::size_t maxLength)
+{
+    std::vector<T> const & v = *static_cast<std::vector<T> const *>(data);
+
+    os << '[';
+    std::size_t const size = v.size();
+    for (std::size_t i = 0; i != size; ++i)
+    {
+        if (i != 0)
+        {
+            os << ", ";
+        }
+
+        if (i == maxLength)
+        {
+            os << "... (" << size << " values)";
+            break;
+        }
+
+        if (ind != NULL && i < ind->size() && (*ind)[i] == i_null)
+        {
+            os << "NULL";
+        }
+        else
+        {
+            dump_data(os, &v[i], type, maxLength);
+        }
+    }
+    os << ']';
+}
+
+} // namespace anonymous
+
 standard_use_type::~standard_use_type()
 {
     delete backEnd_;
@@ -55,6 +164,19 @@ void standard_use_type::post_use(bool gotData)
     // See conversion_use_type<T>::convert_from_base() for more details.
 }
 
+void standard_use_type::dump_value(std::ostream & os,
+    std::size_t maxLength) const
+{
+    if (ind_ != NULL && *ind_ == i_null)
+    {
+        os << "NULL";
+    }
+    else
+    {
+        dump_data(os, data_, type_, maxLength);
+    }
+}
+
 void standard_use_type::clean_up()
 {
     if (backEnd_ != NULL)
@@ -91,6 +213,41 @@ void vector_use_type::pre_use()
     backEnd_->pre_use(ind_ ? &ind_->at(0) : NULL);
 }
 
+void vector_use_type::dump_value(std::ostream & os,
+    std::size_t maxLength) const
+{
+    switch (type_)
+    {
+    case x_char:
+        dump_vector<char>(os, data_, type_, ind_, maxLength);
+        break;
+    case x_stdstring:
+        dump_vector<std::string>(os, data_, type_, ind_, maxLength);
+        break;
+    case x_short:
+        dump_vector<short>(os, data_, type_, ind_, maxLength);
+        break;
+    case x_integer:
+        dump_vector<int>(os, data_, type_, ind_, maxLength);
+        break;
+    case x_long_long:
+        dump_vector<long long>(os, data_, type_, ind_, maxLength);
+        break;
+    case x_unsigned_long_long:
+        dump_vector<unsigned long long>(os, data_, type_, ind_, maxLength);
+        break;
+    case x_double:
+        dump_vector<double>(os, data_, type_, ind_, maxLength);
+        break;
+    case x_stdtm:
+        dump_vector<std::tm>(os, data_, type_, ind_, maxLength);
+        break;
+    default:
+        os << "<vector>";
+        break;
+    }
+}
+
 std::size_t vector_use_type::size() const
 {
     return backEnd_->size();
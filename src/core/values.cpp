@@ -37,15 +37,62 @@ indicator values::get_indicator(std::string const& name) const
     }
     else
     {
-        std::map<std::string, std::size_t>::const_iterator it = index_.find(name);
-        if (it == index_.end())
+        return *indicators_[find_column(name)];
+    }
+}
+
+std::size_t values::find_column(std::string const& name) const
+{
+    if (row_)
+    {
+        return row_->find_column(name);
+    }
+
+    std::map<std::string, std::size_t>::const_iterator it = index_.find(name);
+    if (it == index_.end())
+    {
+        std::ostringstream msg;
+        msg << "Column '" << name << "' not found";
+        throw soci_error(msg.str());
+    }
+
+    return it->second;
+}
+
+std::size_t values::find_cached_column(char const* name) const
+{
+    std::size_t const size = columnCache_.size();
+    for (std::size_t n = 0; n != size; ++n)
+    {
+        std::size_t i = columnCacheHint_ + n;
+        if (i >= size)
         {
-            std::ostringstream msg;
-            msg << "Column '" << name << "' not found";
-            throw soci_error(msg.str());
+            i -= size;
+        }
+
+        if (columnCache_[i].first == name)
+        {
+            // the name may still be different if it's not a literal but a
+            // buffer whose contents changed, or the row may have been
+            // described again, so check that the position is still right
+            std::size_t const pos = columnCache_[i].second;
+            if (pos >= row_->size() ||
+                row_->get_properties(pos).get_name() != name)
+            {
+                columnCache_[i].second = row_->find_column(name);
+            }
+
+            columnCacheHint_ = i + 1;
+            return columnCache_[i].second;
         }
-        return *indicators_[it->second];
     }
+
+    std::size_t const pos = row_->find_column(name);
+
+    columnCache_.push_back(cached_column(name, pos));
+    columnCacheHint_ = size + 1;
+
+    return pos;
 }
 
 column_properties const& values::get_properties(std::size_t pos) const
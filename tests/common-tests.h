@@ -32,6 +32,7 @@
 #include <clocale>
 #include <cstdlib>
 #include <cmath>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
 #include <limits>
@@ -49,6 +50,10 @@ struct PhonebookEntry2 : public PhonebookEntry
 {
 };
 
+struct PhonebookEntry4 : public PhonebookEntry
+{
+};
+
 class PhonebookEntry3
 {
 public:
@@ -160,6 +165,31 @@ template<> struct type_conversion<PhonebookEntry3>
     }
 };
 
+// type conversion looking up the columns using a buffer with changing
+// contents instead of string literals
+template<> struct type_conversion<PhonebookEntry4>
+{
+    typedef soci::values base_type;
+
+    static void from_base(values const &v, indicator /* ind */, PhonebookEntry4 &pe)
+    {
+        char column[16];
+
+        std::strcpy(column, "NAME");
+        pe.name = v.get<std::string>(column);
+
+        std::strcpy(column, "PHONE");
+        pe.phone = v.get<std::string>(column, "<NULL>");
+    }
+
+    static void to_base(PhonebookEntry4 const &pe, values &v, indicator &ind)
+    {
+        v.set("NAME", pe.name);
+        v.set("PHONE", pe.phone, pe.phone.empty() ? i_null : i_ok);
+        ind = i_ok;
+    }
+};
+
 } // namespace soci
 
 namespace soci
@@ -2153,6 +2183,103 @@ TEST_CASE_METHOD(common_tests, "Dynamic row binding 3", "[core][dynamic]")
     CHECK(count == 3);
 }
 
+// test looking up the columns of dynamic rows by name
+TEST_CASE_METHOD(common_tests, "Dynamic row column lookup", "[core][dynamic]")
+{
+    session sql(backEndFactory_, connectString_);
+
+    sql.uppercase_column_names(true);
+
+    auto_table_creator tableCreator(tc_.table_creator_3(sql));
+
+    sql << "insert into soci_test values('david', NULL)";
+    sql << "insert into soci_test values('john', '(404)123-4567')";
+
+    row r;
+    statement st = (sql.prepare <<
+        "select * from soci_test order by name", into(r));
+    st.execute();
+
+    // the positions of the columns remain valid for all rows
+    std::size_t const posName = r.find_column("NAME");
+    std::size_t const posPhone = r.find_column(std::string("PHONE"));
+    CHECK(posName == 0);
+    CHECK(posPhone == 1);
+    CHECK_THROWS_AS(r.find_column("NO_SUCH_COLUMN"), soci_error);
+
+    // names stored in a buffer longer than the name itself
+    char phone[32] = "PHONE";
+
+    int count = 0;
+    while (st.fetch())
+    {
+        ++count;
+        if (count == 1)
+        {
+            CHECK(r.get<std::string>(posName) == "david");
+            CHECK(r.get_indicator(posPhone) == i_null);
+            CHECK(r.get_indicator("PHONE") == i_null);
+            CHECK(r.get<std::string>(phone, "<NULL>") == "<NULL>");
+        }
+        else
+        {
+            CHECK(r.get<std::string>("NAME") == "john");
+            CHECK(r.get<std::string>(posPhone) == "(404)123-4567");
+            CHECK(r.get<std::string>(phone) == "(404)123-4567");
+        }
+    }
+    CHECK(count == 2);
+}
+
+// test reusing the positions of the columns looked up by values for all rows
+TEST_CASE_METHOD(common_tests, "Dynamic type conversion column lookup", "[core][dynamic][type_conversion]")
+{
+    session sql(backEndFactory_, connectString_);
+
+    sql.uppercase_column_names(true);
+
+    auto_table_creator tableCreator(tc_.table_creator_3(sql));
+
+    sql << "insert into soci_test values('david', NULL)";
+    sql << "insert into soci_test values('john', '(404)123-4567')";
+
+    SECTION("String literals")
+    {
+        PhonebookEntry p;
+        statement st = (sql.prepare <<
+            "select * from soci_test order by name", into(p));
+        st.execute();
+
+        REQUIRE(st.fetch());
+        CHECK(p.name == "david");
+        CHECK(p.phone == "<NULL>");
+
+        REQUIRE(st.fetch());
+        CHECK(p.name == "john");
+        CHECK(p.phone == "(404)123-4567");
+
+        CHECK(!st.fetch());
+    }
+
+    SECTION("Buffer")
+    {
+        PhonebookEntry4 p;
+        statement st = (sql.prepare <<
+            "select * from soci_test order by name", into(p));
+        st.execute();
+
+        REQUIRE(st.fetch());
+        CHECK(p.name == "david");
+        CHECK(p.phone == "<NULL>");
+
+        REQUIRE(st.fetch());
+        CHECK(p.name == "john");
+        CHECK(p.phone == "(404)123-4567");
+
+        CHECK(!st.fetch());
+    }
+}
+
 // This is like the previous test but with a type_conversion instead of a row
 TEST_CASE_METHOD(common_tests, "Dynamic binding with type conversions", "[core][dynamic][type_conversion]")
 {
@@ -2357,6 +2484,37 @@ TEST_CASE_METHOD(common_tests, "Partial match with ORM", "[core][orm]")
     CHECK(out.phone == "phone1");
 }
 
+// only the named values referenced in the query should be bound
+TEST_CASE_METHOD(common_tests, "Named use elements of values", "[core][use][named-params]")
+{
+    session sql(backEndFactory_, connectString_);
+    sql.uppercase_column_names(true);
+    auto_table_creator tableCreator(tc_.table_creator_3(sql));
+
+    values v;
+    v.set("NAM", std::string("prefix"));
+    v.set("NAME", std::string("name1"));
+    v.set("NAME_SUFFIX", std::string("suffix"));
+    v.set("PHONE", std::string("phone1"));
+    v.set("UNUSED", 17);
+
+    sql << "insert into soci_test(name, phone) values(:NAME, :PHONE)", use(v);
+
+    std::string name, phone;
+    sql << "select name, phone from soci_test", into(name), into(phone);
+    CHECK(name == "name1");
+    CHECK(phone == "phone1");
+
+    // placeholders with underscores in their names
+    values v2;
+    v2.set("NAME", std::string("name1"));
+    v2.set("NAME_SUFFIX", std::string("suffix"));
+    v2.set("NAME_SUFFIX_2", std::string("unused"));
+    sql << "update soci_test set phone = :NAME_SUFFIX where name = :NAME", use(v2);
+    sql << "select phone from soci_test", into(phone);
+    CHECK(phone == "suffix");
+}
+
 TEST_CASE_METHOD(common_tests, "Numeric round trip", "[core][float]")
 {
     session sql(backEndFactory_, connectString_);
@@ -2851,6 +3009,86 @@ TEST_CASE_METHOD(common_tests, "Dynamic binding with rowset", "[core][dynamic][t
     }
 }
 
+// test for fetching the rows of rowset in batches
+TEST_CASE_METHOD(common_tests, "Rowset prefetch", "[core][rowset][prefetch]")
+{
+    session sql(backEndFactory_, connectString_);
+
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+    for (int i = 1; i <= 10; ++i)
+    {
+        if (i % 3 == 0)
+        {
+            sql << "insert into soci_test(id, val) values(:id, NULL)", use(i);
+        }
+        else
+        {
+            int const val = 10 * i;
+            sql << "insert into soci_test(id, val) values(:id, :val)",
+                use(i), use(val);
+        }
+    }
+
+    // try with the batch size dividing the number of rows or not
+    for (std::size_t prefetch = 1; prefetch <= 11; ++prefetch)
+    {
+        rowset<row> rs((sql.prepare <<
+            "select id, val from soci_test order by id"), prefetch);
+
+        int count = 0;
+        for (rowset<row>::const_iterator it = rs.begin(); it != rs.end(); ++it)
+        {
+            ++count;
+
+            row const& r = *it;
+            CHECK(r.get<int>(0) == count);
+            if (count % 3 == 0)
+            {
+                CHECK(r.get_indicator(1) == i_null);
+            }
+            else
+            {
+                CHECK(r.get<int>(1) == 10 * count);
+            }
+        }
+
+        CHECK(count == 10);
+    }
+
+    // empty rowset
+    {
+        rowset<row> rs((sql.prepare <<
+            "select id from soci_test where id > 100"), 4);
+        CHECK(rs.begin() == rs.end());
+    }
+
+    // prefetching can be used with statements too and survives re-execution
+    {
+        row r;
+        statement st = (sql.prepare <<
+            "select id from soci_test order by id", into(r));
+        st.set_row_prefetch_size(4);
+
+        for (int n = 0; n != 2; ++n)
+        {
+            int count = 0;
+            for (bool ok = st.execute(true); ok; ok = st.fetch())
+            {
+                CHECK(r.get<int>(0) == ++count);
+            }
+            CHECK(count == 10);
+        }
+    }
+
+    // the session default is used if no explicit size is given
+    sql.set_rowset_prefetch_size(4);
+    CHECK(sql.get_rowset_prefetch_size() == 4);
+    {
+        rowset<row> rs = (sql.prepare << "select id from soci_test");
+        CHECK(10 == std::distance(rs.begin(), rs.end()));
+    }
+}
+
 #ifdef HAVE_BOOST
 
 // test for handling NULL values with boost::optional
@@ -3639,6 +3877,267 @@ TEST_CASE_METHOD(common_tests, "Connection pool", "[core][connection][pool]")
     }
 }
 
+// leases an entry from the pool in the background thread of a session
+class pool_lease_task : public details::async_task
+{
+public:
+    pool_lease_task(connection_pool & pool, int timeout, std::size_t & pos)
+        : pool_(pool), timeout_(timeout), pos_(pos) {}
+
+    virtual bool run() { return pool_.try_lease(pos_, timeout_); }
+
+private:
+    connection_pool & pool_;
+    int timeout_;
+    std::size_t & pos_;
+};
+
+TEST_CASE_METHOD(common_tests, "Connection pool leasing order", "[core][connection][pool]")
+{
+    const size_t pool_size = 3;
+    connection_pool pool(pool_size);
+
+    // initially the entries are leased in order
+    CHECK(pool.lease() == 0);
+    CHECK(pool.lease() == 1);
+    CHECK(pool.lease() == 2);
+
+    std::size_t pos;
+    CHECK(!pool.try_lease(pos, 0));
+    CHECK(!pool.try_lease(pos, 10));
+
+    // the most recently given back entry is reused first
+    pool.give_back(0);
+    pool.give_back(2);
+    CHECK(pool.lease() == 2);
+    CHECK_THROWS_AS(pool.give_back(0), soci_error);
+
+    // with thread affinity the entry leased by this thread before is
+    // preferred to the most recently given back one
+    CHECK(!pool.get_thread_affinity());
+    pool.set_thread_affinity(true);
+    CHECK(pool.get_thread_affinity());
+    CHECK(pool.lease() == 0);
+    pool.give_back(0);
+    pool.give_back(1);
+    CHECK(pool.lease() == 0);
+    pool.set_thread_affinity(false);
+    CHECK(pool.lease() == 1);
+
+    // a thread waiting for an entry gets it as soon as it's given back
+    session worker;
+    std::size_t workerPos = pool_size;
+    async_result res = worker.run_async(new pool_lease_task(pool, -1, workerPos));
+    pool.give_back(2);
+    CHECK(res.get());
+    CHECK(workerPos == 2);
+
+    res = worker.run_async(new pool_lease_task(pool, 10, workerPos));
+    CHECK(!res.get());
+}
+
+// wait for the given number of milliseconds without using any platform API
+void wait_ms(int ms)
+{
+    connection_pool sleeper(1);
+    sleeper.lease();
+
+    std::size_t pos;
+    sleeper.try_lease(pos, ms);
+}
+
+TEST_CASE_METHOD(common_tests, "Elastic connection pool", "[core][connection][pool]")
+{
+    connection_parameters params(backEndFactory_, connectString_);
+
+    CHECK_THROWS_AS(connection_pool(params, 2, 1), soci_error);
+
+    // the first sessions are opened immediately
+    connection_pool pool(params, 2, 4);
+    CHECK(pool.get_open_count() == 2);
+    CHECK(pool.at(0).get_backend() != NULL);
+    CHECK(pool.at(1).get_backend() != NULL);
+    CHECK(pool.at(2).get_backend() == NULL);
+
+    // and the others when needed
+    {
+        session sql1(pool);
+        session sql2(pool);
+        CHECK(pool.get_open_count() == 2);
+
+        session sql3(pool);
+        CHECK(pool.get_open_count() == 3);
+        CHECK(sql3.get_backend() != NULL);
+
+        auto_table_creator tableCreator(tc_.table_creator_1(sql3));
+    }
+
+    CHECK(pool.get_idle_timeout() == 0);
+    CHECK_THROWS_AS(connection_pool(1).set_idle_timeout(10), soci_error);
+
+    // the sessions which are not used any more are closed, but not the
+    // initial ones
+    pool.set_idle_timeout(10);
+    for (int n = 0; n != 100 && pool.get_open_count() != 2; ++n)
+    {
+        wait_ms(10);
+    }
+    CHECK(pool.get_open_count() == 2);
+
+    // the closed entries can't be given back
+    CHECK_THROWS_AS(pool.give_back(2), soci_error);
+    CHECK_THROWS_AS(pool.give_back(3), soci_error);
+
+    // a closed session is reopened when it's needed again
+    session sql1(pool);
+    session sql2(pool);
+    session sql3(pool);
+    CHECK(sql3.get_backend() != NULL);
+    CHECK(pool.get_open_count() == 3);
+}
+
+TEST_CASE_METHOD(common_tests, "Connection pool health checks", "[core][connection][pool]")
+{
+    {
+        session sql(backEndFactory_, connectString_);
+        CHECK(sql.is_connected());
+        sql.close();
+        CHECK(!sql.is_connected());
+    }
+
+    connection_parameters params(backEndFactory_, connectString_);
+    connection_pool pool(params, 2, 2);
+
+    pool.set_validate_on_lease(true);
+    CHECK(pool.get_validate_on_lease());
+    {
+        session sql(pool);
+        CHECK(sql.is_connected());
+    }
+
+    // make all sessions appear to be broken to the background checks
+    pool.set_validation_query("select * from soci_no_such_table");
+    pool.set_validation_interval(10);
+    CHECK(pool.get_validation_interval() == 10);
+
+    std::size_t pos;
+    bool broken = false;
+    for (int n = 0; n != 100 && !broken; ++n)
+    {
+        wait_ms(20);
+        if (pool.try_lease(pos, 0))
+        {
+            pool.give_back(pos);
+        }
+        else
+        {
+            broken = true;
+        }
+    }
+    CHECK(broken);
+
+    // they are reconnected in the background once they can be validated
+    pool.set_validation_query("");
+    REQUIRE(pool.try_lease(pos, 5000));
+    pool.give_back(pos);
+
+    // the sessions unused for some time are checked when they are leased
+    pool.set_validation_interval(0);
+    wait_ms(600);
+    pool.set_validation_query("select * from soci_no_such_table");
+    CHECK(!pool.try_lease(pos, 0));
+
+    pool.set_validation_query("");
+    REQUIRE(pool.try_lease(pos, 5000));
+    pool.give_back(pos);
+
+    // using the sessions doesn't count as checking them, as the connection
+    // could have been lost meanwhile
+    std::size_t pos2;
+    REQUIRE(pool.try_lease(pos, 5000));
+    REQUIRE(pool.try_lease(pos2, 5000));
+    wait_ms(600);
+    pool.give_back(pos);
+    pool.give_back(pos2);
+    pool.set_validation_query("select * from soci_no_such_table");
+    CHECK(!pool.try_lease(pos, 0));
+
+    pool.set_validation_query("");
+    REQUIRE(pool.try_lease(pos, 5000));
+    pool.give_back(pos);
+}
+
+TEST_CASE_METHOD(common_tests, "Connection pool statistics", "[core][connection][pool]")
+{
+    duration_histogram h;
+    CHECK(h.percentile(0.5) == 0);
+    CHECK(h.mean() == 0);
+    h.add(0);
+    h.add(1);
+    h.add(3);
+    h.add(100);
+    CHECK(h.count == 4);
+    CHECK(h.longest == 100);
+    CHECK(h.mean() == 26);
+    CHECK(h.percentile(0.5) == 2);
+    CHECK(h.percentile(0.75) == 4);
+    CHECK(h.percentile(1.0) == 100);
+
+    connection_parameters params(backEndFactory_, connectString_);
+    connection_pool pool(params, 1, 2);
+
+    connection_pool_stats stats = pool.get_stats();
+    CHECK(stats.opens == 1);
+    CHECK(stats.open_time.count == 1);
+    CHECK(stats.idle == 1);
+    CHECK(stats.in_use == 0);
+
+    std::size_t pos1 = pool.lease();
+    std::size_t pos2 = pool.lease();
+    std::size_t pos;
+    CHECK(!pool.try_lease(pos, 0));
+
+    stats = pool.get_stats();
+    CHECK(stats.leases == 2);
+    CHECK(stats.lease_wait.count == 2);
+    CHECK(stats.timeouts == 1);
+    CHECK(stats.opens == 2);
+    CHECK(stats.in_use == 2);
+    CHECK(stats.idle == 0);
+
+    // a thread waiting for an entry is counted until it gets one
+    session worker;
+    async_result res = worker.run_async(new pool_lease_task(pool, -1, pos));
+    for (int n = 0; n != 100 && pool.get_stats().waiters == 0; ++n)
+    {
+        wait_ms(10);
+    }
+    CHECK(pool.get_stats().waiters == 1);
+
+    pool.give_back(pos1);
+    CHECK(res.get());
+    pool.give_back(pos);
+    pool.give_back(pos2);
+
+    stats = pool.get_stats();
+    CHECK(stats.leases == 3);
+    CHECK(stats.waits == 1);
+    CHECK(stats.waiters == 0);
+    CHECK(stats.max_waiters == 1);
+    CHECK(stats.lease_hold.count == 3);
+    CHECK(stats.in_use == 0);
+    CHECK(stats.idle == 2);
+
+    // resetting the statistics doesn't affect the current state
+    pool.reset_stats();
+    stats = pool.get_stats();
+    CHECK(stats.leases == 0);
+    CHECK(stats.opens == 0);
+    CHECK(stats.max_waiters == 0);
+    CHECK(stats.lease_wait.count == 0);
+    CHECK(stats.idle == 2);
+}
+
 // Issue 66 - test query transformation callback feature
 static std::string no_op_transform(std::string query)
 {
@@ -3938,6 +4437,503 @@ TEST_CASE_METHOD(common_tests, "Bind memory leak", "[core][leak]")
     }
 }
 
+// test the session statement cache used by "once" queries
+TEST_CASE_METHOD(common_tests, "Statement cache", "[core][statement-cache]")
+{
+    session sql(backEndFactory_, connectString_);
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+
+    CHECK(sql.get_statement_cache_size() == 0);
+    sql.set_statement_cache_size(2);
+    CHECK(sql.get_statement_cache_size() == 2);
+
+    for (int i = 0; i != 10; ++i)
+    {
+        int const val = i * 10;
+        sql << "insert into soci_test(id, val) values(:id, :val)",
+            use(i), use(val);
+    }
+
+    statement_cache_stats stats = sql.get_statement_cache_stats();
+    CHECK(stats.misses == 1);
+    CHECK(stats.hits == 9);
+    CHECK(stats.size == 1);
+
+    // the cached statement must be rebound to the new variables
+    int sum = 0;
+    for (int i = 0; i != 10; ++i)
+    {
+        int val = -1;
+        sql << "select val from soci_test where id = :id", use(i), into(val);
+        CHECK(val == i * 10);
+        sum += val;
+    }
+    CHECK(sum == 450);
+
+    // a statement which didn't consume all its rows is reused too
+    int id = -1;
+    sql << "select id from soci_test order by id", into(id);
+    CHECK(id == 0);
+    sql << "select id from soci_test order by id", into(id);
+    CHECK(id == 0);
+
+    // the least recently used statement is evicted
+    stats = sql.get_statement_cache_stats();
+    CHECK(stats.size == 2);
+    CHECK(stats.evictions == 1);
+
+    // a failed statement is not kept in the cache
+    CHECK_THROWS_AS((sql << "select * from soci_test_nosuchtable"), soci_error);
+    CHECK_THROWS_AS((sql << "select * from soci_test_nosuchtable"), soci_error);
+    CHECK(sql.get_statement_cache_stats().misses == 5);
+
+    // dynamic rows work with cached statements as well
+    for (int i = 0; i != 2; ++i)
+    {
+        row r;
+        sql << "select id, val from soci_test where id = 3", into(r);
+        REQUIRE(r.size() == 2);
+        CHECK(r.get<int>(1) == 30);
+    }
+
+    sql.reset_statement_cache_stats();
+    CHECK(sql.get_statement_cache_stats().hits == 0);
+
+    sql.clear_statement_cache();
+    CHECK(sql.get_statement_cache_stats().size == 0);
+
+    sql.set_statement_cache_size(0);
+    sql << "delete from soci_test";
+    sql << "delete from soci_test";
+    CHECK(sql.get_statement_cache_stats().misses == 0);
+}
+
+// test executing the statements in the background
+TEST_CASE_METHOD(common_tests, "Asynchronous execution", "[core][async]")
+{
+    session sql(backEndFactory_, connectString_);
+
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+
+    async_result none;
+    CHECK(!none.valid());
+    CHECK_THROWS_AS(none.get(), soci_error);
+
+    async_result r1 = sql.once_async("insert into soci_test(id) values(1)");
+    async_result r2 = sql.once_async("insert into soci_test(id) values(2)");
+    CHECK(r1.valid());
+    r2.get();
+    CHECK(r1.is_ready());
+
+    // errors are reported when retrieving the result
+    async_result r3 = sql.once_async("select * from soci_test_nosuchtable");
+    CHECK(r3.wait());
+    CHECK_THROWS_AS(r3.get(), soci_error);
+
+    int id = 0;
+    statement st = (sql.prepare <<
+        "select id from soci_test order by id", into(id));
+
+    async_result r4 = st.execute_async();
+    r4.get();
+    CHECK(id == 0);
+
+    CHECK(st.fetch_async().get());
+    CHECK(id == 1);
+    CHECK(st.fetch_async().get());
+    CHECK(id == 2);
+    CHECK(!st.fetch_async().get());
+    CHECK(!st.got_data());
+
+    // the results can be copied and retrieved several times
+    async_result r5 = st.execute_async(true);
+    async_result r6 = r5;
+    r6 = r5;
+    sql.wait_async();
+    CHECK(r5.is_ready());
+    CHECK(r6.get());
+    CHECK(r5.get());
+    CHECK(id == 1);
+}
+
+TEST_CASE_METHOD(common_tests, "Non-blocking execution", "[core][nonblocking]")
+{
+    session sql(backEndFactory_, connectString_);
+
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+
+    // the descriptor is either valid or -1 if it's not available
+    CHECK(sql.get_socket() >= -1);
+
+    int id = 1;
+    statement ins = (sql.prepare <<
+        "insert into soci_test(id) values(:id)", use(id));
+
+    step_status status = ins.start_execute(true);
+    while (status != step_done)
+    {
+        // a real application would wait for the socket to become readable
+        // or writable here
+        status = ins.step();
+    }
+
+    id = 2;
+    ins.execute(true);
+
+    // step() can't be called when the statement is not being executed
+    CHECK_THROWS_AS(ins.step(), soci_error);
+
+    int val = 0;
+    statement st = (sql.prepare <<
+        "select id from soci_test where id = :id", use(id), into(val));
+
+    id = 2;
+    for (status = st.start_execute(true); status != step_done; )
+    {
+        status = st.step();
+    }
+    CHECK(st.got_data());
+    CHECK(val == 2);
+
+    id = 3;
+    for (status = st.start_execute(true); status != step_done; )
+    {
+        status = st.step();
+    }
+    CHECK(!st.got_data());
+
+    // the results of a query executed without blocking can be fetched
+    statement all = (sql.prepare <<
+        "select id from soci_test order by id", into(val));
+    for (status = all.start_execute(); status != step_done; )
+    {
+        status = all.step();
+    }
+    REQUIRE(all.fetch());
+    CHECK(val == 1);
+    REQUIRE(all.fetch());
+    CHECK(val == 2);
+    CHECK(!all.fetch());
+}
+
+// collects all the events reported to it
+class recording_observer : public statement_observer
+{
+public:
+    recording_observer() : batches_(0) {}
+
+    virtual void on_events(session &,
+        statement_event const * events, std::size_t count)
+    {
+        ++batches_;
+        events_.insert(events_.end(), events, events + count);
+    }
+
+    std::vector<statement_event> events_;
+    int batches_;
+};
+
+TEST_CASE_METHOD(common_tests, "Statement observer", "[core][observer]")
+{
+    session sql(backEndFactory_, connectString_);
+
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+
+    recording_observer observer;
+    CHECK(sql.get_statement_observer() == NULL);
+    sql.set_statement_observer(&observer, 4);
+    CHECK(sql.get_statement_observer() == &observer);
+
+    std::string const insert = "insert into soci_test(id) values(:id)";
+    int id = 1;
+    sql << insert, use(id);
+
+    // the events are buffered until they are flushed
+    CHECK(observer.events_.empty());
+    sql.flush_statement_events();
+    REQUIRE(observer.events_.size() == 3);
+    CHECK(observer.batches_ == 1);
+
+    CHECK(observer.events_[0].phase == sp_prepare);
+    CHECK(observer.events_[1].phase == sp_execute);
+    CHECK(observer.events_[1].parameters == 1);
+    CHECK(observer.events_[1].rows == 1);
+    CHECK(observer.events_[2].phase == sp_clean_up);
+    for (std::size_t i = 0; i != observer.events_.size(); ++i)
+    {
+        statement_event const & e = observer.events_[i];
+        CHECK(e.query == insert);
+        CHECK(e.backend == sql.get_backend_name());
+        CHECK(!e.failed);
+        CHECK(e.duration >= 0);
+        if (i != 0)
+        {
+            CHECK(e.start >= observer.events_[i - 1].start);
+        }
+    }
+
+    for (id = 2; id != 6; ++id)
+    {
+        sql << insert, use(id);
+    }
+
+    // each batch of fetched rows is reported separately
+    observer.events_.clear();
+    std::vector<int> ids(2);
+    {
+        statement st = (sql.prepare <<
+            "select id from soci_test order by id", into(ids));
+        sql.flush_statement_events();
+        observer.events_.clear();
+
+        CHECK(st.execute(true));
+        CHECK(st.fetch());
+        CHECK(st.fetch());
+        CHECK(!st.fetch());
+    }
+    sql.flush_statement_events();
+
+    REQUIRE(observer.events_.size() == 4);
+    CHECK(observer.events_[0].phase == sp_execute);
+    CHECK(observer.events_[0].rows == 2);
+    CHECK(observer.events_[1].phase == sp_fetch);
+    CHECK(observer.events_[1].rows == 2);
+    CHECK(observer.events_[2].phase == sp_fetch);
+    CHECK(observer.events_[2].rows == 1);
+    CHECK(observer.events_[3].phase == sp_clean_up);
+
+    // the failed phases are reported too
+    observer.events_.clear();
+    CHECK_THROWS_AS((sql << "select id from soci_no_such_table"), soci_error);
+    sql.set_statement_observer(NULL);
+    CHECK(sql.get_statement_observer() == NULL);
+
+    bool failed = false;
+    for (std::size_t i = 0; i != observer.events_.size(); ++i)
+    {
+        failed = failed || observer.events_[i].failed;
+    }
+    CHECK(failed);
+}
+
+// find the statistics of the given query or return NULL
+query_stats const * find_query_stats(std::vector<query_stats> const & stats,
+    std::string const & query)
+{
+    for (std::size_t i = 0; i != stats.size(); ++i)
+    {
+        if (stats[i].query == query)
+        {
+            return &stats[i];
+        }
+    }
+
+    return NULL;
+}
+
+TEST_CASE_METHOD(common_tests, "Query statistics", "[core][query-stats]")
+{
+    CHECK(query_statistics::normalize(
+        "select  x1 from t where a = 'it''s'\n and b >= 1.5e-3 and c = :c")
+        == "select x1 from t where a = ? and b >= ? and c = :c");
+    CHECK(query_statistics::normalize(
+        " insert into t(\"col 2\") values(-12, ?, $1) ")
+        == "insert into t(\"col 2\") values(-?, ?, $1)");
+
+    session sql(backEndFactory_, connectString_);
+
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+
+    CHECK(!query_statistics::is_enabled());
+    query_statistics::reset();
+    query_statistics::enable(true);
+
+    for (int i = 1; i != 4; ++i)
+    {
+        sql << "insert into soci_test(id) values(" << i << ")";
+    }
+
+    {
+        std::vector<int> ids(2);
+        statement st = (sql.prepare <<
+            "select id from soci_test order by id", into(ids));
+        st.execute(true);
+        while (st.fetch())
+        {
+        }
+    }
+
+    CHECK_THROWS_AS((sql << "select id from soci_no_such_table"), soci_error);
+
+    query_statistics::enable(false);
+    sql << "insert into soci_test(id) values(4)";
+
+    std::vector<query_stats> const stats = query_statistics::get();
+
+    query_stats const * s = find_query_stats(stats,
+        "insert into soci_test(id) values(?)");
+    REQUIRE(s != NULL);
+    CHECK(s->calls == 3);
+    CHECK(s->errors == 0);
+    CHECK(s->rows == 3);
+    CHECK(s->time.count == 3);
+    CHECK(s->shortest <= s->time.longest);
+
+    s = find_query_stats(stats, "select id from soci_test order by id");
+    REQUIRE(s != NULL);
+    CHECK(s->calls == 1);
+    CHECK(s->rows == 3);
+
+    s = find_query_stats(stats, "select id from soci_no_such_table");
+    REQUIRE(s != NULL);
+    CHECK(s->calls == 1);
+    CHECK(s->errors == 1);
+
+    std::ostringstream json;
+    query_statistics::dump_json(json);
+    CHECK(json.str().find(
+        "\"query\":\"select id from soci_test order by id\",\"calls\":1,")
+        != std::string::npos);
+
+    std::ostringstream text;
+    query_statistics::dump_text(text);
+    CHECK(text.str().find("calls=3 errors=0 rows=3 ") != std::string::npos);
+
+    // at most the given number of different queries is tracked
+    query_statistics::reset();
+    CHECK(query_statistics::get().empty());
+    query_statistics::set_max_queries(1);
+    query_statistics::enable(true);
+    sql << "select count(*) from soci_test";
+    sql << "delete from soci_test";
+    query_statistics::enable(false);
+    query_statistics::set_max_queries(1000);
+
+    CHECK(query_statistics::get().size() == 2);
+    CHECK(find_query_stats(query_statistics::get(), "<other>") != NULL);
+    query_statistics::reset();
+}
+
+// collects all the queries logged to it
+class recording_sink : public slow_query_sink
+{
+public:
+    virtual void on_slow_query(session &, slow_query const & q)
+    {
+        queries_.push_back(q);
+    }
+
+    std::vector<slow_query> queries_;
+};
+
+TEST_CASE_METHOD(common_tests, "Slow query log", "[core][slow-query]")
+{
+    session sql(backEndFactory_, connectString_);
+
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+
+    recording_sink sink;
+    CHECK(sql.get_slow_query_sink() == NULL);
+
+    // log all queries, with the values cut after 5 characters or elements
+    sql.set_slow_query_log(&sink, 0, 5);
+    CHECK(sql.get_slow_query_sink() == &sink);
+    CHECK(sql.get_slow_query_threshold() == 0);
+
+    int id = 7;
+    std::string str = "long string";
+    double d = 0;
+    indicator ind = i_null;
+    sql << "insert into soci_test(id, str, d) values(:id, :str, :d)",
+        use(id), use(str), use(d, ind);
+
+    REQUIRE(sink.queries_.size() == 1);
+    slow_query const & q = sink.queries_[0];
+    CHECK(q.query == "insert into soci_test(id, str, d) values(:id, :str, :d)");
+    REQUIRE(q.parameters.size() == 3);
+    CHECK(q.parameters[0] == "7");
+    CHECK(q.parameters[1] == "'long ...'");
+    CHECK(q.parameters[2] == "NULL");
+    CHECK(q.rows == 1);
+    CHECK(q.fetches == 0);
+    CHECK(q.execute_time >= 0);
+    CHECK(!q.failed);
+
+    std::ostringstream os;
+    os << q;
+    CHECK(os.str().find(" parameters=7, 'long ...', NULL") != std::string::npos);
+
+    std::vector<int> ids;
+    for (int i = 10; i != 17; ++i)
+    {
+        ids.push_back(i);
+    }
+    sql << "insert into soci_test(id) values(:id)", use(ids);
+
+    REQUIRE(sink.queries_.size() == 2);
+    REQUIRE(sink.queries_[1].parameters.size() == 1);
+    CHECK(sink.queries_[1].parameters[0] == "[10, 11, 12, 13, 14, ... (7 values)]");
+
+    // fetching the rows is a part of the execution
+    sink.queries_.clear();
+    std::vector<int> out(3);
+    statement st = (sql.prepare <<
+        "select id from soci_test order by id", into(out));
+    st.execute(true);
+    while (st.fetch())
+    {
+    }
+
+    REQUIRE(sink.queries_.size() == 1);
+    CHECK(sink.queries_[0].rows == 8);
+    CHECK(sink.queries_[0].fetches == 2);
+
+    // the values are those used by the execution even if they are changed
+    // before it ends
+    sink.queries_.clear();
+    int val = 0;
+    statement st2 = (sql.prepare <<
+        "select id from soci_test where id = :id", use(id), into(val));
+    id = 10;
+    st2.execute(true);
+    CHECK(val == 10);
+    id = 11;
+    st2.execute(true);
+    CHECK(val == 11);
+    st2.clean_up();
+
+    REQUIRE(sink.queries_.size() == 2);
+    REQUIRE(sink.queries_[0].parameters.size() == 1);
+    CHECK(sink.queries_[0].parameters[0] == "10");
+    REQUIRE(sink.queries_[1].parameters.size() == 1);
+    CHECK(sink.queries_[1].parameters[0] == "11");
+
+    // the queries faster than the threshold are not logged
+    sink.queries_.clear();
+    sql.set_slow_query_log(&sink, 1000 * 1000);
+    sql << "delete from soci_test";
+    CHECK(sink.queries_.empty());
+
+    sql.set_slow_query_log(NULL, 0);
+    CHECK(sql.get_slow_query_sink() == NULL);
+
+    // the settings of the pool are applied to its sessions when leased
+    connection_pool pool(1);
+    pool.at(0).open(backEndFactory_, connectString_);
+    pool.set_slow_query_log(&sink, 0);
+    {
+        session pooled(pool);
+        CHECK(pooled.get_slow_query_sink() == &sink);
+        CHECK(pooled.get_slow_query_threshold() == 0);
+    }
+
+    pool.set_slow_query_log(NULL, 0);
+    {
+        session pooled(pool);
+        CHECK(pooled.get_slow_query_sink() == NULL);
+    }
+}
+
 } // namespace tests
 
 } // namespace soci
@@ -798,6 +798,295 @@ TEST_CASE("MySQL last insert id", "[mysql][last-insert-id]")
     CHECK(id == 42);
 }
 
+struct prepared_statements_table_creator : table_creator_base
+{
+    prepared_statements_table_creator(session & sql)
+        : table_creator_base(sql)
+    {
+        sql << "create table soci_test(id integer, d double, "
+            "str varchar(20), tm datetime, c char(1))";
+    }
+};
+
+TEST_CASE("MySQL server-side prepared statements",
+    "[mysql][prepared-statements]")
+{
+    session sql(backEnd, connectString + " prepared_statements=1");
+    prepared_statements_table_creator tableCreator(sql);
+
+    std::tm t = std::tm();
+    t.tm_year = 116;
+    t.tm_mon = 4;
+    t.tm_mday = 17;
+    t.tm_hour = 12;
+    t.tm_min = 34;
+    t.tm_sec = 56;
+
+    int id = 1;
+    double d = 3.25;
+    std::string str("Ala ma kota");
+    char c = 'x';
+    sql << "insert into soci_test(id, d, str, tm, c) "
+        "values(:id, :d, :str, :tm, :c)",
+        use(id), use(d), use(str), use(t), use(c);
+
+    // bulk insert, including a null value
+    std::vector<int> ids;
+    std::vector<std::string> strs;
+    std::vector<indicator> inds;
+    for (int i = 2; i != 12; ++i)
+    {
+        ids.push_back(i);
+        strs.push_back(i % 2 ? "odd" : "");
+        inds.push_back(i == 5 ? i_null : i_ok);
+    }
+
+    statement st = (sql.prepare <<
+        "insert into soci_test(id, str) values(:id, :str)",
+        use(ids), use(strs, inds));
+    st.execute(true);
+    CHECK(st.get_affected_rows() == 10);
+
+    int id2;
+    double d2;
+    std::string str2;
+    std::tm t2;
+    char c2;
+    sql << "select id, d, str, tm, c from soci_test where id = :id",
+        into(id2), into(d2), into(str2), into(t2), into(c2), use(id);
+    CHECK(id2 == 1);
+    CHECK(d2 == 3.25);
+    CHECK(str2 == "Ala ma kota");
+    CHECK(t2.tm_year == 116);
+    CHECK(t2.tm_mon == 4);
+    CHECK(t2.tm_mday == 17);
+    CHECK(t2.tm_hour == 12);
+    CHECK(t2.tm_min == 34);
+    CHECK(t2.tm_sec == 56);
+    CHECK(c2 == 'x');
+
+    // the same name used for more than one placeholder
+    int count;
+    int const threshold = 6;
+    sql << "select count(*) from soci_test where id >= :n and id + 1 > :n",
+        into(count), use(threshold, "n");
+    CHECK(count == 6);
+
+    // fetch into vectors in several batches
+    std::vector<int> ids2(4);
+    std::vector<std::string> strs2(4);
+    std::vector<indicator> inds2(4);
+    statement st2 = (sql.prepare <<
+        "select id, str from soci_test where id > 1 order by id",
+        into(ids2), into(strs2, inds2));
+    st2.execute();
+
+    int rows = 0;
+    while (st2.fetch())
+    {
+        for (std::size_t i = 0; i != ids2.size(); ++i, ++rows)
+        {
+            CHECK(ids2[i] == rows + 2);
+            if (ids2[i] == 5)
+            {
+                CHECK(inds2[i] == i_null);
+            }
+            else
+            {
+                CHECK(inds2[i] == i_ok);
+                CHECK(strs2[i] == (ids2[i] % 2 ? "odd" : ""));
+            }
+        }
+    }
+    CHECK(rows == 10);
+
+    // dynamic binding uses the statement metadata
+    row r;
+    sql << "select id, d, str from soci_test where id = 1", into(r);
+    REQUIRE(r.size() == 3);
+    CHECK(r.get_properties(1).get_data_type() == dt_double);
+    CHECK(r.get<double>(1) == 3.25);
+    CHECK(r.get<std::string>(2) == "Ala ma kota");
+
+    // the statements which can't be prepared are still executed normally
+    sql << "lock tables soci_test write";
+    sql << "unlock tables";
+
+    sql << "delete from soci_test where id > :id", use(id);
+    sql << "select count(*) from soci_test", into(count);
+    CHECK(count == 1);
+}
+
+struct multi_row_inserts_table_creator : table_creator_base
+{
+    multi_row_inserts_table_creator(session & sql)
+        : table_creator_base(sql)
+    {
+        sql << "create table soci_test(id integer, d double, "
+            "str mediumtext)";
+    }
+};
+
+TEST_CASE("MySQL bulk insert using multi-row inserts",
+    "[mysql][bulk][multi-row]")
+{
+    session sql(backEnd, connectString + " multi_row_inserts=1");
+    multi_row_inserts_table_creator tableCreator(sql);
+
+    // use enough rows to exceed the packet size limit and so check that
+    // several multi-row inserts are used
+    long long maxPacket = 0;
+    sql << "select @@max_allowed_packet", into(maxPacket);
+
+    std::string const str(65536, 'x');
+    std::size_t const count
+        = static_cast<std::size_t>(maxPacket) / str.size() + 10;
+
+    std::vector<int> ids(count);
+    std::vector<std::string> strs(count, str);
+    std::vector<indicator> inds(count, i_ok);
+    for (std::size_t i = 0; i != count; ++i)
+    {
+        ids[i] = static_cast<int>(i);
+    }
+    inds[1] = i_null;
+
+    statement st = (sql.prepare <<
+        "insert into soci_test(id, str) values (:id, concat(:str, '(:-)'));",
+        use(ids), use(strs, inds));
+    st.execute(true);
+    CHECK(st.get_affected_rows() == static_cast<long long>(count));
+
+    int n;
+    sql << "select count(*) from soci_test", into(n);
+    CHECK(n == static_cast<int>(count));
+
+    sql << "select count(*) from soci_test where str is null", into(n);
+    CHECK(n == 1);
+
+    std::string const expected = str + "(:-)";
+    sql << "select count(*) from soci_test where str = :str",
+        into(n), use(expected);
+    CHECK(n == static_cast<int>(count) - 1);
+
+    // statements which can't be rewritten are still executed row by row
+    std::vector<int> ids2(3);
+    ids2[0] = 0;
+    ids2[1] = 1;
+    ids2[2] = -1;
+    statement st2 = (sql.prepare <<
+        "insert into soci_test(id) values (:id) "
+        "on duplicate key update d = 1", use(ids2));
+    st2.execute(true);
+    CHECK(st2.get_affected_rows() == 3);
+
+    sql << "select count(*) from soci_test", into(n);
+    CHECK(n == static_cast<int>(count) + 3);
+}
+
+namespace
+{
+
+void check_streamed_results(std::string const & options)
+{
+    session sql(backEnd, connectString + options);
+    prepared_statements_table_creator tableCreator(sql);
+
+    std::vector<int> ids(100);
+    std::vector<std::string> strs(100);
+    std::vector<indicator> inds(100, i_ok);
+    for (int i = 0; i != 100; ++i)
+    {
+        ids[i] = i;
+        std::ostringstream oss;
+        oss << "str" << i;
+        strs[i] = oss.str();
+    }
+    inds[42] = i_null;
+    sql << "insert into soci_test(id, str) values(:id, :str)",
+        use(ids), use(strs, inds);
+
+    // fetch the rows in batches, only the rows of the current batch are
+    // read from the server
+    std::vector<int> ids2(7);
+    std::vector<std::string> strs2(7);
+    std::vector<indicator> inds2(7);
+    statement st = (sql.prepare <<
+        "select id, str from soci_test order by id",
+        into(ids2), into(strs2, inds2));
+    st.execute();
+
+    int rows = 0;
+    while (st.fetch())
+    {
+        for (std::size_t i = 0; i != ids2.size(); ++i, ++rows)
+        {
+            CHECK(ids2[i] == rows);
+            if (rows == 42)
+            {
+                CHECK(inds2[i] == i_null);
+            }
+            else
+            {
+                CHECK(inds2[i] == i_ok);
+                CHECK(strs2[i] == strs[rows]);
+            }
+        }
+    }
+    CHECK(rows == 100);
+
+    // single row fetches and dynamic binding work as usual
+    int id;
+    statement st2 = (sql.prepare <<
+        "select id from soci_test where id >= 90 order by id", into(id));
+    st2.execute();
+    rows = 0;
+    while (st2.fetch())
+    {
+        CHECK(id == 90 + rows++);
+    }
+    CHECK(rows == 10);
+
+    rowset<row> rs = (sql.prepare <<
+        "select id, str from soci_test where id < 10 order by id");
+    rows = 0;
+    for (rowset<row>::const_iterator it = rs.begin(); it != rs.end(); ++it)
+    {
+        CHECK(it->get<int>(0) == rows);
+        CHECK(it->get<std::string>(1) == strs[rows]);
+        ++rows;
+    }
+    CHECK(rows == 10);
+
+    // the remaining rows are discarded if the statement is executed again
+    // or destroyed before being fully fetched
+    {
+        std::vector<int> ids3(5);
+        statement st3 = (sql.prepare << "select id from soci_test",
+            into(ids3));
+        st3.execute(true);
+        CHECK(ids3.size() == 5);
+        st3.execute(true);
+        CHECK(ids3.size() == 5);
+    }
+
+    sql << "select count(*) from soci_test", into(id);
+    CHECK(id == 100);
+}
+
+} // namespace anonymous
+
+TEST_CASE("MySQL streaming results", "[mysql][streaming]")
+{
+    check_streamed_results(" stream_results=1");
+}
+
+TEST_CASE("MySQL streaming results with prepared statements",
+    "[mysql][streaming][prepared-statements]")
+{
+    check_streamed_results(" stream_results=1 prepared_statements=1");
+}
+
 // DDL Creation objects for common tests
 struct table_creator_one : public table_creator_base
 {
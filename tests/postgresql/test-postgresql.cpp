@@ -662,6 +662,451 @@ TEST_CASE("PostgreSQL ORM cast", "[postgresql][orm]")
     sql << "select :a::int", use(v); // Must not throw an exception!
 }
 
+// test for the results in binary format
+TEST_CASE("PostgreSQL binary results", "[postgresql][binary]")
+{
+    connection_parameters parameters(backEnd, connectString);
+    parameters.set_option(postgresql_option_binary_results, "1");
+
+    session sql(parameters);
+
+    // the one-time queries only use binary format if they're cached
+    sql.set_statement_cache_size(10);
+
+    SECTION("Scalars")
+    {
+        short sh;
+        int i;
+        long long ll;
+        unsigned long long ull;
+        double d1, d2, d3;
+        int b;
+        std::string s;
+        char c;
+
+        sql << "select 123::int2, -123456::int4, 123456789012::int8,"
+               " 1234567890123::int8, 1.5::float4, -2.25::float8,"
+               " 12.375::numeric, true, 'soci'::text, 'x'::char",
+            into(sh), into(i), into(ll), into(ull), into(d1), into(d2),
+            into(d3), into(b), into(s), into(c);
+
+        CHECK(sh == 123);
+        CHECK(i == -123456);
+        CHECK(ll == 123456789012LL);
+        CHECK(ull == 1234567890123ULL);
+        CHECK(d1 == 1.5);
+        CHECK(d2 == -2.25);
+        CHECK(d3 == 12.375);
+        CHECK(b == 1);
+        CHECK(s == "soci");
+        CHECK(c == 'x');
+
+        sql << "select -1234567::numeric", into(i);
+        CHECK(i == -1234567);
+
+        indicator ind;
+        sql << "select null::int4", into(i, ind);
+        CHECK(ind == i_null);
+    }
+
+    SECTION("Date and time")
+    {
+        std::tm t1, t2, t3;
+
+        sql << "select '2009-06-17'::date, '22:51:03.123'::time,"
+               " '1999-12-31 23:59:59.5'::timestamp",
+            into(t1), into(t2), into(t3);
+
+        CHECK(t1.tm_year == 2009 - 1900);
+        CHECK(t1.tm_mon == 6 - 1);
+        CHECK(t1.tm_mday == 17);
+        CHECK(t1.tm_hour == 0);
+
+        CHECK(t2.tm_year == 0);
+        CHECK(t2.tm_mday == 1);
+        CHECK(t2.tm_hour == 22);
+        CHECK(t2.tm_min == 51);
+        CHECK(t2.tm_sec == 3);
+
+        CHECK(t3.tm_year == 1999 - 1900);
+        CHECK(t3.tm_mon == 12 - 1);
+        CHECK(t3.tm_mday == 31);
+        CHECK(t3.tm_hour == 23);
+        CHECK(t3.tm_min == 59);
+        CHECK(t3.tm_sec == 59);
+    }
+
+    SECTION("Vectors")
+    {
+        std::vector<int> ids(10);
+        std::vector<std::string> names(10);
+        std::vector<double> vals(10);
+
+        sql << "select g, 'n' || g, g / 4.0::float8"
+               " from generate_series(1, 10) g order by g",
+            into(ids), into(names), into(vals);
+
+        REQUIRE(ids.size() == 10);
+        CHECK(ids[9] == 10);
+        CHECK(names[9] == "n10");
+        CHECK(vals[1] == 0.5);
+    }
+
+    SECTION("Per statement")
+    {
+        sql.close();
+        sql.open(backEnd, connectString);
+
+        int i = 0;
+        statement st = (sql.prepare << "select 17::int4", into(i));
+
+        postgresql_statement_backend * const stbe
+            = static_cast<postgresql_statement_backend *>(st.get_backend());
+        CHECK(stbe->binaryResults_ == false);
+
+        postgresql_set_binary_results(st, true);
+        st.execute(true);
+        CHECK(i == 17);
+        CHECK(PQfformat(stbe->result_, 0) == 1);
+    }
+
+    SECTION("One-time queries")
+    {
+        // describing them would need an additional round trip
+        int i = 0;
+        statement st(sql);
+        st.exchange(into(i));
+        st.alloc();
+        st.prepare("select 17::int4", details::st_one_time_query);
+        st.define_and_bind();
+        st.execute(true);
+        CHECK(i == 17);
+
+        postgresql_statement_backend * const stbe
+            = static_cast<postgresql_statement_backend *>(st.get_backend());
+        CHECK(PQfformat(stbe->result_, 0) == 0);
+    }
+
+    SECTION("Conversion to string")
+    {
+        std::string i, n, b, d, ts, iv, u, j;
+
+        sql << "select 42::int4, -12.50::numeric, false, '2009-06-17'::date,"
+               " '1999-12-31 23:59:59.5'::timestamp,"
+               " '1 year 2 mons -3 days 04:05:06'::interval,"
+               " 'a0eebc99-9c0b-4ef8-bb6d-6bb9bd380a11'::uuid,"
+               " '{\"a\": [1, 2]}'::jsonb",
+            into(i), into(n), into(b), into(d), into(ts), into(iv), into(u),
+            into(j);
+
+        CHECK(i == "42");
+        CHECK(n == "-12.50");
+        CHECK(b == "f");
+        CHECK(d == "2009-06-17");
+        CHECK(ts == "1999-12-31 23:59:59.5");
+        CHECK(iv == "1 year 2 mons -3 days +04:05:06");
+        CHECK(u == "a0eebc99-9c0b-4ef8-bb6d-6bb9bd380a11");
+        CHECK(j == "{\"a\": [1, 2]}");
+    }
+
+    SECTION("Unsupported types")
+    {
+        // the results are received in text format if any of the columns
+        // can't be decoded from binary one
+        std::string a;
+        int i = 0;
+        sql << "select array[1, 2], 42::int4", into(a), into(i);
+        CHECK(a == "{1,2}");
+        CHECK(i == 42);
+    }
+
+    SECTION("Dynamic rows")
+    {
+        rowset<row> rs = (sql.prepare <<
+            "select 1.5::numeric as n, '{}'::jsonb as j,"
+            " 'a0eebc99-9c0b-4ef8-bb6d-6bb9bd380a11'::uuid as u,"
+            " '1 day'::interval as iv, 'x'::text as s"
+            " from generate_series(1, 2)");
+
+        int count = 0;
+        for (rowset<row>::const_iterator it = rs.begin(); it != rs.end(); ++it)
+        {
+            row const & r = *it;
+            CHECK(r.get<double>("n") == 1.5);
+            CHECK(r.get<std::string>("j") == "{}");
+            CHECK(r.get<std::string>("u")
+                == "a0eebc99-9c0b-4ef8-bb6d-6bb9bd380a11");
+            CHECK(r.get<std::string>("iv") == "1 day");
+            CHECK(r.get<std::string>("s") == "x");
+            ++count;
+        }
+
+        CHECK(count == 2);
+    }
+
+    SECTION("Unsupported conversion")
+    {
+        int i;
+        CHECK_THROWS_AS((sql <<
+            "select 'a0eebc99-9c0b-4ef8-bb6d-6bb9bd380a11'::uuid", into(i)),
+            soci_error);
+    }
+}
+
+// test for the results received in single row mode
+TEST_CASE("PostgreSQL streaming results", "[postgresql][streaming]")
+{
+    connection_parameters parameters(backEnd, connectString);
+    parameters.set_option(postgresql_option_stream_results, "1");
+
+    session sql(parameters);
+
+    SECTION("Vector fetch")
+    {
+        std::vector<int> v(100);
+        statement st = (sql.prepare <<
+            "select g from generate_series(1, 1050) g order by g", into(v));
+        st.execute();
+
+        int count = 0;
+        while (st.fetch())
+        {
+            for (std::size_t i = 0; i != v.size(); ++i)
+            {
+                CHECK(v[i] == ++count);
+            }
+        }
+
+        CHECK(count == 1050);
+    }
+
+    SECTION("Rowset")
+    {
+        int count = 0;
+        rowset<row> rs = (sql.prepare <<
+            "select g, 'n' || g as name from generate_series(1, 10) g");
+        for (rowset<row>::const_iterator it = rs.begin(); it != rs.end(); ++it)
+        {
+            ++count;
+            CHECK(it->get<int>(0) == count);
+        }
+
+        CHECK(count == 10);
+    }
+
+    SECTION("No rows")
+    {
+        int i = 0;
+        sql << "select 1 where false", into(i);
+        CHECK(sql.got_data() == false);
+    }
+
+    SECTION("Abandoned results")
+    {
+        std::vector<int> v(10);
+        {
+            statement st = (sql.prepare <<
+                "select g from generate_series(1, 1000) g", into(v));
+            st.execute(true);
+            CHECK(v.size() == 10);
+        }
+
+        // the connection must be usable again
+        int i = 0;
+        sql << "select 17", into(i);
+        CHECK(i == 17);
+    }
+
+    SECTION("Error while streaming")
+    {
+        std::vector<int> v(10);
+        statement st = (sql.prepare <<
+            "select 1 / (100 - g) from generate_series(1, 1000) g", into(v));
+
+        try
+        {
+            st.execute();
+            while (st.fetch())
+                ;
+
+            FAIL("expected exception not thrown");
+        }
+        catch (soci_error const &)
+        {
+        }
+
+        // the connection must still be usable after the error
+        int i = 0;
+        sql << "select 17", into(i);
+        CHECK(i == 17);
+    }
+}
+
+// test for the bulk inserts using COPY
+struct copy_table_creator : table_creator_base
+{
+    copy_table_creator(session & sql)
+        : table_creator_base(sql)
+    {
+        sql << "create table soci_test(id integer primary key, name text)";
+    }
+};
+
+TEST_CASE("PostgreSQL bulk insert using copy", "[postgresql][bulk][copy]")
+{
+    connection_parameters parameters(backEnd, connectString);
+    parameters.set_option(postgresql_option_copy_bulk_inserts, "1");
+
+    session sql(parameters);
+
+    copy_table_creator tableCreator(sql);
+
+    std::vector<int> ids;
+    std::vector<std::string> names;
+    std::vector<indicator> inds;
+    for (int i = 0; i != 1000; ++i)
+    {
+        ids.push_back(i);
+
+        std::ostringstream ss;
+        ss << "name\t" << i << "\\\n";
+        names.push_back(ss.str());
+        inds.push_back(i % 10 == 0 ? i_null : i_ok);
+    }
+
+    statement st = (sql.prepare <<
+        "insert into soci_test(id, name) values(:id, :name)",
+        use(ids, "id"), use(names, inds, "name"));
+
+    postgresql_statement_backend * const stbe
+        = static_cast<postgresql_statement_backend *>(st.get_backend());
+    CHECK(stbe->copyQuery_ == "COPY soci_test (id, name) FROM STDIN");
+
+    st.execute(true);
+    CHECK(st.get_affected_rows() == 1000);
+
+    int count = 0;
+    sql << "select count(*) from soci_test where name is null", into(count);
+    CHECK(count == 100);
+
+    std::string name;
+    sql << "select name from soci_test where id = 17", into(name);
+    CHECK(name == names[17]);
+
+    // COPY is atomic, so nothing must be inserted if any row fails
+    std::vector<int> ids2;
+    ids2.push_back(1000);
+    ids2.push_back(1001);
+    ids2.push_back(0);
+    CHECK_THROWS_AS((sql << "insert into soci_test(id) values(:id)",
+        use(ids2)), soci_error);
+
+    sql << "select count(*) from soci_test", into(count);
+    CHECK(count == 1000);
+}
+
+// test for the bulk operations in pipeline mode
+TEST_CASE("PostgreSQL bulk operations in pipeline mode", "[postgresql][bulk][pipeline]")
+{
+    connection_parameters parameters(backEnd, connectString);
+    parameters.set_option(postgresql_option_pipeline_bulk_operations, "1");
+
+    session sql(parameters);
+
+    copy_table_creator tableCreator(sql);
+
+    std::vector<int> ids;
+    for (int i = 0; i != 1000; ++i)
+    {
+        ids.push_back(i);
+    }
+
+    statement st1 = (sql.prepare <<
+        "insert into soci_test(id) values(:id)", use(ids));
+    st1.execute(true);
+    CHECK(st1.get_affected_rows() == 1000);
+
+    std::vector<std::string> names(ids.size(), "soci");
+    statement st2 = (sql.prepare <<
+        "update soci_test set name = :name where id = :id or id = :id + 500",
+        use(names, "name"), use(ids, "id"));
+    st2.execute(true);
+    CHECK(st2.get_affected_rows() == 1500);
+
+    int count = 0;
+    sql << "select count(*) from soci_test where name = 'soci'", into(count);
+    CHECK(count == 1000);
+
+    // the error is reported and the number of rows affected before it kept
+    std::vector<int> ids2;
+    ids2.push_back(1000);
+    ids2.push_back(1001);
+    ids2.push_back(0);
+    ids2.push_back(1002);
+    statement st3 = (sql.prepare <<
+        "insert into soci_test(id) values(:id)", use(ids2));
+    try
+    {
+        st3.execute(true);
+        FAIL("expected exception not thrown");
+    }
+    catch (postgresql_soci_error const & e)
+    {
+        CHECK(e.sqlstate() == "23505");
+    }
+
+    CHECK(st3.get_affected_rows() == 2);
+
+    // the connection must be usable after the error
+    sql << "select count(*) from soci_test", into(count);
+    CHECK(count >= 1000);
+}
+
+// test that the asynchronous operations are executed without blocking
+TEST_CASE("PostgreSQL asynchronous execution", "[postgresql][async]")
+{
+    session sql(backEnd, connectString);
+
+    // the timeout is respected while the query is executed
+    async_result res = sql.once_async("select pg_sleep(0.5)");
+    CHECK(!res.is_ready());
+    CHECK(!res.wait(50));
+    CHECK(res.wait());
+    res.get();
+
+    int n = 0;
+    statement st = (sql.prepare << "select 17", into(n));
+    CHECK(st.can_start_execute());
+    CHECK(st.execute_async(true).get());
+    CHECK(n == 17);
+
+    // the errors keep their type and SQL state
+    res = sql.once_async("select * from soci_test_nosuchtable");
+    try
+    {
+        res.get();
+        FAIL("expected exception not thrown");
+    }
+    catch (postgresql_soci_error const & e)
+    {
+        CHECK(e.sqlstate() == "42P01");
+    }
+
+    // streamed results are fetched by the background thread
+    connection_parameters parameters(backEnd, connectString);
+    parameters.set_option(postgresql_option_stream_results, "1");
+
+    session sql2(parameters);
+
+    statement st2 = (sql2.prepare <<
+        "select generate_series(1, 3)", into(n));
+    CHECK(!st2.can_start_execute());
+    CHECK(st2.execute_async(true).get());
+    CHECK(n == 1);
+    CHECK(st2.fetch_async().get());
+    CHECK(n == 2);
+}
+
 //
 // Support for soci Common Tests
 //
@@ -237,6 +237,134 @@ TEST_CASE("SQLite vector long long", "[sqlite][vector][longlong]")
     CHECK(v2[4] == 1000000000000LL);
 }
 
+struct typed_columns_table_creator : table_creator_base
+{
+    typed_columns_table_creator(session & sql)
+        : table_creator_base(sql)
+    {
+        sql << "create table soci_test(i integer, d double, s text)";
+    }
+};
+
+TEST_CASE("SQLite vector into typed columns", "[sqlite][vector][into]")
+{
+    session sql(backEnd, connectString);
+
+    typed_columns_table_creator tableCreator(sql);
+
+    // use literals to store the values with their native types
+    sql << "insert into soci_test(i, d, s) values(1, 0.1, 'one')";
+    sql << "insert into soci_test(i, d, s) values(2, 1e-300, null)";
+    sql << "insert into soci_test(i, d, s) values(3, 2, 'th' || x'00' || 'ree')";
+    sql << "insert into soci_test(i, d, s) values(4, 4.5, '4')";
+
+    std::vector<int> vi(3);
+    std::vector<double> vd(3);
+    std::vector<std::string> vs(3);
+    std::vector<indicator> inds(3);
+
+    statement st = (sql.prepare <<
+        "select i, d, s from soci_test order by i",
+        into(vi), into(vd), into(vs, inds));
+    st.execute();
+
+    REQUIRE(st.fetch());
+    REQUIRE(vi.size() == 3);
+    CHECK(vi[0] == 1);
+    CHECK(vi[2] == 3);
+
+    // floating point values are not rounded by a text conversion
+    CHECK(vd[0] == 0.1);
+    CHECK(vd[1] == 1e-300);
+    CHECK(vd[2] == 2.0);
+
+    CHECK(inds[0] == i_ok);
+    CHECK(vs[0] == "one");
+    CHECK(inds[1] == i_null);
+    CHECK(inds[2] == i_ok);
+    CHECK(vs[2] == std::string("th\0ree", 6));
+
+    REQUIRE(st.fetch());
+    REQUIRE(vi.size() == 1);
+    CHECK(vi[0] == 4);
+    CHECK(vd[0] == 4.5);
+    CHECK(vs[0] == "4");
+
+    CHECK(!st.fetch());
+
+    // text values are still converted to numbers if possible
+    std::vector<long long> vll(4);
+    sql << "select s from soci_test where i = 4",
+        into(vll, inds);
+    REQUIRE(vll.size() == 1);
+    CHECK(vll[0] == 4);
+
+    // values not fitting into the target type result in an error
+    sql << "update soci_test set i = 100000 where i = 1";
+    std::vector<short> vsh(4);
+    CHECK_THROWS_AS((sql << "select i from soci_test", into(vsh)),
+                    soci_error);
+
+    // and so do nulls without an indicator
+    CHECK_THROWS_AS((sql << "select s from soci_test", into(vs)),
+                    soci_error);
+}
+
+struct typeless_table_creator : table_creator_base
+{
+    typeless_table_creator(session & sql)
+        : table_creator_base(sql)
+    {
+        sql << "create table soci_test(id integer, v)";
+    }
+};
+
+TEST_CASE("SQLite use typed binding", "[sqlite][use][vector]")
+{
+    session sql(backEnd, connectString);
+
+    // a column without any type doesn't convert the values, so the type of
+    // the stored value is the type used for binding it
+    typeless_table_creator tableCreator(sql);
+
+    int i = 17;
+    double d = 0.1;
+    std::string s("a\0b", 3);
+    sql << "insert into soci_test(id, v) values(1, :v)", use(i);
+    sql << "insert into soci_test(id, v) values(2, :v)", use(d);
+    sql << "insert into soci_test(id, v) values(3, :v)", use(s);
+
+    std::vector<int> ids;
+    std::vector<long long> vll;
+    for (int n = 0; n != 3; ++n)
+    {
+        ids.push_back(4 + n);
+        vll.push_back(10000000000LL + n);
+    }
+    sql << "insert into soci_test(id, v) values(:id, :v)", use(ids), use(vll);
+
+    std::vector<std::string> types(10);
+    sql << "select typeof(v) from soci_test order by id", into(types);
+    REQUIRE(types.size() == 6);
+    CHECK(types[0] == "integer");
+    CHECK(types[1] == "real");
+    CHECK(types[2] == "text");
+    CHECK(types[3] == "integer");
+    CHECK(types[5] == "integer");
+
+    double d2 = 0;
+    sql << "select v from soci_test where id = 2", into(d2);
+    CHECK(d2 == d);
+
+    std::string s2;
+    sql << "select v from soci_test where id = 3", into(s2);
+    CHECK(s2 == s);
+
+    long long ll = 0;
+    sql << "select v from soci_test where id = 6", into(ll);
+    CHECK(ll == 10000000002LL);
+}
+
 struct table_creator_for_get_last_insert_id : table_creator_base
 {
     table_creator_for_get_last_insert_id(session & sql)